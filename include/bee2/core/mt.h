@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.10.10
-\version 2017.01.11
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -125,9 +125,62 @@ void mtMtxClose(
 
 Управление потоками реализуется по схемам, заданным в новом стандарте
 языка Си ISO/IEC 9899:2011 (см. заголовочный файл threads.h).
+
+Поток запускается функцией mtThrdCreate() и ожидается функцией mtThrdJoin().
+Описатель потока mt_thrd_t хранит не только системный дескриптор, но и 
+функцию потока вместе с ее аргументом и кодом возврата. Поэтому описатель
+должен оставаться в памяти до завершения mtThrdJoin().
+
+Если операционная система не распознана, то потоки не создаются:
+mtThrdCreate() всегда возвращает FALSE. Вызывающая программа должна
+быть готова к этому и выполнить функцию потока самостоятельно.
+
+\typedef mt_thrd_i
+\brief Функция потока
+
+\typedef mt_thrd_t
+\brief Описатель потока
 *******************************************************************************
 */
 
+typedef int (*mt_thrd_i)(void* arg);
+
+typedef struct
+{
+#ifdef OS_WIN
+	HANDLE hdl;			/*!< дескриптор */
+#elif defined(OS_UNIX) || defined(__APPLE__)
+	pthread_t hdl;		/*!< дескриптор */
+#endif
+	mt_thrd_i func;		/*!< функция потока */
+	void* arg;			/*!< аргумент функции */
+	int ret;			/*!< код возврата */
+} mt_thrd_t;
+
+/*!	\brief Создание потока
+
+	Создается поток thrd, в котором выполняется функция func с 
+	аргументом arg.
+	\return Признак успеха.
+	\remark Если операционная система не распознана, то поток не создается
+	и возвращается FALSE.
+*/
+bool_t mtThrdCreate(
+	mt_thrd_t* thrd,	/*!< [out] описатель потока */
+	mt_thrd_i func,		/*!< [in] функция потока */
+	void* arg			/*!< [in] аргумент функции */
+);
+
+/*!	\brief Ожидание завершения потока
+
+	Ожидается завершение потока thrd, ресурсы потока освобождаются.
+	\pre Поток thrd успешно создан функцией mtThrdCreate() и еще не ожидался.
+	\return Код возврата функции потока.
+*/
+int mtThrdJoin(
+	mt_thrd_t* thrd		/*!< [in] описатель потока */
+);
+
 /*!	\brief Приостановка потока
 
 	Текущий поток приостанавливается на ms миллисекунд.
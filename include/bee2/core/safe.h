@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2013.10.07
-\version 2019.06.13
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -62,6 +62,13 @@ extern "C" {
 	SAFE(f) == f_safe && FAST(f) == f.
 Базовое имя f всегда поддержано и является именем по умолчанию.
 
+Обе редакции компилируются всегда. Поэтому в одной программе можно 
+использовать регулярные вычисления с секретными данными и ускоренные -- 
+с открытыми данными. Для этого редакции выбираются явно, через макросы SAFE 
+и FAST, или переключаются в описаниях объектов (например, колец вычетов, 
+см. zmSetSafe()). Макрос SAFE_DEFAULT принимает значение TRUE, если по 
+умолчанию используются регулярные редакции, и FALSE в противном случае.
+
 Директива SAFE_FAST дополнительно используется для нерегулярного ускорения обычных
 (одноредакционных) функций. Основное назначение директивы -- анализ падения 
 производительности при регуляризации. Директиву следует включать только тогда, 
@@ -81,9 +88,11 @@ extern "C" {
 #ifdef SAFE_FAST
 	#define SAFE(tag) tag##_safe
 	#define FAST(tag) tag
+	#define SAFE_DEFAULT FALSE
 #else
 	#define SAFE(tag) tag
 	#define FAST(tag) tag##_fast
+	#define SAFE_DEFAULT TRUE
 #endif
 
 #ifdef __cplusplus
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2013.05.14
-\version 2018.11.30
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -203,6 +203,8 @@ err_t belsGenMid(
 	\return ERR_OK, если секрет успешно разделен, и код ошибки
 	в противном случае.
 	\remark Реализован алгоритм 7.3.
+	\remark Вызов эквивалентен belsBatchShare(si, 1, count, threshold, len,
+	s, m0, mi, rng, rng_state).
 */
 err_t belsShare(
 	octet si[],				/*!< [out] частичные секреты */
@@ -268,6 +270,122 @@ err_t belsRecover(
 	const octet mi[]		/*!< [in] открытые ключи пользователей */
 );
 
+/*
+*******************************************************************************
+Подготовленное восстановление
+
+Если одна и та же группа из count пользователей восстанавливает много 
+секретов, то объект восстановления строится по открытым ключам группы 
+один раз функцией belsRecStart(). Затем каждый секрет восстанавливается 
+функцией belsRecStep() только с помощью сложений: секрет линейно зависит 
+от битов частичных секретов, и коэффициенты этой зависимости хранятся 
+в объекте.
+
+Объект содержит только данные, построенные по открытым ключам. Функция 
+belsRecStep() не изменяет объект, поэтому один объект можно одновременно 
+использовать в нескольких потоках.
+
+Последовательность вызовов: belsRec_keep() < belsRecStart() < 
+belsRecStep()*.
+*******************************************************************************
+*/
+
+/*!	\brief Длина объекта восстановления
+
+	Возвращается длина (в октетах) объекта восстановления для группы 
+	из count пользователей и секретов из len октетов.
+	\return Длина объекта.
+	\remark Длина объекта растет как count * len^2: например, 
+	для count == 16 и len == 32 требуется 128 Кбайт.
+*/
+size_t belsRec_keep(
+	size_t count,			/*!< [in] число пользователей */
+	size_t len				/*!< [in] длина секретов в октетах */
+);
+
+/*!	\brief Построение объекта восстановления
+
+	По общему открытому ключу [len]m0 и открытым ключам [count * len]mi 
+	группы пользователей строится объект восстановления rec.
+	\expect{ERR_BAD_INPUT}
+	-	len == 16 || len == 24 || len == 32;
+	-	count > 0;
+	-	по адресу rec зарезервировано belsRec_keep(count, len) октетов.
+	.
+	\expect{ERR_BAD_PUBKEY} Открытые ключи m0, mi корректны и отличаются 
+	друг от друга.
+	\return ERR_OK, если объект успешно построен, и код ошибки в противном 
+	случае.
+*/
+err_t belsRecStart(
+	void* rec,				/*!< [out] объект восстановления */
+	size_t count,			/*!< [in] число пользователей */
+	size_t len,				/*!< [in] длина секретов в октетах */
+	const octet m0[],		/*!< [in] общий открытый ключ */
+	const octet mi[]		/*!< [in] открытые ключи пользователей */
+);
+
+/*!	\brief Восстановление секрета с помощью объекта
+
+	Секрет [len]s восстанавливается по частичным секретам [count * len]si 
+	группы пользователей, для которой построен объект rec.
+	\pre Объект rec построен функцией belsRecStart() и не изменялся.
+	\return ERR_OK, если секрет успешно восстановлен, и код ошибки 
+	в противном случае.
+	\remark Результат совпадает с результатом belsRecover(s, count, len, si, 
+	m0, mi), где m0, mi -- ключи, использованные при построении rec.
+	\remark Частичные секреты обрабатываются без ветвлений, зависящих 
+	от их значений.
+*/
+err_t belsRecStep(
+	octet s[],				/*!< [out] восстановленный секрет */
+	const octet si[],		/*!< [in] частичные секреты */
+	const void* rec			/*!< [in] объект восстановления */
+);
+
+/*
+*******************************************************************************
+Пакетная обработка
+*******************************************************************************
+*/
+
+/*!	\brief Пакетное разделение секретов
+
+	Каждый из batch секретов [batch * len]s разделяется с порогом threshold 
+	на count частичных секретов. j-й секрет [len](s + j * len), 
+	j = 0, 1,..., batch - 1, разделяется на частичные секреты 
+	[count * len](si + j * count * len). При разделении используется 
+	общий открытый ключ [len]m0 и открытые ключи пользователей из массива 
+	[count * len]mi, а также генератор rng и его состояние rng_state. 
+	\expect{ERR_BAD_INPUT}
+	-	len == 16 || len == 24 || len == 32;
+	-	0 < threshold <= count;
+	-	batch > 0;
+	-	длины len * count * batch и 8 * len * count не превосходят SIZE_MAX.
+	.
+	\expect{ERR_BAD_PUBKEY} Открытые ключи m0, mi корректны и отличаются 
+	друг от друга.
+	\expect{ERR_BAD_RNG} Генератор rng (с состоянием rng_state) корректен.
+	\expect Генератор rng является криптографически стойким.
+	\return ERR_OK, если секреты успешно разделены, и код ошибки
+	в противном случае.
+	\remark Результат совпадает с результатом batch последовательных вызовов 
+	belsShare() с тем же генератором. Открытые ключи загружаются и 
+	подготавливаются к редукции один раз.
+*/
+err_t belsBatchShare(
+	octet si[],				/*!< [out] частичные секреты */
+	size_t batch,			/*!< [in] число секретов */
+	size_t count,			/*!< [in] число пользователей */
+	size_t threshold,		/*!< [in] пороговое число */
+	size_t len,				/*!< [in] длина секретов в октетах */
+	const octet s[],		/*!< [in] секреты */
+	const octet m0[],		/*!< [in] общий открытый ключ */
+	const octet mi[],		/*!< [in] открытые ключи пользователей */
+	gen_i rng,				/*!< [in] генератор случайных чисел */
+	void* rng_state			/*!< [in/out] состояние генератора */
+);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.27
-\version 2021.01.19
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -227,6 +227,70 @@ err_t bignDH(
 	size_t key_len				/*!< [in] длина key в октетах */
 );
 
+/*
+*******************************************************************************
+Пакетная обработка
+*******************************************************************************
+*/
+
+/*!	\brief Пакетная генерация пар ключей
+
+	При долговременных параметрах params генерируются count пар ключей:
+	личные [count * l / 4]privkeys и открытые [count * l / 2]pubkeys.
+	i-я пара ключей, i = 0, 1,..., count - 1, -- это личный ключ 
+	[l / 4](privkeys + i * l / 4) и открытый ключ 
+	[l / 2](pubkeys + i * l / 2). При генерации используется генератор 
+	rng и его состояние rng_state.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\expect{ERR_BAD_RNG} Генератор rng (с состоянием rng_state) корректен.
+	\expect Используется криптографически стойкий генератор rng.
+	\return ERR_OK, если ключи успешно сгенерированы, и код ошибки
+	в противном случае.
+	\remark Реализован алгоритм 6.2.2.
+	\remark Открытые ключи сначала рассчитываются в проективных координатах,
+	а затем одновременно переводятся в аффинные координаты. При переводе
+	выполняется одно обращение в базовом поле на блок из 256 ключей.
+	\remark В случае ошибки выходные буферы очищаются.
+*/
+err_t bignBatchGenKeypair(
+	octet privkeys[],			/*!< [out] личные ключи */
+	octet pubkeys[],			/*!< [out] открытые ключи */
+	size_t count,				/*!< [in] число пар ключей */
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	gen_i rng,					/*!< [in] генератор случайных чисел */
+	void* rng_state				/*!< [in/out] состояние генератора */
+);
+
+/*!	\brief Пакетное построение общих ключей протокола Диффи -- Хеллмана
+
+	При долговременных параметрах params по личному ключу [l / 4]privkey 
+	и открытым ключам [count * l / 2]pubkeys противоположных сторон 
+	строятся общие ключи [count * key_len]keys. i-й общий ключ 
+	[key_len](keys + i * key_len), i = 0, 1,..., count - 1, совпадает 
+	с ключом, который строит функция bignDH() по открытому ключу
+	[l / 2](pubkeys + i * l / 2).
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\expect{ERR_BAD_PRIVKEY} Личный ключ privkey корректен.
+	\expect{ERR_BAD_PUBKEY} Все открытые ключи pubkeys корректны.
+	\expect{ERR_BAD_SHAREKEY} key_len <= l / 2.
+	\return ERR_OK, если общие ключи успешно построены, и код ошибки
+	в противном случае.
+	\remark Представление privkey, которое используется при вычислении 
+	кратных точек, рассчитывается один раз. Кратные точки переводятся 
+	в аффинные координаты одновременно, с одним обращением в базовом поле 
+	на блок из 256 ключей.
+	\remark В случае ошибки (в том числе при некорректности хотя бы одного 
+	из открытых ключей) выходной буфер очищается.
+*/
+err_t bignBatchDH(
+	octet keys[],				/*!< [out] общие ключи */
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	const octet privkey[],		/*!< [in] личный ключ */
+	const octet pubkeys[],		/*!< [in] открытые ключи (других сторон) */
+	size_t count,				/*!< [in] число открытых ключей */
+	size_t key_len				/*!< [in] длина общего ключа в октетах */
+);
+
 /*
 *******************************************************************************
 Электронная цифровая подпись (ЭЦП)
@@ -312,6 +376,297 @@ err_t bignVerify(
 	const octet pubkey[]		/*!< [in] открытый ключ */
 );
 
+/*!
+*******************************************************************************
+\file bign.h
+
+\section bign-ctx Работа с контекстом
+
+Каждая из функций bignGenKeypair(), bignCalcPubkey(), bignDH(), bignSign(),
+bignSign2(), bignVerify() выделяет память, строит по долговременным 
+параметрам описание эллиптической кривой, выполняет основные действия, 
+а затем очищает и освобождает память.
+
+Контекст -- это описание эллиптической кривой, которое строится по 
+долговременным параметрам один раз функцией bignCtxStart(). Контекстные 
+функции bignCtxGenKeypair(), bignCtxCalcPubkey(), bignCtxDH(), bignCtxSign(), 
+bignCtxSign2(), bignCtxVerify() получают контекст и стек вызывающей 
+стороны. Они не выделяют память и не строят описание кривой повторно. 
+В остальном контекстные функции повторяют функции без контекста.
+
+Контекстные функции не изменяют контекст. Поэтому один контекст можно 
+одновременно использовать в нескольких потоках, если каждый из потоков 
+передает собственный стек.
+
+Размер стека определяется функцией bignCtx_deep(). В стеке размещаются 
+в том числе секретные данные (личные ключи). Вызывающая сторона должна 
+очищать стек после использования (например, с помощью функции memWipe()).
+
+\pre Контекст ctx построен функцией bignCtxStart() и не изменялся.
+\pre По адресу stack зарезервировано bignCtx_deep(l) октетов, где l -- 
+уровень стойкости контекста.
+\pre Стек не пересекается с контекстом и входными / выходными буферами.
+*******************************************************************************
+*/
+
+/*!	\brief Длина контекста
+
+	Возвращается длина (в октетах) контекста для уровня стойкости l.
+	\pre l == 128 || l == 192 || l == 256.
+	\return Длина контекста.
+*/
+size_t bignCtx_keep(
+	size_t l					/*!< [in] уровень стойкости */
+);
+
+/*!	\brief Глубина стека контекстных функций
+
+	Возвращается глубина стека (в октетах) контекстных функций, которые
+	используют контекст уровня стойкости l.
+	\pre l == 128 || l == 192 || l == 256.
+	\return Глубина стека.
+*/
+size_t bignCtx_deep(
+	size_t l					/*!< [in] уровень стойкости */
+);
+
+/*!	\brief Построение контекста
+
+	По долговременным параметрам params по адресу ctx строится контекст.
+	\pre По адресу ctx зарезервировано bignCtx_keep(params->l) октетов.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\return ERR_OK, если контекст успешно построен, и код ошибки в 
+	противном случае.
+	\remark Как и в функциях без контекста, проводится только минимальная
+	проверка параметров. Полная проверка выполняется функцией bignValParams().
+*/
+err_t bignCtxStart(
+	void* ctx,					/*!< [out] контекст */
+	const bign_params* params	/*!< [in] долговременные параметры */
+);
+
+/*!	\brief Выбор редакций вычислений в контексте
+
+	Вычисления в базовом поле контекста ctx переключаются на регулярные 
+	(safe == TRUE) или ускоренные нерегулярные (safe == FALSE) редакции 
+	функций (см. zmSetSafe()).
+	\return ERR_OK, если редакции выбраны, и код ошибки в противном случае.
+	\remark При построении контекста устанавливаются редакции по умолчанию 
+	(см. safe.h). Функции без контекста выбирают редакции самостоятельно:
+	регулярные -- при работе с личными и одноразовыми ключами, ускоренные -- 
+	в функциях проверки bignValParams(), bignValPubkey(), bignVerify(), 
+	bignIdVerify().
+	\remark Чтобы совместить регулярную выработку ЭЦП и ускоренную проверку, 
+	можно построить два контекста и выбрать в них разные редакции.
+	\warning Функция изменяет контекст. Ее нельзя вызывать одновременно 
+	с другими функциями, использующими ctx.
+*/
+err_t bignCtxSetSafe(
+	void* ctx,					/*!< [in/out] контекст */
+	bool_t safe					/*!< [in] признак регулярных редакций */
+);
+
+/*!	\brief Генерация пары ключей с использованием контекста
+
+	Повторяется функция bignGenKeypair() с заменой params на контекст ctx.
+*/
+err_t bignCtxGenKeypair(
+	octet privkey[],			/*!< [out] личный ключ */
+	octet pubkey[],				/*!< [out] открытый ключ */
+	const void* ctx,			/*!< [in] контекст */
+	gen_i rng,					/*!< [in] генератор случайных чисел */
+	void* rng_state,			/*!< [in/out] состояние генератора */
+	void* stack					/*!< [in] вспомогательная память */
+);
+
+/*!	\brief Построение открытого ключа с использованием контекста
+
+	Повторяется функция bignCalcPubkey() с заменой params на контекст ctx.
+*/
+err_t bignCtxCalcPubkey(
+	octet pubkey[],				/*!< [out] открытый ключ */
+	const void* ctx,			/*!< [in] контекст */
+	const octet privkey[],		/*!< [in] личный ключ */
+	void* stack					/*!< [in] вспомогательная память */
+);
+
+/*!	\brief Построение общего ключа с использованием контекста
+
+	Повторяется функция bignDH() с заменой params на контекст ctx.
+*/
+err_t bignCtxDH(
+	octet key[],				/*!< [out] общий ключ */
+	const void* ctx,			/*!< [in] контекст */
+	const octet privkey[],		/*!< [in] личный ключ */
+	const octet pubkey[],		/*!< [in] открытый ключ (другой стороны) */
+	size_t key_len,				/*!< [in] длина key в октетах */
+	void* stack					/*!< [in] вспомогательная память */
+);
+
+/*!	\brief Выработка ЭЦП с использованием контекста
+
+	Повторяется функция bignSign() с заменой params на контекст ctx.
+*/
+err_t bignCtxSign(
+	octet sig[],				/*!< [out] подпись */
+	const void* ctx,			/*!< [in] контекст */
+	const octet oid_der[],		/*!< [in] идентификатор хэш-алгоритма */
+	size_t oid_len,				/*!< [in] длина oid_der в октетах */
+	const octet hash[],			/*!< [in] хэш-значение */
+	const octet privkey[],		/*!< [in] личный ключ */
+	gen_i rng,					/*!< [in] генератор случайных чисел */
+	void* rng_state,			/*!< [in/out] состояние генератора */
+	void* stack					/*!< [in] вспомогательная память */
+);
+
+/*!	\brief Детерминированная выработка ЭЦП с использованием контекста
+
+	Повторяется функция bignSign2() с заменой params на контекст ctx.
+*/
+err_t bignCtxSign2(
+	octet sig[],				/*!< [out] подпись */
+	const void* ctx,			/*!< [in] контекст */
+	const octet oid_der[],		/*!< [in] идентификатор хэш-алгоритма */
+	size_t oid_len,				/*!< [in] длина oid_der в октетах */
+	const octet hash[],			/*!< [in] хэш-значение */
+	const octet privkey[],		/*!< [in] личный ключ */
+	const void* t,				/*!< [in] дополнительные данные */
+	size_t t_len,				/*!< [in] размер дополнительных данных */
+	void* stack					/*!< [in] вспомогательная память */
+);
+
+/*!	\brief Проверка ЭЦП с использованием контекста
+
+	Повторяется функция bignVerify() с заменой params на контекст ctx.
+*/
+err_t bignCtxVerify(
+	const void* ctx,			/*!< [in] контекст */
+	const octet oid_der[],		/*!< [in] идентификатор хэш-алгоритма */
+	size_t oid_len,				/*!< [in] длина oid_der в октетах */
+	const octet hash[],			/*!< [in] хэш-значение */
+	const octet sig[],			/*!< [in] подпись */
+	const octet pubkey[],		/*!< [in] открытый ключ */
+	void* stack					/*!< [in] вспомогательная память */
+);
+
+/*!
+*******************************************************************************
+\file bign.h
+
+\section bign-pool Выработка ЭЦП с предвычислениями
+
+Основное время выработки ЭЦП тратится на вычисление точки R = k G, где
+k -- одноразовый личный ключ. Пара (k, <R>) не зависит от подписываемого
+сообщения и может быть вычислена заранее (offline). Пары накапливаются
+в пуле ограниченного размера и расходуются при выработке ЭЦП (online).
+На этапе online выполняются только хэширование и модулярная арифметика.
+
+Пул включает контекст (см. bign-ctx), который строится один раз при
+создании пула.
+
+Пул поддерживает одновременный доступ из нескольких потоков: один или
+несколько потоков могут пополнять пул функцией bignPoolFill(), пока другие
+потоки вырабатывают подписи функцией bignPoolSign(). Израсходованные пары
+очищаются. Каждая пара используется не более одного раза.
+
+Последовательность вызовов: bignPool_keep() < bignPoolStart() <
+[bignPoolFill(), bignPoolSize(), bignPoolSign()]* < bignPoolClose().
+*******************************************************************************
+*/
+
+/*!	\brief Длина пула
+
+	Возвращается длина (в октетах) пула, который рассчитан на уровень
+	стойкости l и хранит не более count пар.
+	\pre l == 128 || l == 192 || l == 256.
+	\return Длина пула.
+*/
+size_t bignPool_keep(
+	size_t l,					/*!< [in] уровень стойкости */
+	size_t count				/*!< [in] вместимость пула */
+);
+
+/*!	\brief Инициализация пула
+
+	По долговременным параметрам params по адресу pool создается пустой пул,
+	который хранит не более count пар.
+	\pre По адресу pool зарезервировано bignPool_keep(params->l, count)
+	октетов.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\expect{ERR_BAD_INPUT} count > 0.
+	\return ERR_OK, если пул успешно создан, и код ошибки в противном
+	случае.
+	\remark После успешного создания пул должен быть закрыт с помощью
+	функции bignPoolClose().
+*/
+err_t bignPoolStart(
+	void* pool,					/*!< [out] пул */
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	size_t count				/*!< [in] вместимость пула */
+);
+
+/*!	\brief Пополнение пула
+
+	В пул pool добавляется не более count пар (k, <R>). Пополнение
+	прекращается, если пул заполнен. При генерации одноразовых личных ключей
+	используется генератор rng с состоянием rng_state.
+	\expect{ERR_BAD_RNG} Генератор rng (с состоянием rng_state) корректен.
+	\expect Генератор rng является криптографически стойким.
+	\expect Если функция вызывается одновременно из нескольких потоков,
+	то каждый поток использует собственное состояние rng_state.
+	\return ERR_OK, если пул пополнен, и код ошибки в противном случае.
+	\remark Пары вычисляются без блокировки пула. Блокировка выполняется
+	только при помещении готовой пары в пул.
+*/
+err_t bignPoolFill(
+	void* pool,					/*!< [in/out] пул */
+	size_t count,				/*!< [in] число добавляемых пар */
+	gen_i rng,					/*!< [in] генератор случайных чисел */
+	void* rng_state				/*!< [in/out] состояние генератора */
+);
+
+/*!	\brief Число готовых пар
+
+	Определяется число пар, накопленных в пуле pool.
+	\return Число пар.
+*/
+size_t bignPoolSize(
+	void* pool					/*!< [in] пул */
+);
+
+/*!	\brief Выработка ЭЦП с использованием пула
+
+	Вырабатывается подпись [3 * l / 8]sig сообщения с хэш-значением
+	[l / 4]hash, полученном с помощью алгоритма с идентификатором
+	[oid_len]oid_der, заданным DER-кодом. Подпись вырабатывается на личном
+	ключе [l / 4]privkey. Одноразовый личный ключ и соответствующая ему точка
+	извлекаются из пула pool. Извлеченная пара удаляется из пула.
+	\expect{ERR_BAD_OID} Идентификатор oid_der корректен.
+	\expect{ERR_BAD_INPUT} Буферы sig и hash не пересекаются.
+	\expect{ERR_BAD_PRIVKEY} Личный ключ privkey корректен.
+	\expect{ERR_NOT_READY} Пул не пуст.
+	\return ERR_OK, если подпись выработана, и код ошибки в противном
+	случае.
+	\remark Реализован алгоритм 7.1.3. Шаги алгоритма, связанные с выработкой
+	k и вычислением R, выполнены заранее функцией bignPoolFill().
+*/
+err_t bignPoolSign(
+	octet sig[],				/*!< [out] подпись */
+	void* pool,					/*!< [in/out] пул */
+	const octet oid_der[],		/*!< [in] идентификатор хэш-алгоритма */
+	size_t oid_len,				/*!< [in] длина oid_der в октетах */
+	const octet hash[],			/*!< [in] хэш-значение */
+	const octet privkey[]		/*!< [in] личный ключ */
+);
+
+/*!	\brief Закрытие пула
+
+	Пул pool закрывается. Накопленные пары очищаются.
+*/
+void bignPoolClose(
+	void* pool					/*!< [in/out] пул */
+);
+
 /*
 *******************************************************************************
 Транспорт ключа
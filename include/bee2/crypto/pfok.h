@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.06.30
-\version 2017.10.10
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -170,6 +170,23 @@ err_t pfokGenParams(
 	pfok_on_q_i on_q		/*!< [in] обработчик */
 );
 
+/*!	\brief Генерация долговременных параметров в нескольких потоках
+
+	По затравочным данным seed генерируются долговременные параметры params
+	так же, как в функции pfokGenParams(). При построении простых кандидаты 
+	проверяются одновременно в threads потоках (см. priExtendPrimeMT()).
+	\return ERR_OK, если параметры успешно сгенерированы, и код ошибки
+	в противном случае.
+	\remark Результат не зависит от threads. Обработчик on_q вызывается 
+	из вызывающего потока.
+*/
+err_t pfokGenParamsMT(
+	pfok_params* params,	/*!< [out] долговременные параметры */
+	const pfok_seed* seed,	/*!< [in] затравочные данные */
+	pfok_on_q_i on_q,		/*!< [in] обработчик */
+	size_t threads			/*!< [in] число потоков */
+);
+
 /*!	\brief Проверка долговременных параметров
 
 	Проверяется, что долговременные параметры params корректны. Для полей 
@@ -189,6 +206,19 @@ err_t pfokValParams(
 	const pfok_params* params	/*!< [in] долговременные параметры */
 );
 
+/*!	\brief Проверка долговременных параметров в нескольких потоках
+
+	Проверяется, что долговременные параметры params корректны, так же,
+	как в функции pfokValParams(). Итерации теста Рабина -- Миллера при 
+	проверке простоты p и q выполняются одновременно в threads потоках 
+	(см. priRMTestMT()).
+	\return ERR_OK, если параметры корректны, и код ошибки в противном случае.
+*/
+err_t pfokValParamsMT(
+	const pfok_params* params,	/*!< [in] долговременные параметры */
+	size_t threads				/*!< [in] число потоков */
+);
+
 /*
 *******************************************************************************
 Управление ключами
@@ -308,6 +338,127 @@ err_t pfokMTI(
 	const octet pubkey1[]		/*!< [in] однораз. откр. ключ (др. стороны) */
 );
 
+/*
+*******************************************************************************
+Подготовленные параметры
+
+Если при одних и тех же долговременных параметрах выполняется много 
+операций, то параметры можно один раз подготовить функцией pfokPrepStart(). 
+В подготовленном объекте хранятся кольцо вычетов по модулю p и таблица 
+степеней g, ускоряющая построение открытых ключей. Функции 
+pfokGenKeypairPrep(), pfokCalcPubkeyPrep(), pfokDHPrep(), pfokMTIPrep() 
+получают подготовленный объект вместо параметров и возвращают те же 
+результаты, что и функции pfokGenKeypair(), pfokCalcPubkey(), pfokDH(), 
+pfokMTI().
+
+Функции не изменяют подготовленный объект, поэтому один объект можно 
+одновременно использовать в нескольких потоках.
+
+Последовательность вызовов: pfokPrep_keep() < pfokPrepStart() < 
+(pfokGenKeypairPrep() | pfokCalcPubkeyPrep() | pfokDHPrep() | 
+pfokMTIPrep())*.
+*******************************************************************************
+*/
+
+/*!	\brief Длина подготовленного объекта
+
+	Возвращается длина (в октетах) объекта, подготовленного для 
+	долговременных параметров с размерностью l.
+	\return Длина объекта.
+	\remark Основную часть объекта составляет таблица из 63 элементов 
+	по O_OF_B(l) октетов: например, для l == 2462 требуется около 19 Кбайт.
+*/
+size_t pfokPrep_keep(
+	size_t l					/*!< [in] размерность l */
+);
+
+/*!	\brief Подготовка долговременных параметров
+
+	По долговременным параметрам params строится подготовленный объект prep.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\expect{ERR_BAD_INPUT} По адресу prep зарезервировано 
+	pfokPrep_keep(params->l) октетов.
+	\return ERR_OK, если объект успешно построен, и код ошибки 
+	в противном случае.
+	\remark Построение таблицы требует примерно столько же времени, сколько 
+	одно возведение g в степень.
+*/
+err_t pfokPrepStart(
+	void* prep,					/*!< [out] подготовленный объект */
+	const pfok_params* params	/*!< [in] долговременные параметры */
+);
+
+/*!	\brief Генерация пары ключей с подготовленными параметрами
+
+	Выполняются действия pfokGenKeypair() при долговременных параметрах, 
+	по которым построен объект prep.
+	\pre Объект prep построен функцией pfokPrepStart() и не изменялся.
+	\return ERR_OK, если ключи успешно сгенерированы, и код ошибки
+	в противном случае.
+*/
+err_t pfokGenKeypairPrep(
+	octet privkey[],			/*!< [out] личный ключ */
+	octet pubkey[],				/*!< [out] открытый ключ */
+	const void* prep,			/*!< [in] подготовленный объект */
+	gen_i rng,					/*!< [in] генератор случайных чисел */
+	void* rng_state				/*!< [in/out] состояние генератора */
+);
+
+/*!	\brief Построение открытого ключа с подготовленными параметрами
+
+	Выполняются действия pfokCalcPubkey() при долговременных параметрах, 
+	по которым построен объект prep.
+	\pre Объект prep построен функцией pfokPrepStart() и не изменялся.
+	\expect{ERR_BAD_PRIVKEY} Личный ключ privkey корректен.
+	\return ERR_OK, если открытый ключ успешно построен, и код ошибки
+	в противном случае.
+*/
+err_t pfokCalcPubkeyPrep(
+	octet pubkey[],				/*!< [out] открытый ключ */
+	const void* prep,			/*!< [in] подготовленный объект */
+	const octet privkey[]		/*!< [in] личный ключ */
+);
+
+/*!	\brief Построение общего ключа протокола Диффи -- Хеллмана 
+	с подготовленными параметрами
+
+	Выполняются действия pfokDH() при долговременных параметрах, по которым 
+	построен объект prep.
+	\pre Объект prep построен функцией pfokPrepStart() и не изменялся.
+	\expect{ERR_BAD_PUBKEY} Открытый ключ pubkey корректен.
+	\expect{ERR_BAD_PRIVKEY} Личный ключ privkey корректен.
+	\return ERR_OK, если общий ключ успешно построен, и код ошибки
+	в противном случае.
+	\remark Таблица степеней g не используется: основание степени -- 
+	открытый ключ другой стороны. Экономится построение кольца.
+*/
+err_t pfokDHPrep(
+	octet sharekey[],			/*!< [out] общий ключ */
+	const void* prep,			/*!< [in] подготовленный объект */
+	const octet privkey[],		/*!< [in] личный ключ */
+	const octet pubkey[]		/*!< [in] открытый ключ (другой стороны) */
+);
+
+/*!	\brief Построение общего ключа протокола MTI с подготовленными 
+	параметрами
+
+	Выполняются действия pfokMTI() при долговременных параметрах, по которым 
+	построен объект prep.
+	\pre Объект prep построен функцией pfokPrepStart() и не изменялся.
+	\expect{ERR_BAD_PUBKEY} Открытые ключи pubkey, pubkey1 корректны.
+	\expect{ERR_BAD_PRIVKEY} Личные ключи privkey, privkey1 корректны.
+	\return ERR_OK, если общий ключ успешно построен, и код ошибки
+	в противном случае.
+*/
+err_t pfokMTIPrep(
+	octet sharekey[],			/*!< [out] общий ключ */
+	const void* prep,			/*!< [in] подготовленный объект */
+	const octet privkey[],		/*!< [in] личный ключ */
+	const octet privkey1[],		/*!< [in] одноразовый личный ключ */
+	const octet pubkey[],		/*!< [in] открытый ключ (другой стороны) */
+	const octet pubkey1[]		/*!< [in] однораз. откр. ключ (др. стороны) */
+);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.19
-\version 2019.06.13
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -99,8 +99,8 @@ ec->order задается 2 * ec->f->n + 1 машинным словом. Ко
 криптографические вычисления на эллиптической кривой. 
 
 Описание ec эллиптической кривой включает указатели на функции арифметики 
-в группе точек этой кривой. Функцию интерфейса ec_tpl_i
-можно не поддерживать. Указатель на неподдерживаемую функцию 
+в группе точек этой кривой. Функции интерфейсов ec_tpl_i, ec_toan_i 
+и ec_mul_i можно не поддерживать. Указатель на неподдерживаемую функцию 
 должен быть нулевым.
 
 Описание кольца организовано как объект, и можно применять функции, 
@@ -353,6 +353,61 @@ typedef void (*ec_tpl_i)(
 	void* stack				/*!< [in] вспомогательная память */
 );
 
+/*!	\brief Пакетный экспорт в аффинные точки
+
+	По точкам [count * ec->d * ec->f->n]a эллиптической кривой ec строятся
+	аффинные точки [count * 2 * ec->f->n]b. Точки a[i] и b[i], 
+	i = 0, 1,..., count - 1, располагаются в буферах a и b последовательно.
+	Если точке a[i] соответствует бесконечно удаленная точка, то координаты
+	b[i] обнуляются.
+	\pre Описание ec работоспособно.
+	\pre count > 0.
+	\pre Буферы a и b не пересекаются.
+	\pre Координаты a[i] лежат в базовом поле.
+	\expect Описание ec корректно.
+	\expect Точки a[i] лежат на кривой.
+	\return TRUE, если все аффинные точки построены, и FALSE, если 
+	среди a[i] есть бесконечно удаленные.
+	\remark Функция интерфейса должна быть эффективнее count вызовов
+	функции интерфейса ec_toa_i. Например, обращения в базовом поле могут
+	объединяться с помощью трюка Монтгомери.
+*/
+typedef bool_t (*ec_toan_i)(
+	word b[],				/*!< [out] аффинные точки */
+	const word a[],			/*!< [in] входные точки */
+	size_t count,			/*!< [in] число точек */
+	const struct ec_o* ec,	/*!< [in] описание эллиптической кривой */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
+/*!	\brief Кратная точка (специальный алгоритм)
+
+	Определяется [m]d-кратная точка [ec->d * ec->f->n]b аффинной точки 
+	[2 * ec->f->n]a кривой ec:
+	\code
+		b <- d a.
+	\endcode
+	Функция интерфейса реализует алгоритм, который учитывает особенности 
+	кривой (например, использует эндоморфизм Фробениуса).
+	\pre Описание ec работоспособно.
+	\pre Буферы a и b не пересекаются.
+	\pre Координаты a лежат в базовом поле.
+	\expect Описание ec корректно.
+	\expect Точка a лежит на кривой.
+	\return TRUE, если кратная точка рассчитана, и FALSE, если алгоритм 
+	неприменим (например, слишком велика длина d). В последнем случае 
+	вызывающая функция должна использовать общий алгоритм.
+	\remark Глубина стека функции интерфейса не превосходит ec->deep.
+*/
+typedef bool_t (*ec_mul_i)(
+	word b[],				/*!< [out] кратная точка */
+	const word a[],			/*!< [in] аффинная точка */
+	const struct ec_o* ec,	/*!< [in] описание эллиптической кривой */
+	const word d[],			/*!< [in] кратность */
+	size_t m,				/*!< [in] длина d в машинных словах */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
 /*!	\brief Описание эллиптической кривой
 
 	Описывается эллиптическая кривая, правила представления ее элементов, 
@@ -383,6 +438,8 @@ typedef struct ec_o
 	ec_dbl_i dbl;			/*!< функция удвоения */
 	ec_dbla_i dbla;			/*!< функция удвоения аффинной точки */
 	ec_tpl_i tpl;			/*!< функция утроения */
+	ec_toan_i toan;			/*!< функция пакетного экспорта в аффинные точки */
+	ec_mul_i mul;			/*!< функция расчета кратной точки */
 	size_t deep;			/*!< максимальная глубина стека функций */
 	octet descr[];			/*!< память для размещения данных */
 } ec_o;
@@ -408,6 +465,12 @@ typedef struct ec_o
 #define ecToA(b, a, ec, stack)\
 	(ec)->toa(b, a, ec, stack)
 
+#define ecToAN(b, a, count, ec, stack)\
+	(ec)->toan(b, a, count, ec, stack)
+
+#define ecMulSpec(b, a, ec, d, m, stack)\
+	((ec)->mul != 0 && (ec)->mul(b, a, ec, d, m, stack))
+
 #define ecFrom(b, a, ec, stack)\
 	(qrFrom(ecX(b), a, (ec)->f, stack) &&\
 		qrFrom(ecY(b, (ec)->f->n), (a) + (ec)->f->no, (ec)->f, stack) &&\
@@ -543,6 +606,66 @@ bool_t ecIsOperableGroup(
 *******************************************************************************
 */
 
+/*!	\brief Кратная точка в проективных координатах
+
+	Определяется проективная точка [ec->d * ec->f->n]b эллиптической кривой 
+	ec, которая является [m]d-кратной аффинной точки [2 * ec->f->n]a:
+	\code
+		b <- d a.
+	\endcode
+	\pre Описание ec работоспособно.
+	\pre Координаты a лежат в базовом поле.
+	\pre Буферы b и a либо не пересекаются, либо начинаются с одного адреса.
+	\expect Описание ec корректно.
+	\expect Точка a лежит на ec.
+	\remark Если d == 0, то b == O. Если d != 0, то b может оказаться равной
+	O (проверяется с помощью ecIsO()).
+	\remark Функцию удобно использовать, если переход к аффинным координатам
+	можно отложить или выполнить сразу для нескольких точек.
+	\deep{stack} ecMul_deep(ec->f->n, ec->d, ec->deep, m).
+*/
+void ecMul(
+	word b[],			/*!< [out] кратная точка */
+	const word a[],		/*!< [in] базовая точка */
+	const ec_o* ec,		/*!< [in] описание кривой */
+	const word d[],		/*!< [in] кратность */
+	size_t m,			/*!< [in] длина d в машинных словах */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t ecMul_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m);
+
+/*!	\brief Кратные точки в проективных координатах
+
+	Определяются проективные точки [ec->d * ec->f->n]b[i] эллиптической
+	кривой ec, которые являются [m]d-кратными аффинных точек 
+	[2 * ec->f->n]a[i]:
+	\code
+		b[i] <- d a[i], i = 0, 1,..., count - 1.
+	\endcode
+	Точки b[i] располагаются в b последовательно, начиная с b[0]. Точно так
+	же располагаются в a точки a[i].
+	\pre Описание ec работоспособно.
+	\pre Координаты a[i] лежат в базовом поле.
+	\pre Буферы b и a не пересекаются.
+	\expect Описание ec корректно.
+	\expect Точки a[i] лежат на ec.
+	\remark Представление d (NAF) рассчитывается один раз для всех точек.
+	\remark Если d == 0, то b[i] == O.
+	\deep{stack} ecMulN_deep(ec->f->n, ec->d, ec->deep, m).
+*/
+void ecMulN(
+	word b[],			/*!< [out] кратные точки */
+	const word a[],		/*!< [in] базовые точки */
+	size_t count,		/*!< [in] число точек */
+	const ec_o* ec,		/*!< [in] описание кривой */
+	const word d[],		/*!< [in] кратность */
+	size_t m,			/*!< [in] длина d в машинных словах */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t ecMulN_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m);
+
 /*!	\brief Кратная точка
 
 	Определяется аффинная точка [2 * ec->f->n]b эллиптической кривой ec, 
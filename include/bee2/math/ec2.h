@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.19
-\version 2014.04.17
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -37,8 +37,9 @@ extern "C" {
 E(GF(2^m)) -- множество аффинных точек E (решений E в GF(2^m)),
 O -- бесконечно удаленная точка.
 
-Поддерживаются координаты Лопеса -- Дахаба (с помощью структуры ec_o) 
-и аффинные координаты (прямые функции).
+Поддерживаются координаты Лопеса -- Дахаба и лямбда-координаты 
+(с помощью структуры ec_o), а также аффинные координаты (прямые функции).
+Координаты выбираются при создании описания кривой.
 
 \pre Все указатели, передаваемые в функции, действительны.
 
@@ -61,6 +62,13 @@ O -- бесконечно удаленная точка.
 	\return Признак успеха.
 	\post ec->d == 3.
 	\post Буферы ec->order и ec->base подготовлены для ecCreateGroup().
+	\remark Если A \in {0, 1} и B == 1 (кривая Коблица), то в описании ec
+	устанавливается интерфейс ec->mul, который реализует ускоренное 
+	умножение точки на число с помощью эндоморфизма Фробениуса.
+	\remark В ec2CreateLD_keep() и ec2CreateLD_deep() учитывается память 
+	для ускоренного умножения на кривой Коблица. Для других кривых эта 
+	память не используется: она не входит ни в размер объекта ec, 
+	ни в ec->deep.
 	\keep{ec} ec2CreateLD_keep(f->n).
 	\deep{stack} ec2CreateLD_deep(f->n, f->deep).
 */
@@ -75,6 +83,36 @@ bool_t ec2CreateLD(
 size_t ec2CreateLD_keep(size_t n);
 size_t ec2CreateLD_deep(size_t n, size_t f_deep);
 
+/*!	\brief Создание эллиптической кривой в лямбда-координатах
+
+	Создается описание ec эллиптической кривой в проективных 
+	лямбда-координатах над полем f с коэффициентами [f->no]A и [f->no]B.
+	В лямбда-координатах точка (x, y) представляется парой 
+	(x, x + y / x). Сложение проективных точек выполняется быстрее, чем 
+	в координатах Лопеса -- Дахаба.
+	\return Признак успеха.
+	\post ec->d == 3.
+	\post Буферы ec->order и ec->base подготовлены для ecCreateGroup().
+	\remark Точка (0, \sqrt{B}) порядка 2 не имеет лямбда-координаты 
+	и представляется тройкой (0 : 1 : 1). Операции с этой точкой выполняются 
+	через аффинные координаты.
+	\remark Для кривой Коблица устанавливается интерфейс ec->mul 
+	(см. ec2CreateLD()). Память для него резервируется в ec2CreateLAM_keep() 
+	и ec2CreateLAM_deep(), но используется только для кривой Коблица.
+	\keep{ec} ec2CreateLAM_keep(f->n).
+	\deep{stack} ec2CreateLAM_deep(f->n, f->deep).
+*/
+bool_t ec2CreateLAM(
+	ec_o* ec,			/*!< [in] описание кривой */
+	const qr_o* f,		/*!< [in] базовое поле */
+	const octet A[],	/*!< [in] коэффициент A */
+	const octet B[],	/*!< [in] коэффициент B */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t ec2CreateLAM_keep(size_t n);
+size_t ec2CreateLAM_deep(size_t n, size_t f_deep);
+
 /*
 *******************************************************************************
 Свойства кривой и группы точек
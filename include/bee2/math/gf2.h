@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.17
-\version 2015.02.01
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -62,6 +62,10 @@ extern "C" {
 машинными словами (степень p(x) кратна B_PER_W), либо n + 1 словом 
 (степень p(x) не кратна B_PER_W).  
 
+При создании поля также рассчитывается маска следа: битовая строка 
+из следов мономов x^i, i = 0, 1,..., m - 1. С помощью маски след элемента 
+поля определяется за O(n) операций (см. gf2Tr()).
+
 Некоторые неприводимые многочлены из криптографических стандартов:
 Belt, GCM:	x^128 + x^7 + x^2 + x + 1,
 NIST163:	x^163 + x^7 + x^6 + x^3 + 1,
@@ -198,6 +202,7 @@ qr_sub_i, qr_neg_i идут прямые обращения к wwXor(), wwXor2()
 	\pre Элемент a принадлежит f.
 	\expect Описание f корректно.
 	\return FALSE, если след равняется 0, и TRUE, если след равняется 1.
+	\remark След определяется по маске, рассчитанной в gf2Create().
 	\deep{stack} gf2Tr_deep(f->n, f->deep).
 */
 bool_t gf2Tr(
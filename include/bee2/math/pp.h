@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.03.01
-\version 2016.05.18
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -160,6 +160,21 @@ void ppSqr(
 
 size_t ppSqr_deep(size_t n);
 
+/*! \brief Использование команды pclmulqdq
+
+	Разрешается (use == TRUE) или запрещается (use == FALSE) использование 
+	команды pclmulqdq в функциях ppMulW(), ppAddMulW(), ppMul(), ppSqr() 
+	и зависящих от них. По умолчанию использование разрешено.
+	\return Признак того, что команда будет использоваться: use == TRUE, 
+	и платформа поддерживает команду.
+	\remark Функция предназначена для тестирования: после запрета 
+	выполняются переносимые (табличные) реализации.
+	\remark Результаты функций не зависят от того, используется ли команда.
+*/
+bool_t ppUseClmul(
+	bool_t use			/*!< [in] признак использования */
+);
+
 /*! \brief Деление многочленов
 
 	Определяется частное [n - m + 1]q и остаток [n]r от деления многочлена
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.08.13
-\version 2015.04.28
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -74,6 +74,8 @@ word priBasePrime(
 	Определяются остатки [count]mods от деления числа [n]a на первые count 
 	простых из факторной базы.
 	\pre count <= priBaseSize().
+	\remark Остатки по нескольким модулям рассчитываются одновременно,
+	за один проход по словам a, без машинных делений в основном цикле.
 */
 void priBaseMod(
 	word mods[],		/*!< [out] остатки */
@@ -114,9 +116,8 @@ size_t priIsSieved_deep(size_t base_count);
 	и на base_count первых простых из факторной базы.
 	\pre base_count <= priBaseSize().
 	\return Признак успеха.
-	\remark Число a не считается , если совпадает с элементом 
-	факторной базы. Число a = 1 считается просеянным. 
-	\deep{stack} priIsSieved_deep(n).
+	\remark Степени двойки (в том числе a = 1) считаются гладкими.
+	\deep{stack} priIsSmooth_deep(n).
 */
 bool_t priIsSmooth(
 	const word a[],		/*!< [in] проверяемое число */
@@ -172,6 +173,29 @@ bool_t priRMTest(
 
 size_t priRMTest_deep(size_t n);
 
+/*!	\brief Тест Рабина -- Миллера в нескольких потоках
+
+	Проверяется простота числа [n]a так же, как в функции priRMTest().
+	Итерации теста выполняются одновременно в threads потоках. Основания 
+	генерируются в том же порядке, что и в priRMTest(), и не зависят от 
+	распределения итераций между потоками. После обнаружения свидетеля 
+	непростоты новые итерации не начинаются.
+	\pre threads > 0.
+	\return Признак успеха.
+	\remark Если операционная система не поддерживает потоки, то итерации
+	выполняются последовательно.
+	\deep{stack} priRMTestMT_deep(n, threads).
+*/
+bool_t priRMTestMT(
+	const word a[],		/*!< [in] проверяемое число */
+	size_t n,			/*!< [in] длина a в машинных словах */
+	size_t iter,		/*!< [in] число итераций */
+	size_t threads,		/*!< [in] число потоков */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t priRMTestMT_deep(size_t n, size_t threads);
+
 /*!	\brief Простое?
 
 	Проверяется, что число [n]a является простым. Используется
@@ -209,6 +233,18 @@ size_t priIsSGPrime_deep(size_t n);
 /*
 *******************************************************************************
 Генерация простых
+
+Кандидаты в простые перебираются с постоянным шагом и просеиваются по 
+факторной базе окнами: для окна из нескольких сотен кандидатов кратные 
+малым простым отмечаются в битовой карте. Остатки от деления на простые
+факторной базы рассчитываются только для начального кандидата.
+
+Кандидаты, прошедшие решето, могут проверяться одновременно в threads 
+потоках (функции с суффиксом MT). Результат (и последовательность 
+обращений к генератору случайных чисел) не зависит от threads: из 
+каждого пакета проверенных кандидатов выбирается первый подходящий.
+Если операционная система не поддерживает потоки, то кандидаты 
+проверяются последовательно.
 *******************************************************************************
 */
 
@@ -252,6 +288,33 @@ bool_t priNextPrime(
 
 size_t priNextPrime_deep(size_t n, size_t base_count);
 
+/*!	\brief Следующее простое в нескольких потоках
+
+	Определяется минимальное нечетное простое [n]p из интервала [[n]a, 2^l)
+	так же, как в функции priNextPrime(). Тест Рабина -- Миллера
+	выполняется одновременно для threads кандидатов.
+	\pre Буфер p либо не пересекается с буфером a, либо указатели a и p
+	совпадают.
+	\pre base_count <= priBaseSize().
+	\pre threads > 0.
+	\return TRUE, если искомое простое найдено, и FALSE в противном случае.
+	\deep{stack} priNextPrimeMT_deep(n, base_count, threads).
+	\remark Вызов priNextPrime() эквивалентен вызову priNextPrimeMT() 
+	с threads == 1.
+*/
+bool_t priNextPrimeMT(
+	word p[],			/*!< [out] простое число */
+	const word a[],		/*!< [in] начальное значение */
+	size_t n,			/*!< [in] длина a и p в машинных словах */
+	size_t trials,		/*!< [in] число кандидатов */
+	size_t base_count,	/*!< [in] число элементов факторной базы */
+	size_t iter,		/*!< [in] число итераций теста Рабина -- Миллера */
+	size_t threads,		/*!< [in] число потоков */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t priNextPrimeMT_deep(size_t n, size_t base_count, size_t threads);
+
 /*!	\brief Расширение простого
 
 	По базовому нечетному простому [n]q определяется расширенное 
@@ -291,6 +354,39 @@ bool_t priExtendPrime(
 
 size_t priExtendPrime_deep(size_t l, size_t n, size_t base_count);
 
+/*!	\brief Расширение простого в нескольких потоках
+
+	По базовому нечетному простому [n]q определяется расширенное 
+	простое [W_OF_B(l)]p битовой длины l так же, как в функции 
+	priExtendPrime(). Условие теоремы Демитко проверяется одновременно 
+	для threads кандидатов.
+	\pre Буфер p не пересекается с буфером q.
+	\pre q -- нечетное && q >= 3.
+	\pre wwBitSize(q, n) + 1 <= l && l <= 2 * wwBitSize(q, n).
+	\pre base_count <= priBaseSize().
+	\pre threads > 0.
+	\expect q -- простое.
+	\return TRUE, если искомое простое найдено, и FALSE в противном случае.
+	\remark Генератор rng вызывается только из вызывающего потока, причем 
+	столько же раз, сколько в priExtendPrime().
+	\deep{stack} priExtendPrimeMT_deep(l, n, base_count, threads).
+*/
+bool_t priExtendPrimeMT(
+	word p[],			/*!< [out] расширенное простое число */
+	size_t l,			/*!< [in] длина p в битах */
+	const word q[],		/*!< [in] базовое простое число */
+	size_t n,			/*!< [in] длина q в машинных словах */
+	size_t trials,		/*!< [in] число кандидатов */
+	size_t base_count,	/*!< [in] число элементов факторной базы */
+	gen_i rng,			/*!< [in] генератор случайных чисел */
+	void* rng_state,	/*!< [in] состояние rng */
+	size_t threads,		/*!< [in] число потоков */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t priExtendPrimeMT_deep(size_t l, size_t n, size_t base_count, 
+	size_t threads);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2013.08.09
-\version 2015.09.01
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -334,6 +334,7 @@ typedef struct qr_o
 	qr_inv_i inv;		/*!< функция мультипликативного обращения */
 	qr_div_i div;		/*!< функция деления */
 	size_t deep;		/*!< максимальная глубина стека функций */
+	bool_t safe;		/*!< признак регулярных редакций функций */
 	octet descr[];		/*!< память для размещения данных */
 } qr_o;
 
@@ -446,6 +447,136 @@ void qrPower(
 
 size_t qrPower_deep(size_t n, size_t m, size_t r_deep);
 
+/*! \brief Произведение степеней в кольце вычетов
+
+	В кольце вычетов r определяется элемент [r->n]c, который является 
+	произведением [m1]b1-ой степени элемента [r->n]a1 и [m2]b2-ой степени 
+	элемента [r->n]a2:
+	\code
+		c <- a1^b1 * a2^b2.
+	\endcode
+	\pre Описание кольца r работоспособно.
+	\pre Элементы a1, a2 принадлежат r.
+	\expect Описание кольца r корректно.
+	\remark При b1 == b2 == 0 возвращается r->unity.
+	\remark Возведения в квадрат совмещаются: их число определяется 
+	длиной большего из показателей, а не суммой длин.
+	\deep{stack} qrPower2_deep(r->n, m1, m2, r->deep).
+*/
+void qrPower2(
+	word c[],				/*!< [out] произведение степеней */
+	const word a1[],		/*!< [in] первое основание */
+	const word b1[],		/*!< [in] первый показатель */
+	size_t m1,				/*!< [in] длина b1 в машинных словах */
+	const word a2[],		/*!< [in] второе основание */
+	const word b2[],		/*!< [in] второй показатель */
+	size_t m2,				/*!< [in] длина b2 в машинных словах */
+	const qr_o* r,			/*!< [in] описание кольца */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
+size_t qrPower2_deep(size_t n, size_t m1, size_t m2, size_t r_deep);
+
+/*! \brief Возведение в степень специального вида
+
+	В кольце вычетов r определяется элемент [r->n]b, который является 
+	степенью элемента [r->n]a с показателем 2^l - d:
+	\code
+		b <- a^{2^l - d}.
+	\endcode
+	\pre Описание кольца r работоспособно.
+	\pre Элемент a принадлежит r.
+	\pre d != 0 && 2^{l - 1} > d.
+	\expect Описание кольца r корректно.
+	\remark Используется аддитивная цепочка, которая выгодна при малых d.
+	Такие показатели возникают при обращении (p - 2) и извлечении 
+	квадратных корней ((p + 1) / 4) по модулю Крэндалла p.
+	\remark Последовательность операций в кольце определяется только l и d.
+	\deep{stack} qrPowerChain_deep(r->n, r->deep).
+*/
+void qrPowerChain(
+	word b[],				/*!< [out] степень */
+	const word a[],			/*!< [in] основание */
+	size_t l,				/*!< [in] показатель двойки */
+	word d,					/*!< [in] вычитаемое */
+	const qr_o* r,			/*!< [in] описание кольца */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
+size_t qrPowerChain_deep(size_t n, size_t r_deep);
+
+/*! \brief Объем таблицы для возведения в степень с фиксированным основанием
+
+	Определяется размер в октетах таблицы, которая используется 
+	в функциях qrPowerCombStart(), qrPowerComb() для колец с элементами 
+	из n машинных слов и гребней с h зубьями.
+	\pre 1 <= h < B_PER_W.
+	\return Размер таблицы.
+*/
+size_t qrPowerComb_keep(
+	size_t n,				/*!< [in] длина элементов в машинных словах */
+	size_t h				/*!< [in] число зубьев */
+);
+
+/*! \brief Подготовка таблицы для возведения в степень 
+	с фиксированным основанием
+
+	Для элемента [r->n]a кольца r рассчитывается таблица t, которая 
+	используется в функции qrPowerComb() для возведения a в степени 
+	битовой длины не больше l по гребенчатому методу с h зубьями.
+	\pre Описание кольца r работоспособно.
+	\pre Элемент a принадлежит r.
+	\pre l > 0 && 1 <= h < B_PER_W.
+	\pre Буфер t содержит qrPowerComb_keep(r->n, h) октетов.
+	\expect Описание кольца r корректно.
+	\remark Таблица состоит из 2^h - 1 элементов кольца. Ее расчет 
+	требует примерно столько же операций, сколько одно обычное
+	возведение в степень.
+	\deep{stack} qrPowerCombStart_deep(r->n, r->deep).
+*/
+void qrPowerCombStart(
+	word t[],				/*!< [out] таблица */
+	const word a[],			/*!< [in] основание */
+	size_t l,				/*!< [in] граница битовой длины показателей */
+	size_t h,				/*!< [in] число зубьев */
+	const qr_o* r,			/*!< [in] описание кольца */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
+size_t qrPowerCombStart_deep(size_t n, size_t r_deep);
+
+/*! \brief Возведение в степень с фиксированным основанием
+
+	В кольце вычетов r определяется элемент [r->n]c, который является [m]b-ой 
+	степенью элемента a, заданного таблицей t:
+	\code
+		c <- a^b.
+	\endcode
+	\pre Описание кольца r работоспособно.
+	\pre Таблица t построена функцией qrPowerCombStart() с параметрами 
+	a, l, h, r.
+	\pre wwBitSize(b, m) <= l.
+	\expect Описание кольца r корректно.
+	\remark При b == 0 возвращается r->unity.
+	\remark Выполняется \ceil(l / h) - 1 возведений в квадрат и не более 
+	\ceil(l / h) умножений.
+	\safe Функция нерегулярна: условные переходы и обращения к таблице 
+	определяются битами b.
+	\deep{stack} qrPowerComb_deep(r->n, r->deep).
+*/
+void qrPowerComb(
+	word c[],				/*!< [out] степень */
+	const word t[],			/*!< [in] таблица */
+	const word b[],			/*!< [in] показатель */
+	size_t m,				/*!< [in] длина b в машинных словах */
+	size_t l,				/*!< [in] граница битовой длины показателей */
+	size_t h,				/*!< [in] число зубьев */
+	const qr_o* r,			/*!< [in] описание кольца */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
+size_t qrPowerComb_deep(size_t n, size_t r_deep);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
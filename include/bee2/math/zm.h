@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2013.09.14
-\version 2014.07.15
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -238,12 +238,118 @@ bool_t zmIsValid(
 
 #define zmIsOperable zmIsValid
 
+/*
+*******************************************************************************
+Возведение в степень
+*******************************************************************************
+*/
+
+/*!	\brief Возведение в степень по модулю кольца
+
+	Определяется число [r->n]c, которое является [m]b-ой степенью 
+	числа [r->n]a по модулю r->mod:
+	\code
+		c <- a^b \mod r->mod.
+	\endcode
+	\pre Описание кольца r работоспособно.
+	\pre a < r->mod.
+	\remark Числа a и c задаются в обычном (а не во внутреннем) 
+	представлении. Функция повторяет zzPowerMod(), но использует готовое 
+	описание кольца. Если по одному модулю выполняется несколько 
+	возведений в степень, то кольцо следует создать один раз
+	и передавать функции zmPowerMod().
+	\remark 0^0 == 1.
+	\deep{stack} zmPowerMod_deep(r->n, m, r->deep).
+*/
+void zmPowerMod(
+	word c[],			/*!< [out] степень */
+	const word a[],		/*!< [in] основание */
+	const word b[],		/*!< [in] показатель */
+	size_t m,			/*!< [in] длина b в машинных словах */
+	const qr_o* r,		/*!< [in] описание кольца */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t zmPowerMod_deep(size_t n, size_t m, size_t f_deep);
+
+/*
+*******************************************************************************
+Извлечение квадратных корней
+*******************************************************************************
+*/
+
+/*!	\brief Степень для извлечения квадратного корня
+
+	В кольце r = Z / (p) определяется элемент [r->n]b, который является 
+	степенью элемента [r->n]a с показателем (p - 3) / 4:
+	\code
+		b <- a^{(p - 3) / 4}.
+	\endcode
+	\pre Описание кольца r работоспособно.
+	\pre Элемент a принадлежит r.
+	\pre p \equiv 3 \mod 4.
+	\remark Если p -- простое, то произведение a b является квадратным 
+	корнем из a, если такой корень существует. При этом (a b)^2 == a тогда и
+	только тогда, когда a -- квадратичный вычет или 0. Таким образом, 
+	одно возведение в степень позволяет и извлечь корень, и проверить, 
+	что он существует.
+	\remark Для модулей Крэндалла используется быстрая аддитивная цепочка
+	(см. qrPowerChain()).
+	\deep{stack} zmPowerSqrt_deep(r->n, r->deep).
+*/
+void zmPowerSqrt(
+	word b[],			/*!< [out] степень */
+	const word a[],		/*!< [in] основание */
+	const qr_o* r,		/*!< [in] описание кольца */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t zmPowerSqrt_deep(size_t n, size_t f_deep);
+
+/*
+*******************************************************************************
+Выбор редакций
+*******************************************************************************
+*/
+
+/*!	\brief Выбор редакций функций кольца
+
+	Функции кольца r переключаются на регулярные (safe == TRUE) или 
+	ускоренные нерегулярные (safe == FALSE) редакции.
+	\pre Кольцо r создано одной из функций zmCreateXXX() или zmMontCreate().
+	\remark При создании кольца устанавливаются редакции по умолчанию, 
+	которые определяются директивой SAFE_FAST (см. safe.h). Функция 
+	zmSetSafe() позволяет в одной программе использовать регулярные 
+	вычисления в операциях с секретными данными и ускоренные -- в операциях
+	с открытыми данными.
+	\remark Переключаются функции сложения, вычитания, аддитивного обращения,
+	умножения и возведения в квадрат. Развернутые ядра умножения, которые 
+	используются в некоторых кольцах, регулярны и не переключаются.
+	\remark Выбранные редакции фиксируются в поле r->safe.
+	\remark Редакции не влияют на результаты вычислений.
+*/
+void zmSetSafe(
+	qr_o* r,			/*!< [in/out] описание кольца */
+	bool_t safe			/*!< [in] признак регулярных редакций */
+);
+
+/*!	\brief Установлены регулярные редакции?
+
+	Проверяется, что для кольца r установлены регулярные редакции функций.
+	\pre Кольцо r создано одной из функций zmCreateXXX() или zmMontCreate().
+	\return Признак регулярных редакций.
+*/
+bool_t zmIsSafe(
+	const qr_o* r		/*!< [in] описание кольца */
+);
+
 /*
 *******************************************************************************
 Акселераторы
 
 Для ускорения работы вместо обращения к функциям интерфейсов qr_add_i, 
 qr_sub_i, qr_neg_i идут прямые обращения к zzAddMod(), zzSubMod(), zzNegMod().
+Редакции функций выбираются по признаку r->safe (см. zmSetSafe()).
 *******************************************************************************
 */
 
@@ -251,13 +357,13 @@ qr_sub_i, qr_neg_i идут прямые обращения к zzAddMod(), zzSub
 	(wwCmp(a, (r)->mod, (r)->n) < 0)
 
 #define zmAdd(c, a, b, r)\
-	zzAddMod(c, a, b, (r)->mod, (r)->n)
+	((r)->safe ? SAFE(zzAddMod) : FAST(zzAddMod))(c, a, b, (r)->mod, (r)->n)
 
 #define zmSub(c, a, b, r)\
-	zzSubMod(c, a, b, (r)->mod, (r)->n)
+	((r)->safe ? SAFE(zzSubMod) : FAST(zzSubMod))(c, a, b, (r)->mod, (r)->n)
 
 #define zmNeg(b, a, r)\
-	zzNegMod(b, a, (r)->mod, (r)->n)
+	((r)->safe ? SAFE(zzNegMod) : FAST(zzNegMod))(b, a, (r)->mod, (r)->n)
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.22
-\version 2019.06.27
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -822,8 +822,8 @@ size_t zzSqrMod_deep(size_t n);
 	\pre Буфер b не пересекается с буфером mod.
 	\expect \gcd(a, mod) == 1.
 	\remark Если \gcd(a, mod) != 1, то b <- 0.
+	\remark Используется алгоритм Бернштейна -- Янга (см. zzDivMod()).
 	\deep{stack} zzInvMod_deep(n).
-	\safe Функция нерегулярна.
 */
 void zzInvMod(
 	word b[],			/*!< [out] обратное число */
@@ -847,8 +847,10 @@ size_t zzInvMod_deep(size_t n);
 	\pre Буфер b не пересекается с буфером mod.
 	\expect \gcd(a, mod) = 1.
 	\remark Если \gcd(a, mod) != 1, то b <- 0.
+	\remark Используется алгоритм Бернштейна -- Янга (safegcd) с 
+	фиксированным числом итераций, которое зависит только от битовой длины mod.
+	Время выполнения не зависит от a и divident.
 	\deep{stack} zzDivMod_deep(n).
-	\safe Функция нерегулярна.
 */
 void zzDivMod(
 	word b[],				/*!< [out] частное */
@@ -1169,6 +1171,9 @@ size_t zzRedCrandMont_deep(size_t n);
 	\pre n > 0 && mod[n - 1] != 0.
 	\pre a < mod.
 	\remark 0^0 == 1.
+	\remark При каждом вызове создается описание кольца вычетов по модулю 
+	mod. Для серии возведений в степень по одному модулю следует создать 
+	кольцо один раз и использовать функцию zmPowerMod().
 	\deep{stack} zzPowerMod_deep(n, m).
 	\safe todo
 */
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.10.10
-\version 2015.08.27
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -121,6 +121,30 @@ void mtMtxClose(mt_mtx_t* mtx)
 
 #ifdef OS_WIN
 
+static DWORD WINAPI mtThrdMain(LPVOID arg)
+{
+	mt_thrd_t* thrd = (mt_thrd_t*)arg;
+	thrd->ret = thrd->func(thrd->arg);
+	return 0;
+}
+
+bool_t mtThrdCreate(mt_thrd_t* thrd, mt_thrd_i func, void* arg)
+{
+	ASSERT(memIsValid(thrd, sizeof(mt_thrd_t)));
+	ASSERT(func != 0);
+	thrd->func = func, thrd->arg = arg, thrd->ret = 0;
+	thrd->hdl = CreateThread(0, 0, mtThrdMain, thrd, 0, 0);
+	return thrd->hdl != NULL;
+}
+
+int mtThrdJoin(mt_thrd_t* thrd)
+{
+	ASSERT(memIsValid(thrd, sizeof(mt_thrd_t)));
+	WaitForSingleObject(thrd->hdl, INFINITE);
+	CloseHandle(thrd->hdl);
+	return thrd->ret;
+}
+
 void mtSleep(u32 ms)
 {
 	Sleep(ms);
@@ -130,6 +154,28 @@ void mtSleep(u32 ms)
 
 #include <time.h>
 
+static void* mtThrdMain(void* arg)
+{
+	mt_thrd_t* thrd = (mt_thrd_t*)arg;
+	thrd->ret = thrd->func(thrd->arg);
+	return 0;
+}
+
+bool_t mtThrdCreate(mt_thrd_t* thrd, mt_thrd_i func, void* arg)
+{
+	ASSERT(memIsValid(thrd, sizeof(mt_thrd_t)));
+	ASSERT(func != 0);
+	thrd->func = func, thrd->arg = arg, thrd->ret = 0;
+	return pthread_create(&thrd->hdl, 0, mtThrdMain, thrd) == 0;
+}
+
+int mtThrdJoin(mt_thrd_t* thrd)
+{
+	ASSERT(memIsValid(thrd, sizeof(mt_thrd_t)));
+	pthread_join(thrd->hdl, 0);
+	return thrd->ret;
+}
+
 void mtSleep(u32 ms)
 {
 	struct timespec ts;
@@ -141,6 +187,17 @@ void mtSleep(u32 ms)
 
 #else
 
+bool_t mtThrdCreate(mt_thrd_t* thrd, mt_thrd_i func, void* arg)
+{
+	return FALSE;
+}
+
+int mtThrdJoin(mt_thrd_t* thrd)
+{
+	ASSERT(memIsValid(thrd, sizeof(mt_thrd_t)));
+	return thrd->ret;
+}
+
 void mtSleep(u32 ms)
 {
 }
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2013.05.14
-\version 2018.11.30
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -16,6 +16,7 @@ version 3. See Copyright Notices in bee2/info.h.
 #include "bee2/core/mem.h"
 #include "bee2/core/u32.h"
 #include "bee2/core/util.h"
+#include "bee2/core/word.h"
 #include "bee2/crypto/bels.h"
 #include "bee2/crypto/belt.h"
 #include "bee2/math/pp.h"
@@ -261,21 +262,101 @@ err_t belsGenMid(octet mid[], size_t len, const octet m0[], const octet id[],
 	return reps != SIZE_MAX ? ERR_OK : ERR_BAD_PUBKEY;
 }
 
+/*
+*******************************************************************************
+Редукция
+
+Частичный секрет -- это остаток от деления многочлена c(x) степени < t l 
+на f(x) = x^l + m(x), где l = n B_PER_W, t -- порог. Старший моном f(x) 
+занимает отдельное слово, поэтому деление выполняется по словам, от старших 
+к младшим. Очередное старшее слово [1]h многочлена c(x) обнуляется 
+вычитанием q f(x), сдвинутого на подходящее число слов. Цифра-частное q 
+определяется по старшему слову m_{n-1} многочлена m(x) с помощью 
+константы Барретта
+	mu = \lfloor x^{2w} / (x^w + m_{n-1}) \rfloor - x^w,	w = B_PER_W,
+по формуле
+	q = h + \lfloor h mu / x^w \rfloor.
+Формула точна, так как deg(h x^w) < 2w. Константа mu зависит только 
+от открытого ключа и рассчитывается один раз для каждого ключа.
+
+Слова умножаются функциями ppMulW() и ppAddMulW(), т.е. командой pclmulqdq 
+(если она доступна). Многочлен m(x) обрабатывается только до старшего 
+ненулевого слова. У стандартных открытых ключей (см. belsStdM()) ненулевым 
+является только младшее слово: на каждое слово c(x) тратится одно 
+умножение слов. В ppMod() цифры-частные определяются с помощью таблиц 
+по 4 бита, и весь делитель обрабатывается целиком.
+*******************************************************************************
+*/
+
+static word belsModMu(word t)
+{
+	register word hi = t;
+	register word lo = 0;
+	word mu = 0;
+	size_t pos = B_PER_W;
+	// mu <- \lfloor t x^w / (x^w + t) \rfloor
+	while (pos--)
+		if (hi >> pos & 1)
+		{
+			mu ^= WORD_1 << pos;
+			hi ^= WORD_1 << pos;
+			if (pos)
+				hi ^= t >> (B_PER_W - pos);
+			lo ^= t << pos;
+		}
+	ASSERT(hi == 0);
+	lo = 0;
+	return mu;
+}
+
+static void belsMod(word c[], size_t cn, const word m[], size_t n, 
+	word mu, void* stack)
+{
+	const size_t k = wwWordSize(m, n);
+	register word q;
+	word t;
+	size_t i;
+	// pre
+	ASSERT(wwIsValid(c, cn) && wwIsValid(m, n));
+	ASSERT(cn >= n);
+	// цикл по словам c(x)
+	for (i = cn; i-- > n;)
+	{
+		// q <- c[i] + \lfloor c[i] mu / x^w \rfloor
+		q = c[i] ^ ppMulW(&t, c + i, 1, mu, stack);
+		// c(x) <- c(x) - q x^{w(i - n)} f(x)
+		c[i - n + k] ^= ppAddMulW(c + i - n, m, k, q, stack);
+		c[i] ^= q;
+		ASSERT(c[i] == 0);
+	}
+	q = t = 0;
+}
+
+static size_t belsMod_deep(size_t n)
+{
+	return utilMax(2,
+		ppMulW_deep(1),
+		ppAddMulW_deep(n));
+}
+
 /*
 *******************************************************************************
 Разделение секрета
 *******************************************************************************
 */
 
-err_t belsShare(octet si[], size_t count, size_t threshold, size_t len, 
-	const octet s[], const octet m0[], const octet mi[], 
-	gen_i rng, void* rng_state)
+err_t belsBatchShare(octet si[], size_t batch, size_t count, 
+	size_t threshold, size_t len, const octet s[], const octet m0[], 
+	const octet mi[], gen_i rng, void* rng_state)
 {
-	size_t n, i;
+	size_t n, i, j;
 	void* state;
-	word* f;
+	word* f0;
+	word* m;
+	word* mu;
 	word* k;
 	word* c;
+	word* r;
 	void* stack;
 	// проверить генератор
 	if (rng == 0)
@@ -283,48 +364,71 @@ err_t belsShare(octet si[], size_t count, size_t threshold, size_t len,
 	// проверить входные данные
 	if ((len != 16 && len != 24 && len != 32) || 
 		threshold == 0 || count < threshold ||
-		!memIsValid(s, len) || !memIsValid(m0, len) || 
-		!memIsValid(mi, len * count) || !memIsValid(si, len * count))
+		batch == 0 || count > SIZE_MAX / len / batch ||
+		count > SIZE_MAX / 8 / len ||
+		!memIsValid(s, len * batch) || !memIsValid(m0, len) || 
+		!memIsValid(mi, len * count) || 
+		!memIsValid(si, len * count * batch))
 		return ERR_BAD_INPUT;
 	EXPECT(belsValM(m0, len) == ERR_OK);
 	// создать состояние
 	n = W_OF_O(len);
-	state = blobCreate(O_OF_W(2 * threshold * n + 1) + 
+	state = blobCreate(
+		O_OF_W(n + count * n + count + 3 * threshold * n - n) + 
 		utilMax(2, 
 			ppMul_deep(threshold * n - n, n),
-			ppMod_deep(threshold * n, n + 1)));
+			belsMod_deep(n)));
 	if (state == 0)
 		return ERR_OUTOFMEMORY;
 	// раскладка состояния
-	f = (word*)state;
-	k = f + n + 1;
+	f0 = (word*)state;
+	m = f0 + n;
+	mu = m + count * n;
+	k = mu + count;
 	c = k + threshold * n - n;
-	stack = c + threshold * n;
-	// сгенерировать k
-	rng(k, threshold * len - len, rng_state);
-	wwFrom(k, k, threshold * len - len);
-	// c(x) <- (x^l + m0(x))k(x) + s(x)
-	wwFrom(f, m0, len);
-	ppMul(c, k, threshold * n - n, f, n, stack);
-	wwXor2(c + n, k, threshold * n - n);
-	wwFrom(f, s, len);
-	wwXor2(c, f, n);
-	// цикл по пользователям
+	r = c + threshold * n;
+	stack = r + threshold * n;
+	// загрузить открытые ключи
+	wwFrom(f0, m0, len);
 	for (i = 0; i < count; ++i)
 	{
-		// f(x) <- x^l + mi(x)
 		EXPECT(belsValM(mi + i * len, len) == ERR_OK);
-		wwFrom(f, mi + i * len, len);
-		f[n] = 1;
-		// si(x) <- c(x) mod f(x)
-		ppMod(f, c, threshold * n, f, n + 1, stack);
-		wwTo(si + i * len, len, f);
+		wwFrom(m + i * n, mi + i * len, len);
+		mu[i] = belsModMu(m[i * n + n - 1]);
+	}
+	// цикл по секретам
+	for (j = 0; j < batch; ++j)
+	{
+		// сгенерировать k
+		rng(k, threshold * len - len, rng_state);
+		wwFrom(k, k, threshold * len - len);
+		// c(x) <- (x^l + m0(x))k(x) + s(x)
+		ppMul(c, k, threshold * n - n, f0, n, stack);
+		wwXor2(c + n, k, threshold * n - n);
+		wwFrom(r, s + j * len, len);
+		wwXor2(c, r, n);
+		// цикл по пользователям
+		for (i = 0; i < count; ++i)
+		{
+			// si(x) <- c(x) mod (x^l + mi(x))
+			wwCopy(r, c, threshold * n);
+			belsMod(r, threshold * n, m + i * n, n, mu[i], stack);
+			wwTo(si + (j * count + i) * len, len, r);
+		}
 	}
 	// завершение
 	blobClose(state);
 	return ERR_OK;
 }
 
+err_t belsShare(octet si[], size_t count, size_t threshold, size_t len, 
+	const octet s[], const octet m0[], const octet mi[], 
+	gen_i rng, void* rng_state)
+{
+	return belsBatchShare(si, 1, count, threshold, len, s, m0, mi, 
+		rng, rng_state);
+}
+
 err_t belsShare2(octet si[], size_t count, size_t threshold, size_t len, 
 	const octet s[])
 {
@@ -335,6 +439,7 @@ err_t belsShare2(octet si[], size_t count, size_t threshold, size_t len,
 	octet* iv;
 	word* k;
 	word* c;
+	word* r;
 	void* stack;
 	// проверить входные данные
 	if ((len != 16 && len != 24 && len != 32) || 
@@ -343,20 +448,21 @@ err_t belsShare2(octet si[], size_t count, size_t threshold, size_t len,
 		return ERR_BAD_INPUT;
 	// создать состояние
 	n = W_OF_O(len);
-	state = blobCreate(O_OF_W(2 * threshold * n + 1) + 
+	state = blobCreate(O_OF_W(3 * threshold * n) + 
 		utilMax(4,
 			beltCTR_keep(),
 			32 + beltCompr_deep(),
 			ppMul_deep(threshold * n - n, n),
-			ppMod_deep(threshold * n, n + 1)));
+			O_OF_B(len) + belsMod_deep(n)));
 	if (state == 0)
 		return ERR_OUTOFMEMORY;
 	// раскладка состояния
 	f = (word*)state;
 	iv = (octet*)state;
-	k = f + n + 1;
+	k = f + n;
 	c = k + threshold * n - n;
-	stack = c + threshold * n;
+	r = c + threshold * n;
+	stack = r + threshold * n;
 	K = (u32*)stack;
 	// K <- belt-keyexpand(s)
 	beltKeyExpand2(K, s, len);
@@ -384,13 +490,14 @@ err_t belsShare2(octet si[], size_t count, size_t threshold, size_t len,
 	// цикл по пользователям
 	for (i = 0; i < count; ++i)
 	{
-		// f(x) <- x^l + mi(x)
+		// f(x) <- mi(x)
 		belsStdM(stack, len, i + 1);
 		wwFrom(f, stack, len);
-		f[n] = 1;
-		// si(x) <- c(x) mod f(x)
-		ppMod(f, c, threshold * n, f, n + 1, stack);
-		wwTo(si + i * len, len, f);
+		// si(x) <- c(x) mod (x^l + mi(x))
+		wwCopy(r, c, threshold * n);
+		belsMod(r, threshold * n, f, n, belsModMu(f[n - 1]), 
+			(octet*)stack + len);
+		wwTo(si + i * len, len, r);
 	}
 	// завершение
 	blobClose(state);
@@ -429,7 +536,7 @@ err_t belsRecover(octet s[], size_t count, size_t len, const octet si[],
 	n = W_OF_O(len);
 	deep = utilMax(2, 
 		ppMul_deep(n, n), 
-		ppMod_deep(count * n, n + 1));
+		belsMod_deep(n));
 	for (i = 1; i < count; ++i)
 		deep = utilMax(6, 
 			deep, 
@@ -501,11 +608,169 @@ err_t belsRecover(octet s[], size_t count, size_t len, const octet si[],
 		ASSERT(c[(i + 1) * n] == 0);
 	}
 	// [n]s(x) <- c(x) mod (x^l + m0(x))
-	wwFrom(f, m0, len), f[n] = 1;
-	ppMod(c, c, count * n, f, n + 1, stack);
-	ASSERT(c[n] == 0);
+	wwFrom(f, m0, len);
+	belsMod(c, count * n, f, n, belsModMu(f[n - 1]), stack);
 	wwTo(s, len, c);
 	// завершение
 	blobClose(state);
 	return ERR_OK;
 }
+
+/*
+*******************************************************************************
+Подготовленное восстановление
+
+Пусть f_i(x) = x^l + m_i(x), i = 1, 2,..., k, -- многочлены участников, 
+g(x) = f_1(x) f_2(x)... f_k(x), f0(x) = x^l + m0(x). В belsRecover() по 
+частичным секретам s_i(x) строится многочлен c(x), deg c < deg g, такой, что 
+c(x) = s_i(x) mod f_i(x), а затем определяется секрет s(x) = c(x) mod f0(x). 
+По китайской теореме об остатках
+	c(x) = (s_1(x) e_1(x) + ... + s_k(x) e_k(x)) mod g(x),
+где e_i(x) = (g(x) / f_i(x)) ((g(x) / f_i(x))^{-1} mod f_i(x)) -- базис 
+Лагранжа. Поэтому s(x) является GF(2)-линейной функцией битов s_i(x):
+	s(x) = \sum_i \sum_j s_{ij} r_{ij}(x),	
+	r_{ij}(x) = (x^j e_i(x) mod g(x)) mod f0(x),
+где s_{ij} -- j-й бит s_i(x), 0 <= j < l.
+
+В функции belsRecStart() многочлены r_{ij}(x) рассчитываются и сохраняются 
+в объекте восстановления: k l многочленов по n слов. В функции belsRecStep() 
+секрет получается сложением многочленов r_{ij}(x), отобранных битами 
+частичных секретов. Отбор выполняется с помощью масок, без ветвлений.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	size_t count;		/*< число участников */
+	size_t len;			/*< длина секретов в октетах */
+	word r[];			/*< многочлены r_{ij}(x) [count * len * 8 * n] */
+} bels_rec_st;
+
+size_t belsRec_keep(size_t count, size_t len)
+{
+	return sizeof(bels_rec_st) + O_OF_W(count * len * 8 * W_OF_O(len));
+}
+
+err_t belsRecStart(void* rec, size_t count, size_t len, const octet m0[], 
+	const octet mi[])
+{
+	bels_rec_st* st = (bels_rec_st*)rec;
+	size_t n, i, j;
+	err_t code = ERR_OK;
+	void* state;
+	word* f;
+	word* g;
+	word* t;
+	word* q;
+	word* h;
+	word* v;
+	word* e;
+	word* m;
+	word mu;
+	void* stack;
+	// проверить входные данные
+	if ((len != 16 && len != 24 && len != 32) || count == 0 || 
+		!memIsValid(m0, len) || !memIsValid(mi, len * count) || 
+		!memIsValid(rec, belsRec_keep(count, len)))
+		return ERR_BAD_INPUT;
+	EXPECT(belsValM(m0, len) == ERR_OK);
+	// создать состояние
+	n = W_OF_O(len);
+	state = blobCreate(
+		O_OF_W(3 * (n + 1) + 3 * (count * n + 2) + count * n - n + 1 + n) +
+		utilMax(6,
+			ppMul_deep(count * n + 1, n + 1),
+			ppDiv_deep(count * n + 1, n + 1),
+			ppMod_deep(count * n - n + 1, n + 1),
+			ppInvMod_deep(n + 1),
+			ppMul_deep(count * n - n + 1, n + 1),
+			belsMod_deep(n)));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// раскладка состояния
+	f = (word*)state;
+	g = f + n + 1;
+	t = g + count * n + 2;
+	q = t + count * n + 2;
+	h = q + count * n - n + 1;
+	v = h + n + 1;
+	e = v + n + 1;
+	m = e + count * n + 2;
+	stack = m + n;
+	// [count * n + 1]g(x) <- f_1(x) f_2(x)... f_k(x)
+	wwSetW(g, count * n + 1, 1);
+	for (f[n] = 1, i = 0; i < count; ++i)
+	{
+		wwFrom(f, mi + i * len, len);
+		ppMul(t, g, i * n + 1, f, n + 1, stack);
+		wwCopy(g, t, (i + 1) * n + 1);
+	}
+	// загрузить m0(x)
+	wwFrom(m, m0, len);
+	mu = belsModMu(m[n - 1]);
+	// цикл по участникам
+	st->count = count, st->len = len;
+	for (i = 0; i < count; ++i)
+	{
+		// [count * n - n + 1]q(x) <- g(x) / f_i(x)
+		wwFrom(f, mi + i * len, len);
+		ppDiv(q, h, g, count * n + 1, f, n + 1, stack);
+		// [n + 1]v(x) <- q(x)^{-1} mod f_i(x)
+		ppMod(h, q, count * n - n + 1, f, n + 1, stack);
+		ppInvMod(v, h, f, n + 1, stack);
+		if (wwIsZero(v, n + 1))
+		{
+			code = ERR_BAD_PUBKEY;
+			break;
+		}
+		// [count * n + 1]e(x) <- q(x) v(x)
+		ppMul(e, q, count * n - n + 1, v, n, stack);
+		ASSERT(e[count * n] == 0);
+		// цикл по битам
+		for (j = 0; j < len * 8; ++j)
+		{
+			word* r = st->r + (i * len * 8 + j) * n;
+			// r_{ij}(x) <- e(x) mod f0(x)
+			wwCopy(t, e, count * n);
+			belsMod(t, count * n, m, n, mu, stack);
+			wwCopy(r, t, n);
+			// e(x) <- x e(x) mod g(x)
+			wwShHi(e, count * n + 1, 1);
+			if (e[count * n])
+				wwXor2(e, g, count * n + 1);
+		}
+	}
+	// завершение
+	blobClose(state);
+	return code;
+}
+
+err_t belsRecStep(octet s[], const octet si[], const void* rec)
+{
+	const bels_rec_st* st = (const bels_rec_st*)rec;
+	const word* r;
+	size_t n, i, j, k, l;
+	word acc[W_OF_O(32)];
+	register word mask;
+	// проверить входные данные
+	if (!memIsValid(st, sizeof(bels_rec_st)) ||
+		(st->len != 16 && st->len != 24 && st->len != 32) || 
+		!memIsValid(rec, belsRec_keep(st->count, st->len)) ||
+		!memIsValid(si, st->count * st->len) || !memIsValid(s, st->len))
+		return ERR_BAD_INPUT;
+	// acc <- \sum_i \sum_j s_{ij} r_{ij}
+	n = W_OF_O(st->len);
+	wwSetZero(acc, n);
+	for (r = st->r, i = 0; i < st->count; ++i)
+		for (j = 0; j < st->len; ++j)
+			for (k = 0; k < 8; ++k, r += n)
+			{
+				mask = WORD_0 - (word)(si[i * st->len + j] >> k & 1);
+				for (l = 0; l < n; ++l)
+					acc[l] ^= r[l] & mask;
+			}
+	mask = 0;
+	wwTo(s, st->len, acc);
+	wwSetZero(acc, n);
+	return ERR_OK;
+}
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.27
-\version 2021.01.29
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -15,6 +15,8 @@ version 3. See Copyright Notices in bee2/info.h.
 #include "bee2/core/err.h"
 #include "bee2/core/der.h"
 #include "bee2/core/mem.h"
+#include "bee2/core/mt.h"
+#include "bee2/core/obj.h"
 #include "bee2/core/oid.h"
 #include "bee2/core/str.h"
 #include "bee2/core/util.h"
@@ -300,6 +302,70 @@ size_t bignStart_keep(size_t l, bign_deep_i deep)
 			deep ? deep(n, f_deep, ec_d, ec_deep) : 0);
 }
 
+/*
+*******************************************************************************
+Контекст
+
+Контекст -- это описание эллиптической кривой, построенное функцией 
+bignStart(). Контекстные функции не изменяют контекст и размещают 
+локальные переменные в стеке, который передает вызывающая сторона.
+*******************************************************************************
+*/
+
+size_t bignCtx_keep(size_t l)
+{
+	ASSERT(l == 128 || l == 192 || l == 256);
+	return bignStart_keep(l, 0);
+}
+
+err_t bignCtxStart(void* ctx, const bign_params* params)
+{
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// проверить ctx
+	if (!memIsValid(ctx, bignCtx_keep(params->l)))
+		return ERR_BAD_INPUT;
+	// создать описание кривой
+	return bignStart(ctx, params);
+}
+
+static bool_t bignCtxIsOperable(const void* ctx)
+{
+	const ec_o* ec = (const ec_o*)ctx;
+	return ecIsOperable(ec) &&
+		ecIsOperableGroup(ec) &&
+		(ec->f->no == 32 || ec->f->no == 48 || ec->f->no == 64);
+}
+
+/*
+*******************************************************************************
+Выбор редакций
+
+Функции без контекста, которые обрабатывают секретные данные (личные ключи,
+одноразовые ключи), переключают базовое поле на регулярные редакции 
+функций. Функции проверки (bignValParams(), bignValPubkey(), bignVerify(), 
+bignIdVerify()) обрабатывают только открытые данные и переключают поле на 
+ускоренные редакции.
+*******************************************************************************
+*/
+
+static void bignSetSafe(void* state, bool_t safe)
+{
+	ec_o* ec = (ec_o*)state;
+	zmSetSafe((qr_o*)ec->f, safe);
+}
+
+err_t bignCtxSetSafe(void* ctx, bool_t safe)
+{
+	if (!bignCtxIsOperable(ctx))
+		return ERR_BAD_INPUT;
+	bignSetSafe(ctx, safe);
+	return ERR_OK;
+}
+
 /*
 *******************************************************************************
 Проверка параметров
@@ -330,7 +396,7 @@ static size_t bignValParams_deep(size_t n, size_t f_deep, size_t ec_d,
 			ecpIsValid_deep(n, f_deep),
 			ecpIsSafeGroup_deep(n),
 			ecpIsOnA_deep(n, f_deep),
-			qrPower_deep(n, n, f_deep),
+			zmPowerSqrt_deep(n, f_deep),
 			ecHasOrderA_deep(n, ec_d, ec_deep, n));
 }
 
@@ -357,6 +423,8 @@ err_t bignValParams(const bign_params* params)
 	// старт
 	code = bignStart(state, params);
 	ERR_CALL_HANDLE(code, blobClose(state));
+	// открытые данные: ускоренные редакции
+	bignSetSafe(state, FALSE);
 	ec = (ec_o*)state;
 	// размерности
 	no  = ec->f->no;
@@ -395,11 +463,9 @@ err_t bignValParams(const bign_params* params)
 		ecpIsSafeGroup(ec, 50, stack) &&
 		zzJacobi(ec->B, n, ec->f->mod, n, stack) == 1)
 	{
-		// B <- b^{(p + 1) / 4} = \sqrt{b} mod p
-		wwCopy(B, ec->f->mod, n);
-		zzAddW2(B, n, 1);
-		wwShLo(B, n, 2);
-		qrPower(B, ec->B, B, n, ec->f, stack);
+		// B <- b^{(p + 1) / 4} = b^{(p - 3) / 4} b = \sqrt{b} mod p
+		zmPowerSqrt(B, ec->B, ec->f, stack);
+		qrMul(B, B, ec->B, ec->f, stack);
 		// оставшиеся условия
 		if (!wwEq(B, ecY(ec->base, n), n) ||
 			!ecHasOrderA(ec->base, ec, ec->order, n, stack))
@@ -451,62 +517,70 @@ static size_t bignGenKeypair_deep(size_t n, size_t f_deep, size_t ec_d,
 		ecMulA_deep(n, ec_d, ec_deep, n);
 }
 
-err_t bignGenKeypair(octet privkey[], octet pubkey[],
-	const bign_params* params, gen_i rng, void* rng_state)
+err_t bignCtxGenKeypair(octet privkey[], octet pubkey[], const void* ctx,
+	gen_i rng, void* rng_state, void* stack)
 {
-	err_t code;
 	size_t no, n;
 	// состояние
-	void* state;
-	ec_o* ec;				/* описание эллиптической кривой */
+	const ec_o* ec;			/* описание эллиптической кривой */
 	word* d;				/* [n] личный ключ */
 	word* Q;				/* [2n] открытый ключ */
-	void* stack;
-	// проверить params
-	if (!memIsValid(params, sizeof(bign_params)))
+	// проверить ctx
+	if (!bignCtxIsOperable(ctx))
 		return ERR_BAD_INPUT;
-	if (params->l != 128 && params->l != 192 && params->l != 256)
-		return ERR_BAD_PARAMS;
+	ec = (const ec_o*)ctx;
 	// проверить rng
 	if (rng == 0)
 		return ERR_BAD_RNG;
-	// создать состояние
-	state = blobCreate(bignStart_keep(params->l, bignGenKeypair_deep));
-	if (state == 0)
-		return ERR_OUTOFMEMORY;
-	// старт
-	code = bignStart(state, params);
-	ERR_CALL_HANDLE(code, blobClose(state));
-	ec = (ec_o*)state;
 	// размерности
 	no  = ec->f->no;
 	n = ec->f->n;
 	// проверить входные указатели
 	if (!memIsValid(privkey, no) || !memIsValid(pubkey, 2 * no))
-	{
-		blobClose(state);
 		return ERR_BAD_INPUT;
-	}
-	// раскладка состояния
-	d = objEnd(ec, word);
+	// раскладка стека
+	d = (word*)stack;
 	Q = d + n;
 	stack = Q + 2 * n;
 	// d <-R {1,2,..., q - 1}
 	if (!zzRandNZMod(d, ec->f->mod, n, rng, rng_state))
-	{
-		blobClose(state);
 		return ERR_BAD_RNG;
-	}
 	// Q <- d G
-	if (ecMulA(Q, ec->base, ec, d, n, stack))
-	{
-		// выгрузить ключи
-		wwTo(privkey, no, d);
-		qrTo(pubkey, ecX(Q), ec->f, stack);
-		qrTo(pubkey + no, ecY(Q, n), ec->f, stack);
-	}
-	else
-		code = ERR_BAD_PARAMS;
+	if (!ecMulA(Q, ec->base, ec, d, n, stack))
+		return ERR_BAD_PARAMS;
+	// выгрузить ключи
+	wwTo(privkey, no, d);
+	qrTo(pubkey, ecX(Q), ec->f, stack);
+	qrTo(pubkey + no, ecY(Q, n), ec->f, stack);
+	// все нормально
+	return ERR_OK;
+}
+
+err_t bignGenKeypair(octet privkey[], octet pubkey[],
+	const bign_params* params, gen_i rng, void* rng_state)
+{
+	err_t code;
+	void* state;
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// проверить rng
+	if (rng == 0)
+		return ERR_BAD_RNG;
+	// создать состояние
+	state = blobCreate(bignStart_keep(params->l, bignGenKeypair_deep));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// старт
+	code = bignStart(state, params);
+	ERR_CALL_HANDLE(code, blobClose(state));
+	// секретные данные: регулярные редакции
+	bignSetSafe(state, TRUE);
+	// основные действия
+	code = bignCtxGenKeypair(privkey, pubkey, state, rng, rng_state,
+		objEnd(state, void));
 	// завершение
 	blobClose(state);
 	return code;
@@ -542,6 +616,8 @@ err_t bignValKeypair(const bign_params* params, const octet privkey[],
 	// старт
 	code = bignStart(state, params);
 	ERR_CALL_HANDLE(code, blobClose(state));
+	// секретные данные: регулярные редакции
+	bignSetSafe(state, TRUE);
 	ec = (ec_o*)state;
 	// размерности
 	no = ec->f->no;
@@ -608,6 +684,8 @@ err_t bignValPubkey(const bign_params* params, const octet pubkey[])
 	// старт
 	code = bignStart(state, params);
 	ERR_CALL_HANDLE(code, blobClose(state));
+	// открытые данные: ускоренные редакции
+	bignSetSafe(state, FALSE);
 	ec = (ec_o*)state;
 	// размерности
 	no  = ec->f->no;
@@ -642,59 +720,63 @@ static size_t bignCalcPubkey_deep(size_t n, size_t f_deep, size_t ec_d,
 		ecMulA_deep(n, ec_d, ec_deep, n);
 }
 
-err_t bignCalcPubkey(octet pubkey[], const bign_params* params,
-	const octet privkey[])
+err_t bignCtxCalcPubkey(octet pubkey[], const void* ctx,
+	const octet privkey[], void* stack)
 {
-	err_t code;
 	size_t no, n;
 	// состояние
-	void* state;
-	ec_o* ec;				/* описание эллиптической кривой */
+	const ec_o* ec;			/* описание эллиптической кривой */
 	word* d;				/* [n] личный ключ */
 	word* Q;				/* [2n] открытый ключ */
-	void* stack;
-	// проверить params
-	if (!memIsValid(params, sizeof(bign_params)))
+	// проверить ctx
+	if (!bignCtxIsOperable(ctx))
 		return ERR_BAD_INPUT;
-	if (params->l != 128 && params->l != 192 && params->l != 256)
-		return ERR_BAD_PARAMS;
-	// создать состояние
-	state = blobCreate(bignStart_keep(params->l, bignCalcPubkey_deep));
-	if (state == 0)
-		return ERR_OUTOFMEMORY;
-	// старт
-	code = bignStart(state, params);
-	ERR_CALL_HANDLE(code, blobClose(state));
-	ec = (ec_o*)state;
+	ec = (const ec_o*)ctx;
 	// размерности
 	no  = ec->f->no;
 	n = ec->f->n;
 	// проверить входные указатели
 	if (!memIsValid(privkey, no) || !memIsValid(pubkey, 2 * no))
-	{
-		blobClose(state);
 		return ERR_BAD_INPUT;
-	}
-	// раскладка состояния
-	d = objEnd(ec, word);
+	// раскладка стека
+	d = (word*)stack;
 	Q = d + n;
 	stack = Q + 2 * n;
 	// загрузить d
 	wwFrom(d, privkey, no);
 	if (wwIsZero(d, n) || wwCmp(d, ec->order, n) >= 0)
-	{
-		blobClose(state);
 		return ERR_BAD_PRIVKEY;
-	}
 	// Q <- d G
-	if (ecMulA(Q, ec->base, ec, d, n, stack))
-	{
-		// выгрузить открытый ключ
-		qrTo(pubkey, ecX(Q), ec->f, stack);
-		qrTo(pubkey + no, ecY(Q, n), ec->f, stack);
-	}
-	else
-		code = ERR_BAD_PARAMS;
+	if (!ecMulA(Q, ec->base, ec, d, n, stack))
+		return ERR_BAD_PARAMS;
+	// выгрузить открытый ключ
+	qrTo(pubkey, ecX(Q), ec->f, stack);
+	qrTo(pubkey + no, ecY(Q, n), ec->f, stack);
+	// все нормально
+	return ERR_OK;
+}
+
+err_t bignCalcPubkey(octet pubkey[], const bign_params* params,
+	const octet privkey[])
+{
+	err_t code;
+	void* state;
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// создать состояние
+	state = blobCreate(bignStart_keep(params->l, bignCalcPubkey_deep));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// старт
+	code = bignStart(state, params);
+	ERR_CALL_HANDLE(code, blobClose(state));
+	// секретные данные: регулярные редакции
+	bignSetSafe(state, TRUE);
+	// основные действия
+	code = bignCtxCalcPubkey(pubkey, state, privkey, objEnd(state, void));
 	// завершение
 	blobClose(state);
 	return code;
@@ -709,77 +791,76 @@ static size_t bignDH_deep(size_t n, size_t f_deep, size_t ec_d,
 			ecMulA_deep(n, ec_d, ec_deep, n));
 }
 
-err_t bignDH(octet key[], const bign_params* params, const octet privkey[],
-	const octet pubkey[], size_t key_len)
+err_t bignCtxDH(octet key[], const void* ctx, const octet privkey[],
+	const octet pubkey[], size_t key_len, void* stack)
 {
-	err_t code;
 	size_t no, n;
 	// состояние
-	void* state;
-	ec_o* ec;				/* описание эллиптической кривой */
+	const ec_o* ec;			/* описание эллиптической кривой */
 	word* d;				/* [n] личный ключ */
 	word* Q;				/* [2n] открытый ключ */
-	void* stack;
-	// проверить params
-	if (!memIsValid(params, sizeof(bign_params)))
+	// проверить ctx
+	if (!bignCtxIsOperable(ctx))
 		return ERR_BAD_INPUT;
-	if (params->l != 128 && params->l != 192 && params->l != 256)
-		return ERR_BAD_PARAMS;
-	// создать состояние
-	state = blobCreate(bignStart_keep(params->l, bignDH_deep));
-	if (state == 0)
-		return ERR_OUTOFMEMORY;
-	// старт
-	code = bignStart(state, params);
-	ERR_CALL_HANDLE(code, blobClose(state));
-	ec = (ec_o*)state;
+	ec = (const ec_o*)ctx;
 	// размерности
 	no  = ec->f->no;
 	n = ec->f->n;
 	// проверить длину key
 	if (key_len > 2 * no)
-	{
-		blobClose(state);
 		return ERR_BAD_SHAREKEY;
-	}
 	// проверить входные указатели
 	if (!memIsValid(privkey, no) || 
 		!memIsValid(pubkey, 2 * no) ||
 		!memIsValid(key, key_len))
-	{
-		blobClose(state);
 		return ERR_BAD_INPUT;
-	}
-	// раскладка состояния
-	d = objEnd(ec, word);
+	// раскладка стека
+	d = (word*)stack;
 	Q = d + n;
 	stack = Q + 2 * n;
 	// загрузить d
 	wwFrom(d, privkey, no);
 	if (wwIsZero(d, n) || wwCmp(d, ec->order, n) >= 0)
-	{
-		blobClose(state);
 		return ERR_BAD_PRIVKEY;
-	}
 	// загрузить Q
 	if (!qrFrom(ecX(Q), pubkey, ec->f, stack) ||
 		!qrFrom(ecY(Q, n), pubkey + no, ec->f, stack) ||
 		!ecpIsOnA(Q, ec, stack))
-	{
-		blobClose(state);
 		return ERR_BAD_PUBKEY;
-	}
 	// Q <- d Q
-	if (ecMulA(Q, Q, ec, d, n, stack))
-	{
-		// выгрузить общий ключ
-		qrTo((octet*)Q, ecX(Q), ec->f, stack);
-		if (key_len > no)
-			qrTo((octet*)Q + no, ecY(Q, n), ec->f, stack);
-		memCopy(key, Q, key_len);
-	}
-	else
-		code = ERR_BAD_PARAMS;
+	if (!ecMulA(Q, Q, ec, d, n, stack))
+		return ERR_BAD_PARAMS;
+	// выгрузить общий ключ
+	qrTo((octet*)Q, ecX(Q), ec->f, stack);
+	if (key_len > no)
+		qrTo((octet*)Q + no, ecY(Q, n), ec->f, stack);
+	memCopy(key, Q, key_len);
+	// все нормально
+	return ERR_OK;
+}
+
+err_t bignDH(octet key[], const bign_params* params, const octet privkey[],
+	const octet pubkey[], size_t key_len)
+{
+	err_t code;
+	void* state;
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// создать состояние
+	state = blobCreate(bignStart_keep(params->l, bignDH_deep));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// старт
+	code = bignStart(state, params);
+	ERR_CALL_HANDLE(code, blobClose(state));
+	// секретные данные: регулярные редакции
+	bignSetSafe(state, TRUE);
+	// основные действия
+	code = bignCtxDH(key, state, privkey, pubkey, key_len, 
+		objEnd(state, void));
 	// завершение
 	blobClose(state);
 	return code;
@@ -787,74 +868,167 @@ err_t bignDH(octet key[], const bign_params* params, const octet privkey[],
 
 /*
 *******************************************************************************
-Выработка ЭЦП
+Пакетная обработка
+
+Кратные точки рассчитываются в проективных координатах, а затем 
+одновременно переводятся в аффинные координаты с помощью функции ecToAN(). 
+При переводе обращения в базовом поле объединяются (трюк Монтгомери).
+
+Точки обрабатываются блоками из BIGN_BATCH элементов. Тем самым 
+ограничивается объем памяти, а обращение выполняется один раз для блока.
 *******************************************************************************
 */
 
-static size_t bignSign_deep(size_t n, size_t f_deep, size_t ec_d,
+#define BIGN_BATCH 256
+
+static size_t bignBatchGenKeypair_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
-	return O_OF_W(4 * n) +
-		utilMax(4,
-			beltHash_keep(),
-			ecMulA_deep(n, ec_d, ec_deep, n),
-			zzMul_deep(n / 2, n),
-			zzMod_deep(n + n / 2 + 1, n));
+	return O_OF_W(n + BIGN_BATCH * (ec_d * n + 2 * n)) +
+		ecMul_deep(n, ec_d, ec_deep, n);
 }
 
-err_t bignSign(octet sig[], const bign_params* params, const octet oid_der[],
-	size_t oid_len, const octet hash[], const octet privkey[], gen_i rng, 
-	void* rng_state)
+err_t bignBatchGenKeypair(octet privkeys[], octet pubkeys[], size_t count,
+	const bign_params* params, gen_i rng, void* rng_state)
 {
 	err_t code;
 	size_t no, n;
-	// состояние (буферы могут пересекаться)
-	void* state;			
+	size_t i, j;
+	// состояние
+	void* state;
 	ec_o* ec;				/* описание эллиптической кривой */
 	word* d;				/* [n] личный ключ */
-	word* k;				/* [n] одноразовый личный ключ */
-	word* R;				/* [2n] точка R */
-	word* s0;				/* [n/2] первая часть подписи */
-	word* s1;				/* [n] вторая часть подписи */
-	octet* stack;
+	word* P;				/* [BIGN_BATCH * 3n] открытые ключи */
+	word* Q;				/* [BIGN_BATCH * 2n] открытые ключи */
+	void* stack;
 	// проверить params
 	if (!memIsValid(params, sizeof(bign_params)))
 		return ERR_BAD_INPUT;
 	if (params->l != 128 && params->l != 192 && params->l != 256)
 		return ERR_BAD_PARAMS;
-	// проверить oid_der
-	if (oid_len == SIZE_MAX || oidFromDER(0, oid_der, oid_len)  == SIZE_MAX)
-		return ERR_BAD_OID;
 	// проверить rng
 	if (rng == 0)
 		return ERR_BAD_RNG;
+	// проверить входные указатели
+	no = O_OF_B(2 * params->l);
+	if (count > SIZE_MAX / 2 / no ||
+		!memIsValid(privkeys, count * no) || 
+		!memIsValid(pubkeys, count * 2 * no))
+		return ERR_BAD_INPUT;
 	// создать состояние
-	state = blobCreate(bignStart_keep(params->l, bignSign_deep));
+	state = blobCreate(bignStart_keep(params->l, bignBatchGenKeypair_deep));
 	if (state == 0)
 		return ERR_OUTOFMEMORY;
 	// старт
 	code = bignStart(state, params);
 	ERR_CALL_HANDLE(code, blobClose(state));
+	// секретные данные: регулярные редакции
+	bignSetSafe(state, TRUE);
 	ec = (ec_o*)state;
-	// размерности
-	no  = ec->f->no;
 	n = ec->f->n;
-	ASSERT(n % 2 == 0);
-	// проверить входные указатели
-	if (!memIsValid(hash, no) ||
-		!memIsValid(privkey, no) ||
-		!memIsValid(sig, no + no / 2) ||
-		!memIsDisjoint2(hash, no, sig, no + no / 2))
+	ASSERT(ec->toan != 0);
+	// раскладка состояния
+	d = objEnd(ec, word);
+	P = d + n;
+	Q = P + BIGN_BATCH * 3 * n;
+	stack = Q + BIGN_BATCH * 2 * n;
+	// обработать блоки
+	for (i = 0; i < count; i += j)
+	{
+		// P_j <- d_j G
+		for (j = 0; j < BIGN_BATCH && i + j < count; ++j)
+		{
+			if (!zzRandNZMod(d, ec->order, n, rng, rng_state))
+			{
+				code = ERR_BAD_RNG;
+				break;
+			}
+			ecMul(P + 3 * n * j, ec->base, ec, d, n, stack);
+			wwTo(privkeys + (i + j) * no, no, d);
+		}
+		if (code != ERR_OK)
+			break;
+		// Q_j <- P_j
+		if (!ecToAN(Q, P, j, ec, stack))
+		{
+			code = ERR_BAD_PARAMS;
+			break;
+		}
+		// выгрузить открытые ключи
+		for (j = 0; j < BIGN_BATCH && i + j < count; ++j)
+		{
+			qrTo(pubkeys + (i + j) * 2 * no, ecX(Q + 2 * n * j), ec->f, 
+				stack);
+			qrTo(pubkeys + (i + j) * 2 * no + no, ecY(Q + 2 * n * j, n), 
+				ec->f, stack);
+		}
+	}
+	// очистить выходные данные при ошибке
+	if (code != ERR_OK)
 	{
-		blobClose(state);
-		return ERR_BAD_INPUT;
+		memWipe(privkeys, count * no);
+		memWipe(pubkeys, count * 2 * no);
 	}
-	// раскладка состояния
-	d = s1 = objEnd(ec, word);
-	k = d + n;
-	R = k + n;
-	s0 = R + n + n / 2;
-	stack = (octet*)(R + 2 * n);
+	// завершение
+	blobClose(state);
+	return code;
+}
+
+static size_t bignBatchDH_deep(size_t n, size_t f_deep, size_t ec_d,
+	size_t ec_deep)
+{
+	return O_OF_W(n + BIGN_BATCH * (ec_d * n + 2 * n)) +
+		utilMax(2,
+			ecpIsOnA_deep(n, f_deep),
+			ecMulN_deep(n, ec_d, ec_deep, n));
+}
+
+err_t bignBatchDH(octet keys[], const bign_params* params, 
+	const octet privkey[], const octet pubkeys[], size_t count, 
+	size_t key_len)
+{
+	err_t code;
+	size_t no, n;
+	size_t i, j;
+	// состояние
+	void* state;
+	ec_o* ec;				/* описание эллиптической кривой */
+	word* d;				/* [n] личный ключ */
+	word* Q;				/* [BIGN_BATCH * 2n] открытые / общие ключи */
+	word* P;				/* [BIGN_BATCH * 3n] общие ключи */
+	void* stack;
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// проверить длину key
+	no = O_OF_B(2 * params->l);
+	if (key_len > 2 * no)
+		return ERR_BAD_SHAREKEY;
+	// проверить входные указатели
+	if (count > SIZE_MAX / 2 / no ||
+		!memIsValid(privkey, no) || 
+		!memIsValid(pubkeys, count * 2 * no) ||
+		!memIsValid(keys, count * key_len))
+		return ERR_BAD_INPUT;
+	// создать состояние
+	state = blobCreate(bignStart_keep(params->l, bignBatchDH_deep));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// старт
+	code = bignStart(state, params);
+	ERR_CALL_HANDLE(code, blobClose(state));
+	// секретные данные: регулярные редакции
+	bignSetSafe(state, TRUE);
+	ec = (ec_o*)state;
+	n = ec->f->n;
+	ASSERT(ec->toan != 0);
+	// раскладка состояния
+	d = objEnd(ec, word);
+	Q = d + n;
+	P = Q + BIGN_BATCH * 2 * n;
+	stack = P + BIGN_BATCH * 3 * n;
 	// загрузить d
 	wwFrom(d, privkey, no);
 	if (wwIsZero(d, n) || wwCmp(d, ec->order, n) >= 0)
@@ -862,18 +1036,115 @@ err_t bignSign(octet sig[], const bign_params* params, const octet oid_der[],
 		blobClose(state);
 		return ERR_BAD_PRIVKEY;
 	}
+	// обработать блоки
+	for (i = 0; i < count; i += j)
+	{
+		// загрузить Q_j
+		for (j = 0; j < BIGN_BATCH && i + j < count; ++j)
+		{
+			const octet* pubkey = pubkeys + (i + j) * 2 * no;
+			word* Qj = Q + 2 * n * j;
+			if (!qrFrom(ecX(Qj), pubkey, ec->f, stack) ||
+				!qrFrom(ecY(Qj, n), pubkey + no, ec->f, stack) ||
+				!ecpIsOnA(Qj, ec, stack))
+			{
+				code = ERR_BAD_PUBKEY;
+				break;
+			}
+		}
+		if (code != ERR_OK)
+			break;
+		// P_j <- d Q_j
+		ecMulN(P, Q, j, ec, d, n, stack);
+		// Q_j <- P_j
+		if (!ecToAN(Q, P, j, ec, stack))
+		{
+			code = ERR_BAD_PARAMS;
+			break;
+		}
+		// выгрузить общие ключи
+		for (j = 0; j < BIGN_BATCH && i + j < count; ++j)
+		{
+			word* Qj = Q + 2 * n * j;
+			qrTo((octet*)Qj, ecX(Qj), ec->f, stack);
+			if (key_len > no)
+				qrTo((octet*)Qj + no, ecY(Qj, n), ec->f, stack);
+			memCopy(keys + (i + j) * key_len, Qj, key_len);
+		}
+	}
+	// очистить выходные данные при ошибке
+	if (code != ERR_OK)
+		memWipe(keys, count * key_len);
+	// завершение
+	blobClose(state);
+	return code;
+}
+
+/*
+*******************************************************************************
+Выработка ЭЦП
+*******************************************************************************
+*/
+
+static size_t bignSign_deep(size_t n, size_t f_deep, size_t ec_d,
+	size_t ec_deep)
+{
+	return O_OF_W(4 * n) +
+		utilMax(4,
+			beltHash_keep(),
+			ecMulA_deep(n, ec_d, ec_deep, n),
+			zzMul_deep(n / 2, n),
+			zzMod_deep(n + n / 2 + 1, n));
+}
+
+err_t bignCtxSign(octet sig[], const void* ctx, const octet oid_der[],
+	size_t oid_len, const octet hash[], const octet privkey[], gen_i rng, 
+	void* rng_state, void* stack)
+{
+	size_t no, n;
+	// состояние (буферы могут пересекаться)
+	const ec_o* ec;			/* описание эллиптической кривой */
+	word* d;				/* [n] личный ключ */
+	word* k;				/* [n] одноразовый личный ключ */
+	word* R;				/* [2n] точка R */
+	word* s0;				/* [n/2] первая часть подписи */
+	word* s1;				/* [n] вторая часть подписи */
+	// проверить ctx
+	if (!bignCtxIsOperable(ctx))
+		return ERR_BAD_INPUT;
+	ec = (const ec_o*)ctx;
+	// проверить oid_der
+	if (oid_len == SIZE_MAX || oidFromDER(0, oid_der, oid_len)  == SIZE_MAX)
+		return ERR_BAD_OID;
+	// проверить rng
+	if (rng == 0)
+		return ERR_BAD_RNG;
+	// размерности
+	no  = ec->f->no;
+	n = ec->f->n;
+	ASSERT(n % 2 == 0);
+	// проверить входные указатели
+	if (!memIsValid(hash, no) ||
+		!memIsValid(privkey, no) ||
+		!memIsValid(sig, no + no / 2) ||
+		!memIsDisjoint2(hash, no, sig, no + no / 2))
+		return ERR_BAD_INPUT;
+	// раскладка стека
+	d = s1 = (word*)stack;
+	k = d + n;
+	R = k + n;
+	s0 = R + n + n / 2;
+	stack = R + 2 * n;
+	// загрузить d
+	wwFrom(d, privkey, no);
+	if (wwIsZero(d, n) || wwCmp(d, ec->order, n) >= 0)
+		return ERR_BAD_PRIVKEY;
 	// сгенерировать k с помощью rng
 	if (!zzRandNZMod(k, ec->order, n, rng, rng_state))
-	{
-		blobClose(state);
 		return ERR_BAD_RNG;
-	}
 	// R <- k G
 	if (!ecMulA(R, ec->base, ec, k, n, stack))
-	{
-		blobClose(state);
 		return ERR_BAD_PARAMS;
-	}
 	qrTo((octet*)R, ecX(R), ec->f, stack);
 	// s0 <- belt-hash(oid || R || H) mod 2^l
 	beltHashStart(stack);
@@ -894,10 +1165,43 @@ err_t bignSign(octet sig[], const bign_params* params, const octet oid_der[],
 	// выгрузить s1
 	wwTo(sig + no / 2, no, s1);
 	// все нормально
-	blobClose(state);
 	return ERR_OK;
 }
 
+err_t bignSign(octet sig[], const bign_params* params, const octet oid_der[],
+	size_t oid_len, const octet hash[], const octet privkey[], gen_i rng, 
+	void* rng_state)
+{
+	err_t code;
+	void* state;
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// проверить oid_der
+	if (oid_len == SIZE_MAX || oidFromDER(0, oid_der, oid_len)  == SIZE_MAX)
+		return ERR_BAD_OID;
+	// проверить rng
+	if (rng == 0)
+		return ERR_BAD_RNG;
+	// создать состояние
+	state = blobCreate(bignStart_keep(params->l, bignSign_deep));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// старт
+	code = bignStart(state, params);
+	ERR_CALL_HANDLE(code, blobClose(state));
+	// секретные данные: регулярные редакции
+	bignSetSafe(state, TRUE);
+	// основные действия
+	code = bignCtxSign(sig, state, oid_der, oid_len, hash, privkey, rng,
+		rng_state, objEnd(state, void));
+	// завершение
+	blobClose(state);
+	return code;
+}
+
 static size_t bignSign2_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
@@ -911,41 +1215,29 @@ static size_t bignSign2_deep(size_t n, size_t f_deep, size_t ec_d,
 			zzMod_deep(n + n / 2 + 1, n));
 }
 
-err_t bignSign2(octet sig[], const bign_params* params, const octet oid_der[],
+err_t bignCtxSign2(octet sig[], const void* ctx, const octet oid_der[],
 	size_t oid_len, const octet hash[], const octet privkey[], const void* t, 
-	size_t t_len)
+	size_t t_len, void* stack)
 {
-	err_t code;
 	size_t no, n;
 	// состояние (буферы могут пересекаться)
-	void* state;
-	ec_o* ec;				/* описание эллиптической кривой */
+	const ec_o* ec;			/* описание эллиптической кривой */
 	word* d;				/* [n] личный ключ */
 	word* k;				/* [n] одноразовый личный ключ */
 	word* R;				/* [2n] точка R */
 	word* s0;				/* [n/2] первая часть подписи */
 	word* s1;				/* [n] вторая часть подписи */
 	octet* hash_state;		/* [beltHash_keep] состояние хэширования */
-	octet* stack;
-	// проверить params
-	if (!memIsValid(params, sizeof(bign_params)))
+	// проверить ctx
+	if (!bignCtxIsOperable(ctx))
 		return ERR_BAD_INPUT;
-	if (params->l != 128 && params->l != 192 && params->l != 256)
-		return ERR_BAD_PARAMS;
+	ec = (const ec_o*)ctx;
 	// проверить oid_der
 	if (oid_len == SIZE_MAX || oidFromDER(0, oid_der, oid_len)  == SIZE_MAX)
 		return ERR_BAD_OID;
 	// проверить t
 	if (!memIsNullOrValid(t, t_len))
 		return ERR_BAD_INPUT;
-	// создать состояние
-	state = blobCreate(bignStart_keep(params->l, bignSign2_deep));
-	if (state == 0)
-		return ERR_OUTOFMEMORY;
-	// старт
-	code = bignStart(state, params);
-	ERR_CALL_HANDLE(code, blobClose(state));
-	ec = (ec_o*)state;
 	// размерности
 	no  = ec->f->no;
 	n = ec->f->n;
@@ -955,12 +1247,9 @@ err_t bignSign2(octet sig[], const bign_params* params, const octet oid_der[],
 		!memIsValid(privkey, no) ||
 		!memIsValid(sig, no + no / 2) ||
 		!memIsDisjoint2(hash, no, sig, no + no / 2))
-	{
-		blobClose(state);
 		return ERR_BAD_INPUT;
-	}
-	// раскладка состояния
-	d = s1 = objEnd(ec, word);
+	// раскладка стека
+	d = s1 = (word*)stack;
 	k = d + n;
 	R = k + n;
 	s0 = R + n + n / 2;
@@ -969,10 +1258,7 @@ err_t bignSign2(octet sig[], const bign_params* params, const octet oid_der[],
 	// загрузить d
 	wwFrom(d, privkey, no);
 	if (wwIsZero(d, n) || wwCmp(d, ec->order, n) >= 0)
-	{
-		blobClose(state);
 		return ERR_BAD_PRIVKEY;
-	}
 	// хэшировать oid
 	beltHashStart(hash_state);
 	beltHashStepH(oid_der, oid_len, hash_state);
@@ -1000,10 +1286,7 @@ err_t bignSign2(octet sig[], const bign_params* params, const octet oid_der[],
 	}
 	// R <- k G
 	if (!ecMulA(R, ec->base, ec, k, n, stack))
-	{
-		blobClose(state);
 		return ERR_BAD_PARAMS;
-	}
 	qrTo((octet*)R, ecX(R), ec->f, stack);
 	// s0 <- belt-hash(oid || R || H) mod 2^l
 	beltHashStepH(R, no, hash_state);
@@ -1022,10 +1305,43 @@ err_t bignSign2(octet sig[], const bign_params* params, const octet oid_der[],
 	// выгрузить s1
 	wwTo(sig + no / 2, no, s1);
 	// все нормально
-	blobClose(state);
 	return ERR_OK;
 }
 
+err_t bignSign2(octet sig[], const bign_params* params, const octet oid_der[],
+	size_t oid_len, const octet hash[], const octet privkey[], const void* t, 
+	size_t t_len)
+{
+	err_t code;
+	void* state;
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// проверить oid_der
+	if (oid_len == SIZE_MAX || oidFromDER(0, oid_der, oid_len)  == SIZE_MAX)
+		return ERR_BAD_OID;
+	// проверить t
+	if (!memIsNullOrValid(t, t_len))
+		return ERR_BAD_INPUT;
+	// создать состояние
+	state = blobCreate(bignStart_keep(params->l, bignSign2_deep));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// старт
+	code = bignStart(state, params);
+	ERR_CALL_HANDLE(code, blobClose(state));
+	// секретные данные: регулярные редакции
+	bignSetSafe(state, TRUE);
+	// основные действия
+	code = bignCtxSign2(sig, state, oid_der, oid_len, hash, privkey, t, t_len,
+		objEnd(state, void));
+	// завершение
+	blobClose(state);
+	return code;
+}
+
 /*
 *******************************************************************************
 Проверка ЭЦП
@@ -1041,36 +1357,25 @@ static size_t bignVerify_deep(size_t n, size_t f_deep, size_t ec_d,
 			ecAddMulA_deep(n, ec_d, ec_deep, 2, n, n / 2 + 1));
 }
 
-err_t bignVerify(const bign_params* params, const octet oid_der[],
-	size_t oid_len, const octet hash[], const octet sig[], const octet pubkey[])
+err_t bignCtxVerify(const void* ctx, const octet oid_der[], size_t oid_len,
+	const octet hash[], const octet sig[], const octet pubkey[], void* stack)
 {
 	err_t code;
 	size_t no, n;
 	// состояние (буферы могут пересекаться)
-	void* state;
-	ec_o* ec;			/* описание эллиптической кривой */	
+	const ec_o* ec;		/* описание эллиптической кривой */	
 	word* Q;			/* [2n] открытый ключ */
 	word* R;			/* [2n] точка R */
 	word* H;			/* [n] хэш-значение */
 	word* s0;			/* [n / 2 + 1] первая часть подписи */
 	word* s1;			/* [n] вторая часть подписи */
-	octet* stack;
-	// проверить params
-	if (!memIsValid(params, sizeof(bign_params)))
+	// проверить ctx
+	if (!bignCtxIsOperable(ctx))
 		return ERR_BAD_INPUT;
-	if (params->l != 128 && params->l != 192 && params->l != 256)
-		return ERR_BAD_PARAMS;
+	ec = (const ec_o*)ctx;
 	// проверить oid_der
 	if (oid_len == SIZE_MAX || oidFromDER(0, oid_der, oid_len)  == SIZE_MAX)
 		return ERR_BAD_OID;
-	// создать состояние
-	state = blobCreate(bignStart_keep(params->l, bignVerify_deep));
-	if (state == 0)
-		return ERR_OUTOFMEMORY;
-	// старт
-	code = bignStart(state, params);
-	ERR_CALL_HANDLE(code, blobClose(state));
-	ec = (ec_o*)state;
 	// размерности
 	no  = ec->f->no;
 	n = ec->f->n;
@@ -1079,29 +1384,20 @@ err_t bignVerify(const bign_params* params, const octet oid_der[],
 	if (!memIsValid(hash, no) ||
 		!memIsValid(sig, no + no / 2) ||
 		!memIsValid(pubkey, 2 * no))
-	{
-		blobClose(state);
 		return ERR_BAD_INPUT;
-	}
-	// раскладка состояния
-	Q = R = objEnd(ec, word);
+	// раскладка стека
+	Q = R = (word*)stack;
 	H = s0 = Q + 2 * n;
 	s1 = H + n;
-	stack = (octet*)(s1 + n);
+	stack = s1 + n;
 	// загрузить Q
 	if (!qrFrom(ecX(Q), pubkey, ec->f, stack) ||
 		!qrFrom(ecY(Q, n), pubkey + no, ec->f, stack))
-	{
-		blobClose(state);
 		return ERR_BAD_PUBKEY;
-	}
 	// загрузить и проверить s1
 	wwFrom(s1, sig + no / 2, no);
 	if (wwCmp(s1, ec->order, n) >= 0)
-	{
-		blobClose(state);
 		return ERR_BAD_SIG;
-	}
 	// s1 <- (s1 + H) mod q
 	wwFrom(H, hash, no);
 	if (wwCmp(H, ec->order, n) >= 0)
@@ -1116,10 +1412,7 @@ err_t bignVerify(const bign_params* params, const octet oid_der[],
 	s0[n / 2] = 1;
 	// R <- s1 G + (s0 + 2^l) Q
 	if (!ecAddMulA(R, ec, stack, 2, ec->base, s1, n, Q, s0, n / 2 + 1))
-	{
-		blobClose(state);
 		return ERR_BAD_SIG;
-	}
 	qrTo((octet*)R, ecX(R), ec->f, stack);
 	// s0 == belt-hash(oid || R || H) mod 2^l?
 	beltHashStart(stack);
@@ -1128,10 +1421,357 @@ err_t bignVerify(const bign_params* params, const octet oid_der[],
 	beltHashStepH(hash, no, stack);
 	code = beltHashStepV2(sig, no / 2, stack) ? ERR_OK : ERR_BAD_SIG;
 	// завершение
+	return code;
+}
+
+err_t bignVerify(const bign_params* params, const octet oid_der[],
+	size_t oid_len, const octet hash[], const octet sig[], const octet pubkey[])
+{
+	err_t code;
+	void* state;
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// проверить oid_der
+	if (oid_len == SIZE_MAX || oidFromDER(0, oid_der, oid_len)  == SIZE_MAX)
+		return ERR_BAD_OID;
+	// создать состояние
+	state = blobCreate(bignStart_keep(params->l, bignVerify_deep));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// старт
+	code = bignStart(state, params);
+	ERR_CALL_HANDLE(code, blobClose(state));
+	// открытые данные: ускоренные редакции
+	bignSetSafe(state, FALSE);
+	// основные действия
+	code = bignCtxVerify(state, oid_der, oid_len, hash, sig, pubkey,
+		objEnd(state, void));
+	// завершение
+	blobClose(state);
+	return code;
+}
+
+/*
+*******************************************************************************
+Глубина стека контекстных функций
+*******************************************************************************
+*/
+
+size_t bignCtx_deep(size_t l)
+{
+	// размерности
+	size_t no = O_OF_B(2 * l);
+	size_t n = W_OF_B(2 * l);
+	size_t f_deep = gfpCreate_deep(no);
+	size_t ec_d = 3;
+	size_t ec_deep = ecpCreateJ_deep(n, f_deep);
+	// pre
+	ASSERT(l == 128 || l == 192 || l == 256);
+	// расчет
+	return utilMax(6,
+		bignGenKeypair_deep(n, f_deep, ec_d, ec_deep),
+		bignCalcPubkey_deep(n, f_deep, ec_d, ec_deep),
+		bignDH_deep(n, f_deep, ec_d, ec_deep),
+		bignSign_deep(n, f_deep, ec_d, ec_deep),
+		bignSign2_deep(n, f_deep, ec_d, ec_deep),
+		bignVerify_deep(n, f_deep, ec_d, ec_deep));
+}
+
+/*
+*******************************************************************************
+Выработка ЭЦП с предвычислениями
+
+Пул состоит из заголовка, контекста и массива пар. Массив рассчитан на
+count пар вида (<k>, <R>), где <k> -- [no]-октетное представление 
+одноразового личного ключа, <R> -- [no]-октетное представление 
+x-координаты точки R = k G. Готовые пары располагаются в начале массива, 
+их число -- size. Пары добавляются в конец и извлекаются из конца.
+
+Блокировка мьютекса пула выполняется только на время добавления или
+извлечения пары. Кратная точка R вычисляется вне блокировки на собственной
+памяти вызывающего потока. Контекст пула при этом только читается.
+
+Поле size читается и изменяется только под блокировкой. Поэтому функция
+bignPoolIsOperable() проверяет только неизменяемые поля пула, а условие 
+size <= count проверяется в заблокированных участках.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	obj_hdr_t hdr;				/*< заголовок */
+// ptr_table {
+	ec_o* ec;					/*< контекст (описание кривой) */
+	octet* pairs;				/*< [count * 2 * ec->f->no] пары */
+// }
+	size_t count;				/*< вместимость пула */
+	size_t size;				/*< число готовых пар */
+	mt_mtx_t mtx[1];			/*< мьютекс */
+	octet data[];				/*< данные */
+} bign_pool_o;
+
+size_t bignPool_keep(size_t l, size_t count)
+{
+	ASSERT(l == 128 || l == 192 || l == 256);
+	return sizeof(bign_pool_o) + bignCtx_keep(l) + count * O_OF_B(4 * l);
+}
+
+static bool_t bignPoolIsOperable(const bign_pool_o* p)
+{
+	return memIsValid(p, sizeof(bign_pool_o)) &&
+		objIsOperable2(p) &&
+		objPCount(p) == 2 &&
+		objOCount(p) == 1 &&
+		bignCtxIsOperable(p->ec) &&
+		p->count > 0 &&
+		objKeep(p) == sizeof(bign_pool_o) + objKeep(p->ec) + 
+			2 * p->ec->f->no * p->count &&
+		mtMtxIsValid(p->mtx);
+}
+
+err_t bignPoolStart(void* pool, const bign_params* params, size_t count)
+{
+	err_t code;
+	bign_pool_o* p = (bign_pool_o*)pool;
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// проверить count и pool
+	if (count == 0 || 
+		count > (SIZE_MAX - sizeof(bign_pool_o) - bignCtx_keep(params->l)) / 
+			O_OF_B(4 * params->l) ||
+		!memIsValid(pool, bignPool_keep(params->l, count)))
+		return ERR_BAD_INPUT;
+	// создать контекст (одноразовые ключи -- секретные данные)
+	code = bignCtxStart(p->data, params);
+	ERR_CALL_CHECK(code);
+	bignSetSafe(p->data, TRUE);
+	// создать мьютекс
+	if (!mtMtxCreate(p->mtx))
+		return ERR_SYS;
+	// настроить пул
+	p->ec = (ec_o*)p->data;
+	p->pairs = objEnd(p->ec, octet);
+	p->count = count;
+	p->size = 0;
+	p->hdr.keep = sizeof(bign_pool_o) + objKeep(p->ec) +
+		2 * p->ec->f->no * count;
+	p->hdr.p_count = 2;
+	p->hdr.o_count = 1;
+	memSetZero(p->pairs, 2 * p->ec->f->no * count);
+	// все нормально
+	return ERR_OK;
+}
+
+static size_t bignPoolFill_deep(size_t n, size_t ec_d, size_t ec_deep)
+{
+	return O_OF_W(3 * n) +
+		ecMulA_deep(n, ec_d, ec_deep, n);
+}
+
+err_t bignPoolFill(void* pool, size_t count, gen_i rng, void* rng_state)
+{
+	err_t code = ERR_OK;
+	bign_pool_o* p = (bign_pool_o*)pool;
+	size_t no, n;
+	// состояние
+	void* state;
+	const ec_o* ec;			/* описание эллиптической кривой */
+	word* k;				/* [n] одноразовый личный ключ */
+	word* R;				/* [2n] точка R */
+	void* stack;
+	// проверить входные данные
+	if (!bignPoolIsOperable(p))
+		return ERR_BAD_INPUT;
+	if (rng == 0)
+		return ERR_BAD_RNG;
+	ec = p->ec;
+	// размерности
+	no  = ec->f->no;
+	n = ec->f->n;
+	// создать состояние
+	state = blobCreate(bignPoolFill_deep(n, ec->d, ec->deep));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// раскладка состояния
+	k = (word*)state;
+	R = k + n;
+	stack = R + 2 * n;
+	// пополнять
+	while (count--)
+	{
+		// пул заполнен?
+		mtMtxLock(p->mtx);
+		if (p->size > p->count)
+		{
+			mtMtxUnlock(p->mtx);
+			code = ERR_BAD_INPUT;
+			break;
+		}
+		if (p->size == p->count)
+		{
+			mtMtxUnlock(p->mtx);
+			break;
+		}
+		mtMtxUnlock(p->mtx);
+		// сгенерировать k
+		if (!zzRandNZMod(k, ec->order, n, rng, rng_state))
+		{
+			code = ERR_BAD_RNG;
+			break;
+		}
+		// R <- k G
+		if (!ecMulA(R, ec->base, ec, k, n, stack))
+		{
+			code = ERR_BAD_PARAMS;
+			break;
+		}
+		qrTo((octet*)R, ecX(R), ec->f, stack);
+		wwTo(k, no, k);
+		// добавить пару (<k>, <R>) в пул
+		mtMtxLock(p->mtx);
+		if (p->size < p->count)
+		{
+			memCopy(p->pairs + 2 * no * p->size, k, no);
+			memCopy(p->pairs + 2 * no * p->size + no, R, no);
+			++p->size;
+		}
+		mtMtxUnlock(p->mtx);
+	}
+	// завершение
 	blobClose(state);
 	return code;
 }
 
+size_t bignPoolSize(void* pool)
+{
+	bign_pool_o* p = (bign_pool_o*)pool;
+	size_t size;
+	if (!bignPoolIsOperable(p))
+		return 0;
+	mtMtxLock(p->mtx);
+	size = p->size <= p->count ? p->size : 0;
+	mtMtxUnlock(p->mtx);
+	return size;
+}
+
+static size_t bignPoolSign_deep(size_t n)
+{
+	return O_OF_W(4 * n) + O_OF_W(2 * n) +
+		utilMax(3,
+			beltHash_keep(),
+			zzMul_deep(n / 2, n),
+			zzMod_deep(n + n / 2 + 1, n));
+}
+
+err_t bignPoolSign(octet sig[], void* pool, const octet oid_der[],
+	size_t oid_len, const octet hash[], const octet privkey[])
+{
+	bign_pool_o* p = (bign_pool_o*)pool;
+	size_t no, n;
+	// состояние
+	void* state;
+	const ec_o* ec;			/* описание эллиптической кривой */
+	word* d;				/* [n] личный ключ */
+	word* k;				/* [n] одноразовый личный ключ */
+	word* R;				/* [2n] произведение */
+	word* s0;				/* [n/2] первая часть подписи */
+	word* s1;				/* [n] вторая часть подписи */
+	octet* pair;			/* [2no] пара (<k>, <R>) */
+	void* stack;
+	// проверить pool
+	if (!bignPoolIsOperable(p))
+		return ERR_BAD_INPUT;
+	ec = p->ec;
+	// проверить oid_der
+	if (oid_len == SIZE_MAX || oidFromDER(0, oid_der, oid_len)  == SIZE_MAX)
+		return ERR_BAD_OID;
+	// размерности
+	no = ec->f->no;
+	n = ec->f->n;
+	ASSERT(n % 2 == 0);
+	// проверить входные указатели
+	if (!memIsValid(hash, no) ||
+		!memIsValid(privkey, no) ||
+		!memIsValid(sig, no + no / 2) ||
+		!memIsDisjoint2(hash, no, sig, no + no / 2))
+		return ERR_BAD_INPUT;
+	// создать состояние
+	state = blobCreate(bignPoolSign_deep(n));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// раскладка состояния
+	d = s1 = (word*)state;
+	k = d + n;
+	R = k + n;
+	s0 = R + n + n / 2;
+	pair = (octet*)(R + 2 * n);
+	stack = pair + 2 * no;
+	// загрузить d
+	wwFrom(d, privkey, no);
+	if (wwIsZero(d, n) || wwCmp(d, ec->order, n) >= 0)
+	{
+		blobClose(state);
+		return ERR_BAD_PRIVKEY;
+	}
+	// извлечь пару из пула
+	mtMtxLock(p->mtx);
+	if (p->size > p->count)
+	{
+		mtMtxUnlock(p->mtx);
+		blobClose(state);
+		return ERR_BAD_INPUT;
+	}
+	if (p->size == 0)
+	{
+		mtMtxUnlock(p->mtx);
+		blobClose(state);
+		return ERR_NOT_READY;
+	}
+	--p->size;
+	memCopy(pair, p->pairs + 2 * no * p->size, 2 * no);
+	memWipe(p->pairs + 2 * no * p->size, 2 * no);
+	mtMtxUnlock(p->mtx);
+	// k <- <k>
+	wwFrom(k, pair, no);
+	// s0 <- belt-hash(oid || R || H) mod 2^l
+	beltHashStart(stack);
+	beltHashStepH(oid_der, oid_len, stack);
+	beltHashStepH(pair + no, no, stack);
+	beltHashStepH(hash, no, stack);
+	beltHashStepG2(sig, no / 2, stack);
+	wwFrom(s0, sig, no / 2);
+	// R <- (s0 + 2^l) d
+	zzMul(R, s0, n / 2, d, n, stack);
+	R[n + n / 2] = zzAdd(R + n / 2, R + n / 2, d, n);
+	// s1 <- R mod q
+	zzMod(s1, R, n + n / 2 + 1, ec->order, n, stack);
+	// s1 <- (k - s1 - H) mod q
+	zzSubMod(s1, k, s1, ec->order, n);
+	wwFrom(k, hash, no);
+	zzSubMod(s1, s1, k, ec->order, n);
+	// выгрузить s1
+	wwTo(sig + no / 2, no, s1);
+	// все нормально
+	blobClose(state);
+	return ERR_OK;
+}
+
+void bignPoolClose(void* pool)
+{
+	bign_pool_o* p = (bign_pool_o*)pool;
+	if (bignPoolIsOperable(p))
+	{
+		mtMtxClose(p->mtx);
+		memWipe(p, objKeep(p));
+	}
+}
+
 /*
 *******************************************************************************
 Создание токена
@@ -1180,6 +1820,8 @@ err_t bignKeyWrap(octet token[], const bign_params* params, const octet key[],
 	// старт
 	code = bignStart(state, params);
 	ERR_CALL_HANDLE(code, blobClose(state));
+	// секретные данные: регулярные редакции
+	bignSetSafe(state, TRUE);
 	ec = (ec_o*)state;
 	// размерности
 	no  = ec->f->no;
@@ -1253,7 +1895,7 @@ static size_t bignKeyUnwrap_deep(size_t n, size_t f_deep, size_t ec_d,
 	return MAX2(O_OF_W(5 * n), 32 + 16) +
 		utilMax(3,
 			beltKWP_keep(),
-			qrPower_deep(n, n, f_deep),
+			zmPowerSqrt_deep(n, f_deep),
 			ecMulA_deep(n, ec_d, ec_deep, n));
 }
 
@@ -1288,6 +1930,8 @@ err_t bignKeyUnwrap(octet key[], const bign_params* params, const octet token[],
 	// старт
 	code = bignStart(state, params);
 	ERR_CALL_HANDLE(code, blobClose(state));
+	// секретные данные: регулярные редакции
+	bignSetSafe(state, TRUE);
 	ec = (ec_o*)state;
 	// размерности
 	no  = ec->f->no;
@@ -1334,11 +1978,9 @@ err_t bignKeyUnwrap(octet key[], const bign_params* params, const octet token[],
 	zmAdd(t1, t1, ec->A, ec->f);
 	qrMul(t1, t1, R, ec->f, stack);
 	zmAdd(t1, t1, ec->B, ec->f);
-	// yR <- t1^{(p + 1) / 4}
-	wwCopy(R + n, ec->f->mod, n);
-	zzAddW2(R + n, n, 1);
-	wwShLo(R + n, n, 2);
-	qrPower(R + n, t1, R + n, n, ec->f, stack);
+	// yR <- t1^{(p + 1) / 4} = t1^{(p - 3) / 4} t1
+	zmPowerSqrt(R + n, t1, ec->f, stack);
+	qrMul(R + n, R + n, t1, ec->f, stack);
 	// t2 <- yR^2
 	qrSqr(t2, R + n, ec->f, stack);
 	// (xR, yR) на кривой? t1 == t2?
@@ -1418,6 +2060,8 @@ err_t bignIdExtract(octet id_privkey[], octet id_pubkey[],
 	// старт
 	code = bignStart(state, params);
 	ERR_CALL_HANDLE(code, blobClose(state));
+	// секретные данные: регулярные редакции
+	bignSetSafe(state, TRUE);
 	ec = (ec_o*)state;
 	// размерности
 	no  = ec->f->no;
@@ -1539,6 +2183,8 @@ err_t bignIdSign(octet id_sig[], const bign_params* params,
 	// старт
 	code = bignStart(state, params);
 	ERR_CALL_HANDLE(code, blobClose(state));
+	// секретные данные: регулярные редакции
+	bignSetSafe(state, TRUE);
 	ec = (ec_o*)state;
 	// размерности
 	no  = ec->f->no;
@@ -1650,6 +2296,8 @@ err_t bignIdSign2(octet id_sig[], const bign_params* params,
 	// старт
 	code = bignStart(state, params);
 	ERR_CALL_HANDLE(code, blobClose(state));
+	// секретные данные: регулярные редакции
+	bignSetSafe(state, TRUE);
 	ec = (ec_o*)state;
 	// размерности
 	no  = ec->f->no;
@@ -1783,6 +2431,8 @@ err_t bignIdVerify(const bign_params* params, const octet oid_der[],
 	// старт
 	code = bignStart(state, params);
 	ERR_CALL_HANDLE(code, blobClose(state));
+	// открытые данные: ускоренные редакции
+	bignSetSafe(state, FALSE);
 	ec = (ec_o*)state;
 	// размерности
 	no  = ec->f->no;
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.27
-\version 2016.04.22
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -458,8 +458,8 @@ static err_t _dstuCreateEc(
 	f_keep = gf2Create_keep(m);
 	f_deep = gf2Create_deep(m);
 	ec_d = 3;
-	ec_keep = ec2CreateLD_keep(n);
-	ec_deep = ec2CreateLD_deep(n, f_deep);
+	ec_keep = ec2CreateLAM_keep(n);
+	ec_deep = ec2CreateLAM_deep(n, f_deep);
 	// создать состояние
 	state = blobCreate(
 		f_keep + ec_keep +
@@ -489,7 +489,7 @@ static err_t _dstuCreateEc(
 	A[0] = params->A;
 	memSetZero(A + 1, f->no - 1);
 	stack = A + f->no;
-	if (!ec2CreateLD(ec, f, A, params->B, stack) ||
+	if (!ec2CreateLAM(ec, f, A, params->B, stack) ||
 		!ecCreateGroup(ec, params->P, params->P + ec->f->no, params->n, 
 			ec->f->no, params->c, stack))
 	{
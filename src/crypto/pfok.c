@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.07.01
-\version 2020.11.05
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -465,8 +465,8 @@ g^(2) \neq e => g == e или g == -e
 *******************************************************************************
 */
 
-err_t pfokGenParams(pfok_params* params, const pfok_seed* seed, 
-	pfok_on_q_i on_q)
+err_t pfokGenParamsMT(pfok_params* params, const pfok_seed* seed, 
+	pfok_on_q_i on_q, size_t threads)
 {
 	size_t num = 0;
 	size_t i;
@@ -485,6 +485,8 @@ err_t pfokGenParams(pfok_params* params, const pfok_seed* seed,
 	if (!memIsValid(params, sizeof(pfok_params)) ||
 		!memIsValid(seed, sizeof(pfok_seed)))
 		return ERR_BAD_INPUT;
+	if (threads == 0)
+		return ERR_BAD_INPUT;
 	// подготовить params
 	memSetZero(params, sizeof(pfok_params));
 	// проверить числа z[i]
@@ -513,7 +515,8 @@ err_t pfokGenParams(pfok_params* params, const pfok_seed* seed,
 		O_OF_W(n) +	zmMontCreate_keep(no) +
 		utilMax(6,
 			priNextPrimeW_deep(),
-			priExtendPrime_deep(params->l, n, (lt[0] + 3) / 4),
+			priExtendPrimeMT_deep(params->l, n, (lt[0] + 3) / 4,
+				threads),
 			priIsSieved_deep((lt[0] + 3) / 4),
 			priIsSGPrime_deep(n),
 			zmMontCreate_deep(no), 
@@ -554,9 +557,10 @@ err_t pfokGenParams(pfok_params* params, const pfok_seed* seed,
 			if (base_count > priBaseSize())
 				base_count = priBaseSize();
 			// не удается построить новое простое?
-			if (!priExtendPrime(qi + offset, lt[i], 
+			if (!priExtendPrimeMT(qi + offset, lt[i], 
 					qi + offset + W_OF_B(lt[i]), W_OF_B(lt[i + 1]), 
-					trials, base_count, prngSTBStepR, stb_state, stack))
+					trials, base_count, prngSTBStepR, stb_state, threads,
+					stack))
 			{
 				// к предыдущему простому
 				offset += W_OF_B(lt[i++]);
@@ -602,7 +606,13 @@ err_t pfokGenParams(pfok_params* params, const pfok_seed* seed,
 	return ERR_OK;
 }
 
-err_t pfokValParams(const pfok_params* params)
+err_t pfokGenParams(pfok_params* params, const pfok_seed* seed, 
+	pfok_on_q_i on_q)
+{
+	return pfokGenParamsMT(params, seed, on_q, 1);
+}
+
+err_t pfokValParamsMT(const pfok_params* params, size_t threads)
 {
 	size_t no, n;
 	// состояние 
@@ -612,7 +622,7 @@ err_t pfokValParams(const pfok_params* params)
 	qr_o* qr;
 	void* stack;
 	// проверить указатели
-	if (!memIsValid(params, sizeof(pfok_params)))
+	if (!memIsValid(params, sizeof(pfok_params)) || threads == 0)
 		return ERR_BAD_INPUT;
 	// работоспособные параметры?
 	if (!pfokIsOperableParams(params))
@@ -623,7 +633,7 @@ err_t pfokValParams(const pfok_params* params)
 	state = blobCreate(
 		2 * O_OF_W(n) + zmMontCreate_keep(no) +  
 		utilMax(3,
-			priIsPrime_deep(n),
+			priRMTestMT_deep(n, threads),
 			zmMontCreate_deep(no),
 			qrPower_deep(n, n, zmMontCreate_deep(no))));
 	if (state == 0)
@@ -635,14 +645,16 @@ err_t pfokValParams(const pfok_params* params)
 	stack = (octet*)qr + zmMontCreate_keep(no);
 	// p -- простое?
 	wwFrom(p, params->p, no);
-	if (!priIsPrime(p, n, stack))
+	if (!priRMTestMT(p, n, (B_PER_IMPOSSIBLE + 1) / 2, threads, 
+		stack))
 	{
 		blobClose(state);
 		return ERR_BAD_PARAMS;
 	}
 	// q -- простое?
 	wwShLo(p, n, 1);
-	if (!priIsPrime(p, n, stack))
+	if (!priRMTestMT(p, n, (B_PER_IMPOSSIBLE + 1) / 2, threads, 
+		stack))
 	{
 		blobClose(state);
 		return ERR_BAD_PARAMS;
@@ -662,57 +674,212 @@ err_t pfokValParams(const pfok_params* params)
 	return ERR_OK;
 }
 
+err_t pfokValParams(const pfok_params* params)
+{
+	return pfokValParamsMT(params, 1);
+}
+
 /*
 *******************************************************************************
-Управление ключами
+Предвычисления
+
+Подготовленный объект содержит копию долговременных параметров, кольцо 
+Монтгомери \mod p и таблицу гребенчатого метода для g (см. 
+qrPowerCombStart()). Таблица рассчитывается для показателей битовой 
+длины не больше r и состоит из 2^h - 1 элементов кольца. При h = 6 и 
+r = 240 возведение g в степень требует 39 возведений в квадрат и не более 
+40 умножений вместо примерно 240 возведений в квадрат и 50 умножений 
+в qrPower().
+
+Как и в остальных функциях модуля, элемент g загружается в кольцо без 
+перевода в форму Монтгомери. Поэтому результаты qrPowerComb() и qrPower() 
+совпадают.
+
+Функции, которые принимают долговременные параметры, а не подготовленный 
+объект, строят временный объект без таблицы (h = 0).
+
+Функции, которые принимают подготовленный объект, проверяют хранящиеся 
+в нем параметры, число зубьев h и длину объекта.
+
+\remark Статические таблицы для стандартных параметров не предусмотрены:
+таблица для l = 2462 занимает около 19 Кбайт, а ее построение требует 
+примерно столько же операций, сколько одно возведение в степень.
 *******************************************************************************
 */
 
-err_t pfokGenKeypair(octet privkey[], octet pubkey[], 
-	const pfok_params* params, gen_i rng, void* rng_state)
+#define PFOK_COMB_H 6
+
+typedef struct
+{
+	pfok_params params[1];	/*< долговременные параметры */
+	size_t h;				/*< число зубьев гребня (0 -- таблицы нет) */
+	word data[];			/*< кольцо и таблица */
+} pfok_prep_st;
+
+#define pfokPrepQr(st) ((qr_o*)(st)->data)
+#define pfokPrepComb(st)\
+	((word*)((octet*)(st)->data + zmMontCreate_keep(O_OF_B((st)->params->l))))
+
+static size_t pfokPrepKeep(size_t l, size_t h)
+{
+	return sizeof(pfok_prep_st) + zmMontCreate_keep(O_OF_B(l)) + 
+		(h ? qrPowerComb_keep(W_OF_B(l), h) : 0);
+}
+
+static bool_t pfokPrepIsValid(const pfok_prep_st* st)
+{
+	return memIsValid(st, sizeof(pfok_prep_st)) &&
+		pfokIsOperableParams(st->params) &&
+		(st->h == 0 || st->h == PFOK_COMB_H) &&
+		memIsValid(st, pfokPrepKeep(st->params->l, st->h));
+}
+
+static err_t pfokPrepCreate(pfok_prep_st* st, const pfok_params* params, 
+	size_t h)
 {
 	size_t no, n;
-	size_t mo, m;
 	// состояние
 	void* state;
-	word* x;				/* [m] личный ключ */
-	word* y;				/* [n] открытый ключ */
-	qr_o* qr;				/* описание кольца Монтгомери */
+	word* g;
+	qr_o* qr;
 	void* stack;
+	// pre
+	ASSERT(pfokIsOperableParams(params));
+	ASSERT(memIsValid(st, pfokPrepKeep(params->l, h)));
+	// размерности
+	no = O_OF_B(params->l), n = W_OF_B(params->l);
+	// создать состояние
+	state = blobCreate(
+		O_OF_W(n) + 
+		utilMax(2,
+			zmMontCreate_deep(no),
+			qrPowerCombStart_deep(n, zmMontCreate_deep(no))));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// раскладка состояния
+	g = (word*)state;
+	stack = g + n;
+	// сохранить параметры
+	memCopy(st->params, params, sizeof(pfok_params));
+	st->h = h;
+	// построить кольцо Монтгомери
+	qr = pfokPrepQr(st);
+	zmMontCreate(qr, params->p, no, params->l + 2, stack);
+	// построить таблицу
+	if (h)
+	{
+		wwFrom(g, params->g, no);
+		qrPowerCombStart(pfokPrepComb(st), g, params->r, h, qr, stack);
+	}
+	// все нормально
+	blobClose(state);
+	return ERR_OK;
+}
+
+static err_t pfokPrepTmp(void** prep, const pfok_params* params)
+{
+	err_t code;
+	*prep = 0;
 	// проверить params
 	if (!memIsValid(params, sizeof(pfok_params)))
 		return ERR_BAD_INPUT;
 	// работоспособные параметры?
 	if (!pfokIsOperableParams(params))
 		return ERR_BAD_PARAMS;
+	// создать объект без таблицы
+	*prep = blobCreate(pfokPrepKeep(params->l, 0));
+	if (*prep == 0)
+		return ERR_OUTOFMEMORY;
+	code = pfokPrepCreate((pfok_prep_st*)*prep, params, 0);
+	if (code != ERR_OK)
+		blobClose(*prep), *prep = 0;
+	return code;
+}
+
+static void pfokPowerG(word y[], const word x[], size_t m, 
+	const pfok_prep_st* st, void* stack)
+{
+	const qr_o* qr = pfokPrepQr(st);
+	if (st->h)
+		qrPowerComb(y, pfokPrepComb(st), x, m, st->params->r, st->h, qr, 
+			stack);
+	else
+	{
+		wwFrom(y, st->params->g, qr->no);
+		qrPower(y, y, x, m, qr, stack);
+	}
+}
+
+static size_t pfokPowerG_deep(size_t n, size_t m, size_t r_deep)
+{
+	return utilMax(2,
+		qrPowerComb_deep(n, r_deep),
+		qrPower_deep(n, m, r_deep));
+}
+
+size_t pfokPrep_keep(size_t l)
+{
+	return pfokPrepKeep(l, PFOK_COMB_H);
+}
+
+err_t pfokPrepStart(void* prep, const pfok_params* params)
+{
+	// проверить params
+	if (!memIsValid(params, sizeof(pfok_params)))
+		return ERR_BAD_INPUT;
+	// работоспособные параметры?
+	if (!pfokIsOperableParams(params))
+		return ERR_BAD_PARAMS;
+	// проверить prep
+	if (!memIsValid(prep, pfokPrep_keep(params->l)))
+		return ERR_BAD_INPUT;
+	// построить объект
+	return pfokPrepCreate((pfok_prep_st*)prep, params, PFOK_COMB_H);
+}
+
+/*
+*******************************************************************************
+Управление ключами
+*******************************************************************************
+*/
+
+err_t pfokGenKeypairPrep(octet privkey[], octet pubkey[], const void* prep,
+	gen_i rng, void* rng_state)
+{
+	const pfok_prep_st* st = (const pfok_prep_st*)prep;
+	size_t no, n;
+	size_t mo, m;
+	// состояние
+	void* state;
+	word* x;				/* [m] личный ключ */
+	word* y;				/* [n] открытый ключ */
+	const qr_o* qr;			/* описание кольца Монтгомери */
+	void* stack;
+	// проверить prep
+	if (!pfokPrepIsValid(st))
+		return ERR_BAD_INPUT;
 	// размерности
-	no = O_OF_B(params->l), n = W_OF_B(params->l);
-	mo = O_OF_B(params->r), m = W_OF_B(params->r);
+	no = O_OF_B(st->params->l), n = W_OF_B(st->params->l);
+	mo = O_OF_B(st->params->r), m = W_OF_B(st->params->r);
 	// проверить остальные входные данные
 	if (!memIsValid(privkey, mo) || !memIsValid(pubkey, no) || rng == 0)
 		return ERR_BAD_INPUT;
 	// создать состояние
+	qr = pfokPrepQr(st);
 	state = blobCreate(
-		O_OF_W(n) + O_OF_W(m) + zmMontCreate_keep(no) +  
-		utilMax(2,
-			zmMontCreate_deep(no),
-			qrPower_deep(n, n, zmMontCreate_deep(no))));
+		O_OF_W(n) + O_OF_W(m) + pfokPowerG_deep(n, m, qr->deep));
 	if (state == 0)
 		return ERR_OUTOFMEMORY;
 	// раскладка состояния
 	x = (word*)state;
 	y = x + m;
-	qr = (qr_o*)(y + n);
-	stack = (octet*)qr + zmMontCreate_keep(no);
-	// построить кольцо Монтгомери
-	zmMontCreate(qr, params->p, no, params->l + 2, stack);
+	stack = y + n;
 	// x <-R {0, 1,..., 2^r - 1}
 	rng(x, mo, rng_state);
 	wwFrom(x, x, mo);
-	wwTrimHi(x, m, params->r);
+	wwTrimHi(x, m, st->params->r);
 	// y <- g^(x)
-	wwFrom(y, params->g, no);
-	qrPower(y, y, x, m, qr, stack);
+	pfokPowerG(y, x, m, st, stack);
 	// выгрузить ключи
 	wwTo(privkey, mo, x);
 	qrTo(pubkey, y, qr, stack);
@@ -721,6 +888,18 @@ err_t pfokGenKeypair(octet privkey[], octet pubkey[],
 	return ERR_OK;
 }
 
+err_t pfokGenKeypair(octet privkey[], octet pubkey[], 
+	const pfok_params* params, gen_i rng, void* rng_state)
+{
+	err_t code;
+	void* prep;
+	code = pfokPrepTmp(&prep, params);
+	ERR_CALL_CHECK(code);
+	code = pfokGenKeypairPrep(privkey, pubkey, prep, rng, rng_state);
+	blobClose(prep);
+	return code;
+}
+
 err_t pfokValPubkey(const pfok_params* params, const octet pubkey[])
 {
 	size_t no;
@@ -742,54 +921,46 @@ err_t pfokValPubkey(const pfok_params* params, const octet pubkey[])
 	return ERR_OK;
 }
 
-err_t pfokCalcPubkey(octet pubkey[], const pfok_params* params, 
+err_t pfokCalcPubkeyPrep(octet pubkey[], const void* prep, 
 	const octet privkey[])
 {
+	const pfok_prep_st* st = (const pfok_prep_st*)prep;
 	size_t no, n;
 	size_t mo, m;
 	// состояние
 	void* state;
 	word* x;				/* [m] личный ключ */
 	word* y;				/* [n] открытый ключ */
-	qr_o* qr;				/* описание кольца Монтгомери */
+	const qr_o* qr;			/* описание кольца Монтгомери */
 	void* stack;
-	// проверить params
-	if (!memIsValid(params, sizeof(pfok_params)))
+	// проверить prep
+	if (!pfokPrepIsValid(st))
 		return ERR_BAD_INPUT;
-	// работоспособные параметры?
-	if (!pfokIsOperableParams(params))
-		return ERR_BAD_PARAMS;
 	// размерности
-	no = O_OF_B(params->l), n = W_OF_B(params->l);
-	mo = O_OF_B(params->r), m = W_OF_B(params->r);
+	no = O_OF_B(st->params->l), n = W_OF_B(st->params->l);
+	mo = O_OF_B(st->params->r), m = W_OF_B(st->params->r);
 	// проверить остальные входные данные
 	if (!memIsValid(privkey, mo) || !memIsValid(pubkey, no))
 		return ERR_BAD_INPUT;
 	// создать состояние
+	qr = pfokPrepQr(st);
 	state = blobCreate(
-		O_OF_W(n) + O_OF_W(m) + zmMontCreate_keep(no) +  
-		utilMax(2,
-			zmMontCreate_deep(no),
-			qrPower_deep(n, n, zmMontCreate_deep(no))));
+		O_OF_W(n) + O_OF_W(m) + pfokPowerG_deep(n, m, qr->deep));
 	if (state == 0)
 		return ERR_OUTOFMEMORY;
 	// раскладка состояния
 	x = (word*)state;
 	y = x + m;
-	qr = (qr_o*)(y + n);
-	stack = (octet*)qr + zmMontCreate_keep(no);
-	// построить кольцо Монтгомери
-	zmMontCreate(qr, params->p, no, params->l + 2, stack);
+	stack = y + n;
 	// x <- privkey
 	wwFrom(x, privkey, mo);
-	if (wwGetBits(x, params->r, B_OF_W(m) - params->r) != 0)
+	if (wwGetBits(x, st->params->r, B_OF_W(m) - st->params->r) != 0)
 	{
 		blobClose(state);
 		return ERR_BAD_PRIVKEY;
 	}
 	// y <- g^(x)
-	wwFrom(y, params->g, no);
-	qrPower(y, y, x, m, qr, stack);
+	pfokPowerG(y, x, m, st, stack);
 	// выгрузить открытый ключ
 	qrTo(pubkey, y, qr, stack);
 	// все нормально
@@ -797,55 +968,60 @@ err_t pfokCalcPubkey(octet pubkey[], const pfok_params* params,
 	return ERR_OK;
 }
 
+err_t pfokCalcPubkey(octet pubkey[], const pfok_params* params, 
+	const octet privkey[])
+{
+	err_t code;
+	void* prep;
+	code = pfokPrepTmp(&prep, params);
+	ERR_CALL_CHECK(code);
+	code = pfokCalcPubkeyPrep(pubkey, prep, privkey);
+	blobClose(prep);
+	return code;
+}
+
 /*
 *******************************************************************************
 Протоколы
 *******************************************************************************
 */
 
-err_t pfokDH(octet sharekey[], const pfok_params* params, 
-	const octet privkey[], const octet pubkey[])
+err_t pfokDHPrep(octet sharekey[], const void* prep, const octet privkey[], 
+	const octet pubkey[])
 {
+	const pfok_prep_st* st = (const pfok_prep_st*)prep;
 	size_t no, n;
 	size_t mo, m;
 	// состояние
 	void* state;
 	word* x;				/* [m] личный ключ */
 	word* y;				/* [n] открытый ключ визави */
-	qr_o* qr;				/* описание кольца Монтгомери */
+	const qr_o* qr;			/* описание кольца Монтгомери */
 	void* stack;
-	// проверить params
-	if (!memIsValid(params, sizeof(pfok_params)))
+	// проверить prep
+	if (!pfokPrepIsValid(st))
 		return ERR_BAD_INPUT;
-	// работоспособные параметры?
-	if (!pfokIsOperableParams(params))
-		return ERR_BAD_PARAMS;
 	// размерности
-	no = O_OF_B(params->l), n = W_OF_B(params->l);
-	mo = O_OF_B(params->r), m = W_OF_B(params->r);
+	no = O_OF_B(st->params->l), n = W_OF_B(st->params->l);
+	mo = O_OF_B(st->params->r), m = W_OF_B(st->params->r);
 	// проверить остальные входные данные
 	if (!memIsValid(privkey, mo) || 
 		!memIsValid(pubkey, no) ||
-		!memIsValid(sharekey, O_OF_B(params->n)))
+		!memIsValid(sharekey, O_OF_B(st->params->n)))
 		return ERR_BAD_INPUT;
 	// создать состояние
+	qr = pfokPrepQr(st);
 	state = blobCreate(
-		O_OF_W(n) + O_OF_W(m) + zmMontCreate_keep(no) +  
-		utilMax(2,
-			zmMontCreate_deep(no),
-			qrPower_deep(n, n, zmMontCreate_deep(no))));
+		O_OF_W(n) + O_OF_W(m) + qrPower_deep(n, m, qr->deep));
 	if (state == 0)
 		return ERR_OUTOFMEMORY;
 	// раскладка состояния
 	x = (word*)state;
 	y = x + m;
-	qr = (qr_o*)(y + n);
-	stack = (octet*)qr + zmMontCreate_keep(no);
-	// построить кольцо Монтгомери
-	zmMontCreate(qr, params->p, no, params->l + 2, stack);
+	stack = y + n;
 	// x <- privkey
 	wwFrom(x, privkey, mo);
-	if (wwGetBits(x, params->r, B_OF_W(m) - params->r) != 0)
+	if (wwGetBits(x, st->params->r, B_OF_W(m) - st->params->r) != 0)
 	{
 		blobClose(state);
 		return ERR_BAD_PRIVKEY;
@@ -860,18 +1036,31 @@ err_t pfokDH(octet sharekey[], const pfok_params* params,
 	qrPower(y, y, x, m, qr, stack);
 	// выгрузить открытый ключ
 	qrTo((octet*)y, y, qr, stack);
-	memCopy(sharekey, y, O_OF_B(params->n));
-	if (params->n % 8)
-		sharekey[params->n / 8] &= (octet)255 >> (8 - params->n % 8);
+	memCopy(sharekey, y, O_OF_B(st->params->n));
+	if (st->params->n % 8)
+		sharekey[st->params->n / 8] &= (octet)255 >> (8 - st->params->n % 8);
 	// все нормально
 	blobClose(state);
 	return ERR_OK;
 }
 
-err_t pfokMTI(octet sharekey[], const pfok_params* params, 
+err_t pfokDH(octet sharekey[], const pfok_params* params, 
+	const octet privkey[], const octet pubkey[])
+{
+	err_t code;
+	void* prep;
+	code = pfokPrepTmp(&prep, params);
+	ERR_CALL_CHECK(code);
+	code = pfokDHPrep(sharekey, prep, privkey, pubkey);
+	blobClose(prep);
+	return code;
+}
+
+err_t pfokMTIPrep(octet sharekey[], const void* prep, 
 	const octet privkey[], const octet privkey1[], 
 	const octet pubkey[], const octet pubkey1[])
 {
+	const pfok_prep_st* st = (const pfok_prep_st*)prep;
 	size_t no, n;
 	size_t mo, m;
 	// состояние
@@ -880,30 +1069,25 @@ err_t pfokMTI(octet sharekey[], const pfok_params* params,
 	word* u;				/* [m] одноразовый личный ключ */
 	word* y;				/* [n] открытый ключ визави */
 	word* v;				/* [n] одноразовый открытый ключ визави */
-	qr_o* qr;				/* описание кольца Монтгомери */
+	const qr_o* qr;			/* описание кольца Монтгомери */
 	void* stack;
-	// проверить params
-	if (!memIsValid(params, sizeof(pfok_params)))
+	// проверить prep
+	if (!pfokPrepIsValid(st))
 		return ERR_BAD_INPUT;
-	// работоспособные параметры?
-	if (!pfokIsOperableParams(params))
-		return ERR_BAD_PARAMS;
 	// размерности
-	no = O_OF_B(params->l), n = W_OF_B(params->l);
-	mo = O_OF_B(params->r), m = W_OF_B(params->r);
+	no = O_OF_B(st->params->l), n = W_OF_B(st->params->l);
+	mo = O_OF_B(st->params->r), m = W_OF_B(st->params->r);
 	// проверить остальные входные данные
 	if (!memIsValid(privkey, mo) || 
 		!memIsValid(privkey1, mo) || 
 		!memIsValid(pubkey, no) ||
 		!memIsValid(pubkey1, no) ||
-		!memIsValid(sharekey, O_OF_B(params->n)))
+		!memIsValid(sharekey, O_OF_B(st->params->n)))
 		return ERR_BAD_INPUT;
 	// создать состояние
+	qr = pfokPrepQr(st);
 	state = blobCreate(
-		2 * O_OF_W(n) + 2 * O_OF_W(m) + zmMontCreate_keep(no) +  
-		utilMax(2,
-			zmMontCreate_deep(no),
-			qrPower_deep(n, n, zmMontCreate_deep(no))));
+		2 * O_OF_W(n) + 2 * O_OF_W(m) + qrPower_deep(n, m, qr->deep));
 	if (state == 0)
 		return ERR_OUTOFMEMORY;
 	// раскладка состояния
@@ -911,15 +1095,12 @@ err_t pfokMTI(octet sharekey[], const pfok_params* params,
 	u = x + m;
 	y = u + m;
 	v = y + n;
-	qr = (qr_o*)(v + n);
-	stack = (octet*)qr + zmMontCreate_keep(no);
-	// построить кольцо Монтгомери
-	zmMontCreate(qr, params->p, no, params->l + 2, stack);
+	stack = v + n;
 	// x <- privkey, u <- privkey1
 	wwFrom(x, privkey, mo);
 	wwFrom(u, privkey1, mo);
-	if (wwGetBits(x, params->r, B_OF_W(m) - params->r) != 0 ||
-		wwGetBits(u, params->r, B_OF_W(m) - params->r) != 0)
+	if (wwGetBits(x, st->params->r, B_OF_W(m) - st->params->r) != 0 ||
+		wwGetBits(u, st->params->r, B_OF_W(m) - st->params->r) != 0)
 	{
 		blobClose(state);
 		return ERR_BAD_PRIVKEY;
@@ -939,11 +1120,24 @@ err_t pfokMTI(octet sharekey[], const pfok_params* params,
 	// выгрузить открытый ключ
 	qrTo((octet*)y, y, qr, stack);
 	qrTo((octet*)v, v, qr, stack);
-	memCopy(sharekey, y, O_OF_B(params->n));
-	memXor2(sharekey, v, O_OF_B(params->n));
-	if (params->n % 8)
-		sharekey[params->n / 8] &= (octet)255 >> (8 - params->n % 8);
+	memCopy(sharekey, y, O_OF_B(st->params->n));
+	memXor2(sharekey, v, O_OF_B(st->params->n));
+	if (st->params->n % 8)
+		sharekey[st->params->n / 8] &= (octet)255 >> (8 - st->params->n % 8);
 	// все нормально
 	blobClose(state);
 	return ERR_OK;
 }
+
+err_t pfokMTI(octet sharekey[], const pfok_params* params, 
+	const octet privkey[], const octet privkey1[], 
+	const octet pubkey[], const octet pubkey1[])
+{
+	err_t code;
+	void* prep;
+	code = pfokPrepTmp(&prep, params);
+	ERR_CALL_CHECK(code);
+	code = pfokMTIPrep(sharekey, prep, privkey, privkey1, pubkey, pubkey1);
+	blobClose(prep);
+	return code;
+}
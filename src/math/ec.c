@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.03.04
-\version 2015.11.09
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -111,6 +111,11 @@ Springer, 2004].
 Предварительно рассчитываются малые кратные a: сначала 2a, а затем
 точки a[i] = a[i - 1] + 2a, i = 1,\ldots, 2^{w - 1} - 2, где a[0] = a.
 
+В функции ec->dbla, ec->adda и ec->suba передается исходная аффинная 
+точка a, а не первые 2n слов ее проективного представления: в некоторых 
+координатах (например, в лямбда-координатах для кривых над GF(2^m))
+эти слова не совпадают с аффинными координатами.
+
 При использовании проективных координат имеются три стратегии:
 1)	w = 2 и малые кратные вообще не рассчитываются;
 2)	w > 2 и малые кратные рассчитываются в аффинных координатах;
@@ -135,23 +140,27 @@ Springer, 2004].
 
 В практических диапазонах размерностей при использовании наиболее эффективных
 координат (якобиановых для кривых над GF(p) и Лопеса -- Дахаба для кривых 
-над GF(2^m)) первые две стратегии являются проигрышными. Реализована только 
-третья стратегия. 
+над GF(2^m)) первые две стратегии являются проигрышными. Из них реализована 
+только третья стратегия.
 
 Оптимальная длина окна выбирается как решение следующей оптимизационной 
 задачи:
 	(2^{w - 2} - 2) + l / (w + 1) -> min.
 
-\todo Усилить вторую стратегию. Рассчитать малые кратные в проективных 
-координатах, а затем быстро перейти к аффинным координатам с помощью 
-трюка Монтгомери [Algorithm 11.15 Simultaneous inversion, CohenFrey, p. 209]:
-	U_1 <- Z_1
-	for t = 2,..., T: U_t <- U_{t-1} Z_t
-	V <- U_T^{-1}
-	for t = T,..., 2: 
-		Z_t^{-1} <- V U_{t-1}
-		V <- V Z_t
-	Z_1^{-1} <- V
+Если описание ec поддерживает специальный алгоритм расчета кратных точек 
+(ec->mul != 0), то в ecMul() сначала вызывается этот алгоритм.
+
+Если описание ec поддерживает пакетный экспорт в аффинные точки
+(ec->toan != 0), то дополнительно используется стратегия
+4)	w > 2, малые кратные рассчитываются в проективных координатах, а затем 
+	одновременно переводятся в аффинные:
+	c4(l, w) = 1(P <- 2A) + (2^{w-2} - 2)(P <- P + P) + 
+		2^{w-2}(A <- P)* + l/(w + 1)(P <- P + A),
+	где (A <- P)* -- усредненное время работы функции ec->toan в расчете 
+	на одну точку. При переходе к аффинным координатам обратные элементы 
+	находятся одновременно с помощью трюка Монтгомери [Algorithm 11.15 
+	Simultaneous inversion, CohenFrey, p. 209]: одно обращение и 
+	O(2^{w-2}) умножений заменяют 2^{w-2} обращений.
 *******************************************************************************
 */
 
@@ -166,45 +175,50 @@ static size_t ecNAFWidth(size_t l)
 	return 3;
 }
 
-bool_t ecMulA(word b[], const word a[], const ec_o* ec, const word d[],
-	size_t m, void* stack)
+static void ecMulNAF(word b[], const word a[], const ec_o* ec, 
+	const word naf[], size_t naf_size, size_t naf_width, void* stack)
 {
 	const size_t n = ec->f->n;
-	const size_t naf_width = ecNAFWidth(B_OF_W(m));
 	const size_t naf_count = SIZE_1 << (naf_width - 2);
 	const word naf_hi = WORD_1 << (naf_width - 1);
-	register size_t naf_size;
+	register bool_t affine;
 	register size_t i;
 	register word w;
 	// переменные в stack
-	word* naf;			/* NAF */
-	word* t;			/* вспомогательная точка */
 	word* pre;			/* pre[i] = (2i + 1)a (naf_count элементов) */
+	word* prea;			/* pre[i] в аффинных координатах */
+	word* aa;			/* копия a */
 	// pre
 	ASSERT(ecIsOperable(ec));
-	// раскладка stack
-	naf = (word*)stack;
-	t = naf + 2 * m + 1;
-	pre = t + ec->d * n;
-	stack = pre + naf_count * ec->d * n;
-	// расчет NAF
+	ASSERT(a == b || wwIsDisjoint2(a, 2 * n, b, ec->d * n));
 	ASSERT(naf_width >= 3);
-	naf_size = wwNAF(naf, d, m, naf_width);
+	// раскладка stack
+	pre = (word*)stack;
+	prea = pre + naf_count * ec->d * n;
+	aa = prea + naf_count * 2 * n;
+	stack = aa + 2 * n;
 	// d == O => b <- O
 	if (naf_size == 0)
-		return FALSE;
+	{
+		ecSetO(b, ec);
+		return;
+	}
+	// aa <- a (b и a могут пересекаться)
+	wwCopy(aa, a, 2 * n);
 	// pre[0] <- a
-	ecFromA(pre, a, ec, stack);
-	// расчет pre[i]: t <- 2a, pre[i] <- t + pre[i - 1]
+	ecFromA(pre, aa, ec, stack);
+	// расчет pre[i]: b <- 2a, pre[i] <- b + pre[i - 1]
 	ASSERT(naf_count > 1);
-	ecDblA(t, pre, ec, stack);
-	ecAddA(pre + ec->d * n, t, pre, ec, stack);
+	ecDblA(b, aa, ec, stack);
+	ecAddA(pre + ec->d * n, b, aa, ec, stack);
 	for (i = 2; i < naf_count; ++i)
-		ecAdd(pre + i * ec->d * n, t, pre + (i - 1) * ec->d * n, ec, stack);
-	// t <- a[naf[l - 1]]
+		ecAdd(pre + i * ec->d * n, b, pre + (i - 1) * ec->d * n, ec, stack);
+	// к аффинным координатам (стратегия 4)
+	affine = ec->toan != 0 && ecToAN(prea, pre, naf_count, ec, stack);
+	// b <- a[naf[l - 1]]
 	w = wwGetBits(naf, 0, naf_width);
 	ASSERT((w & 1) == 1 && (w & naf_hi) == 0);
-	wwCopy(t, pre + (w >> 1) * ec->d * n, ec->d * n);
+	wwCopy(b, pre + (w >> 1) * ec->d * n, ec->d * n);
 	// цикл по символам NAF
 	i = naf_width;
 	while (--naf_size)
@@ -212,40 +226,119 @@ bool_t ecMulA(word b[], const word a[], const ec_o* ec, const word d[],
 		w = wwGetBits(naf, i, naf_width);
 		if (w & 1)
 		{
-			// t <- 2 t
-			ecDbl(t, t, ec, stack);
-			// t <- t \pm pre[naf[w]]
-			if (w == 1)
-				ecAddA(t, t, pre, ec, stack);
+			// b <- 2 b
+			ecDbl(b, b, ec, stack);
+			// b <- b \pm pre[naf[w]]
+			if (affine)
+			{
+				if (w & naf_hi)
+					ecSubA(b, b, prea + ((w ^ naf_hi) >> 1) * 2 * n, ec,
+						stack);
+				else
+					ecAddA(b, b, prea + (w >> 1) * 2 * n, ec, stack);
+			}
+			else if (w == 1)
+				ecAddA(b, b, aa, ec, stack);
 			else if (w == (naf_hi ^ 1))
-				ecSubA(t, t, pre, ec, stack);
+				ecSubA(b, b, aa, ec, stack);
 			else if (w & naf_hi)
-				ecSub(t, t, pre + ((w ^ naf_hi) >> 1) * ec->d * n, ec, stack);
+				ecSub(b, b, pre + ((w ^ naf_hi) >> 1) * ec->d * n, ec, stack);
 			else
-				ecAdd(t, t, pre + (w >> 1) * ec->d * n, ec, stack);
+				ecAdd(b, b, pre + (w >> 1) * ec->d * n, ec, stack);
 			// к следующему разряду naf
 			i += naf_width;
 		}
 		else
-			ecDbl(t, t, ec, stack), ++i;
+			ecDbl(b, b, ec, stack), ++i;
 	}
 	// очистка
+	affine = 0;
 	w = 0;
 	i = 0;
-	// к аффинным координатам
-	return ecToA(b, t, ec, stack);
+	wwSetZero(aa, 2 * n);
 }
 
-size_t ecMulA_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m)
+void ecMul(word b[], const word a[], const ec_o* ec, const word d[],
+	size_t m, void* stack)
+{
+	const size_t naf_width = ecNAFWidth(B_OF_W(m));
+	size_t naf_size;
+	// переменные в stack
+	word* naf = (word*)stack;
+	stack = naf + 2 * m + 1;
+	// pre
+	ASSERT(ecIsOperable(ec));
+	// специальный алгоритм?
+	if (ecMulSpec(b, a, ec, d, m, naf))
+		return;
+	// расчет NAF
+	naf_size = wwNAF(naf, d, m, naf_width);
+	// b <- d a
+	ecMulNAF(b, a, ec, naf, naf_size, naf_width, stack);
+	// очистка
+	naf_size = 0;
+}
+
+size_t ecMul_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m)
 {
 	const size_t naf_width = ecNAFWidth(B_OF_W(m));
 	const size_t naf_count = SIZE_1 << (naf_width - 2);
 	return O_OF_W(2 * m + 1) + 
-		O_OF_W(ec_d * n) + 
 		O_OF_W(ec_d * n * naf_count) + 
+		O_OF_W(2 * n * naf_count) + 
+		O_OF_W(2 * n) +
 		ec_deep;
 }
 
+void ecMulN(word b[], const word a[], size_t count, const ec_o* ec, 
+	const word d[], size_t m, void* stack)
+{
+	const size_t n = ec->f->n;
+	const size_t naf_width = ecNAFWidth(B_OF_W(m));
+	size_t naf_size;
+	size_t i;
+	// переменные в stack
+	word* naf = (word*)stack;
+	stack = naf + 2 * m + 1;
+	// pre
+	ASSERT(ecIsOperable(ec));
+	ASSERT(wwIsDisjoint2(a, 2 * n * count, b, ec->d * n * count));
+	// расчет NAF (один раз)
+	naf_size = wwNAF(naf, d, m, naf_width);
+	// b[i] <- d a[i]
+	for (i = 0; i < count; ++i)
+		ecMulNAF(b + ec->d * n * i, a + 2 * n * i, ec, naf, naf_size, 
+			naf_width, stack);
+	// очистка
+	naf_size = 0;
+}
+
+size_t ecMulN_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m)
+{
+	return ecMul_deep(n, ec_d, ec_deep, m);
+}
+
+bool_t ecMulA(word b[], const word a[], const ec_o* ec, const word d[],
+	size_t m, void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t = (word*)stack;
+	stack = t + ec->d * n;
+	// pre
+	ASSERT(ecIsOperable(ec));
+	// t <- d a
+	ecMul(t, a, ec, d, m, stack);
+	// к аффинным координатам
+	return ecToA(b, t, ec, stack);
+}
+
+size_t ecMulA_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m)
+{
+	return O_OF_W(ec_d * n) + 
+		ecMul_deep(n, ec_d, ec_deep, m);
+}
+
 /*
 *******************************************************************************
 Имеет порядок?
@@ -280,14 +373,24 @@ Elliptic Curve Cryptography, Springer, 2004] (interleaving with NAF).
 Сложность алгоритма:
 	max l[i](P <- 2P) + \sum {i=1}^k
 		[1(P <- 2A) + (2^{w[i]-2}-2)(P <- P + P) + l[i]/(w[i]+1)(P <- P + P)].
+
+Если описание ec поддерживает специальный алгоритм расчета кратных точек
+(ec->mul != 0), то слагаемые d[i] a[i] рассчитываются по отдельности 
+с помощью этого алгоритма и затем складываются.
+
+Если описание ec поддерживает пакетный экспорт в аффинные точки, то 
+предвычисленные точки для всех a[i] одновременно переводятся в аффинные 
+координаты (одно обращение в базовом поле на все таблицы) и слагаемые
+l[i]/(w[i]+1)(P <- P + P) заменяются на l[i]/(w[i]+1)(P <- P + A).
 *******************************************************************************
 */
 
 bool_t ecAddMulA(word b[], const ec_o* ec, void* stack, size_t k, ...)
 {
 	const size_t n = ec->f->n;
+	register bool_t affine;
 	register word w;
-	size_t i, naf_max_size = 0;
+	size_t i, j, naf_max_size = 0, pre_count = 0;
 	va_list marker;
 	// переменные в stack
 	word* t;			/* проективная точка */
@@ -297,9 +400,32 @@ bool_t ecAddMulA(word b[], const ec_o* ec, void* stack, size_t k, ...)
 	size_t* naf_pos;	/* позиция в NAF-представлении */
 	word** naf;			/* NAF */
 	word** pre;			/* предвычисленные точки */
+	word** prea;		/* предвычисленные точки в аффинных координатах */
+	const word** as;	/* слагаемые a[i] */
 	// pre
 	ASSERT(ecIsOperable(ec));
 	ASSERT(k > 0);
+	// специальный алгоритм: t <- \sum d[i] a[i]
+	if (ec->mul != 0)
+	{
+		word* s;
+		t = (word*)stack;
+		s = t + ec->d * n;
+		va_start(marker, k);
+		for (i = 0; i < k; ++i)
+		{
+			const word* a = va_arg(marker, const word*);
+			const word* d = va_arg(marker, const word*);
+			size_t m = va_arg(marker, size_t);
+			if (!ec->mul(i ? s : t, a, ec, d, m, s + ec->d * n))
+				break;
+			if (i)
+				ecAdd(t, t, s, ec, s + ec->d * n);
+		}
+		va_end(marker);
+		if (i == k)
+			return ecToA(b, t, ec, s);
+	}
 	// раскладка stack
 	t = (word*)stack;
 	m = (size_t*)(t + ec->d * n);
@@ -308,16 +434,16 @@ bool_t ecAddMulA(word b[], const ec_o* ec, void* stack, size_t k, ...)
 	naf_pos = naf_size + k;
 	naf = (word**)(naf_pos + k);
 	pre = naf + k;
-	stack = pre + k;
-	// обработать параметры (a[i], d[i], m[i])
+	prea = pre + k;
+	as = (const word**)(prea + k);
+	stack = as + k;
+	// обработать параметры (d[i], m[i])
 	va_start(marker, k);
 	for (i = 0; i < k; ++i)
 	{
-		const word* a;
 		const word* d;
-		size_t naf_count, j;
-		// a <- a[i]
-		a = va_arg(marker, const word*);
+		// пропустить a[i]
+		va_arg(marker, const word*);
 		// d <- d[i]
 		d = va_arg(marker, const word*);
 		// прочитать m[i]
@@ -326,27 +452,49 @@ bool_t ecAddMulA(word b[], const ec_o* ec, void* stack, size_t k, ...)
 		m[i] = wwWordSize(d, m[i]);
 		// расчет naf[i]
 		naf_width[i] = ecNAFWidth(B_OF_W(m[i]));
-		naf_count = SIZE_1 << (naf_width[i] - 2);
 		naf[i] = (word*)stack;
 		stack = naf[i] + 2 * m[i] + 1;
 		naf_size[i] = wwNAF(naf[i], d, m[i], naf_width[i]);
 		if (naf_size[i] > naf_max_size)
 			naf_max_size = naf_size[i];
 		naf_pos[i] = 0;
-		// резервируем память для pre[i]
-		pre[i] = (word*)stack;
-		stack = pre[i] + ec->d * n * naf_count;
+		// число предвычисленных точек
+		pre_count += SIZE_1 << (naf_width[i] - 2);
+	}
+	va_end(marker);
+	// резервируем память для pre[i] и prea[i] (подряд)
+	pre[0] = (word*)stack;
+	prea[0] = pre[0] + ec->d * n * pre_count;
+	stack = prea[0] + 2 * n * pre_count;
+	for (i = 1; i < k; ++i)
+	{
+		const size_t naf_count = SIZE_1 << (naf_width[i - 1] - 2);
+		pre[i] = pre[i - 1] + ec->d * n * naf_count;
+		prea[i] = prea[i - 1] + 2 * n * naf_count;
+	}
+	// обработать параметры a[i]
+	va_start(marker, k);
+	for (i = 0; i < k; ++i)
+	{
+		const size_t naf_count = SIZE_1 << (naf_width[i] - 2);
+		// as[i] <- a[i]
+		as[i] = va_arg(marker, const word*);
+		// пропустить d[i], m[i]
+		va_arg(marker, const word*);
+		va_arg(marker, size_t);
 		// pre[i][0] <- a[i]
-		ecFromA(pre[i], a, ec, stack);
+		ecFromA(pre[i], as[i], ec, stack);
 		// расчет pre[i][j]: t <- 2a[i], pre[i][j] <- t + pre[i][j - 1]
 		ASSERT(naf_count > 1);
-		ecDblA(t, pre[i], ec, stack);
-		ecAddA(pre[i] + ec->d * n, t, pre[i], ec, stack);
+		ecDblA(t, as[i], ec, stack);
+		ecAddA(pre[i] + ec->d * n, t, as[i], ec, stack);
 		for (j = 2; j < naf_count; ++j)
 			ecAdd(pre[i] + j * ec->d * n, t, pre[i] + (j - 1) * ec->d * n, ec,
 				stack);
 	}
 	va_end(marker);
+	// к аффинным координатам (все pre[i] одновременно)
+	affine = ec->toan != 0 && ecToAN(prea[0], pre[0], pre_count, ec, stack);
 	// t <- O
 	ecSetO(t, ec);
 	// основной цикл
@@ -368,10 +516,18 @@ bool_t ecAddMulA(word b[], const ec_o* ec, void* stack, size_t k, ...)
 			if (w & 1)
 			{
 				// t <- t \pm pre[i][naf[i][w]]
-				if (w == 1)
-					ecAddA(t, t, pre[i], ec, stack);
+				if (affine)
+				{
+					if (w & naf_hi)
+						w ^= naf_hi,
+						ecSubA(t, t, prea[i] + (w >> 1) * 2 * n, ec, stack);
+					else
+						ecAddA(t, t, prea[i] + (w >> 1) * 2 * n, ec, stack);
+				}
+				else if (w == 1)
+					ecAddA(t, t, as[i], ec, stack);
 				else if (w == (naf_hi ^ 1))
-					ecSubA(t, t, pre[i], ec, stack);
+					ecSubA(t, t, as[i], ec, stack);
 				else if (w & naf_hi)
 					w ^= naf_hi,
 					ecSub(t, t, pre[i] + (w >> 1) * ec->d * n, ec, stack);
@@ -385,6 +541,7 @@ bool_t ecAddMulA(word b[], const ec_o* ec, void* stack, size_t k, ...)
 		}
 	}
 	// очистка
+	affine = 0;
 	w = 0;
 	// к аффинным координатам
 	return ecToA(b, t, ec, stack);
@@ -396,7 +553,7 @@ size_t ecAddMulA_deep(size_t n, size_t ec_d, size_t ec_deep, size_t k, ...)
 	va_list marker;
 	ret = O_OF_W(ec_d * n);
 	ret += 4 * sizeof(size_t) * k;
-	ret += 2 * sizeof(word**) * k;
+	ret += 4 * sizeof(word**) * k;
 	va_start(marker, k);
 	for (i = 0; i < k; ++i)
 	{
@@ -405,6 +562,7 @@ size_t ecAddMulA_deep(size_t n, size_t ec_d, size_t ec_deep, size_t k, ...)
 		size_t naf_count = SIZE_1 << (naf_width - 2);
 		ret += O_OF_W(2 * m + 1);
 		ret += O_OF_W(ec_d * n * naf_count);
+		ret += O_OF_W(2 * n * naf_count);
 	}
 	va_end(marker);
 	ret += ec_deep;
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.06.26
-\version 2014.07.15
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -14,6 +14,7 @@ version 3. See Copyright Notices in bee2/info.h.
 #include "bee2/core/mem.h"
 #include "bee2/core/stack.h"
 #include "bee2/core/util.h"
+#include "bee2/core/word.h"
 #include "bee2/math/ec2.h"
 #include "bee2/math/gf2.h"
 #include "bee2/math/pri.h"
@@ -110,8 +111,9 @@ mdbl-2005-dl [Doche-Lange, 2005]. Сложность алгоритма:
 Поэтому для практически используемых размерностей l (39 <= l)
 первая и третья стратегии являются проигрышными. Реализована только стратегия 2.
 
-\todo Реализовать быстрые формулы для особенных B:
-B = 1 (кривые Коблица),	известен \sqrt{B}.
+\todo Реализовать быстрые формулы для особенного B: известен \sqrt{B}.
+Для B = 1 (кривые Коблица) ускорено только умножение точки на число 
+(см. ec2MulTNAF()).
 
 \todo Реализовать редакции функций с A \in {0, 1}.
 
@@ -532,8 +534,1064 @@ static size_t ec2SubALD_deep(size_t n, size_t f_deep)
 	return O_OF_W(2 * n) + ec2AddALD_deep(n, f_deep);
 }
 
-bool_t ec2CreateLD(ec_o* ec, const qr_o* f, const octet A[], const octet B[],
+/*
+*******************************************************************************
+Кривая в проективных лямбда-координатах (LAM):
+	x = X / Z, lambda = L / Z, где lambda = x + y / x,
+	O = (1 : 0 : 0),
+	-(X : L : Z) = (X : L + Z : Z).
+
+Лямбда-координаты предложены в работе [Oliveira T., Lopez J., Aranha D.,
+Rodriguez-Henriquez F. Two is the fastest prime: lambda coordinates for 
+binary elliptic curves. J. Cryptographic Engineering, 4 (2014), 3--17].
+В лямбда-координатах кривая описывается уравнением
+	(L^2 + LZ + A Z^2) X^2 = X^4 + B Z^4.
+
+Точка T = (0, \sqrt{B}) порядка 2 не имеет лямбда-представления 
+(деление на x = 0). Для нее используется условное представление 
+(0 : 1 : 1): проективные точки с X = 0 и Z != 0 считаются равными T.
+Функции удвоения и сложения распознают T среди результатов
+(T = 2P <=> T = 0, T = P + Q <=> A = 0 при B != 0), а сложение с T 
+выполняют через аффинные координаты (функция ec2AddAA()). Точки 
+подгруппы нечетного порядка никогда не приводят к T, и медленная ветвь 
+на них не выполняется.
+
+Аффинные точки (x, y) переводятся в лямбда-координаты без обращений: 
+	(x, y) -> (x^2 : x^2 + y : x).
+
+В функции ec2DblLAM() выполняется удвоение P <- 2P
+[Oliveira et al., 2014, формула (4)]:
+	T = L^2 + LZ + A Z^2,
+	X2 = T^2, Z2 = T Z^2, L2 = (XZ)^2 + X2 + T LZ + Z2.
+Сложность алгоритма:
+	4M + 4S + 1*A \approx 4M.
+
+В функции ec2DblALAM() выполняется удвоение P <- 2A. Используются 
+те же формулы для точки (x^2 : x^2 + y : x), для которой T = x^4 + B.
+Сложность алгоритма:
+	4M + 4S \approx 4M.
+
+В функции ec2AddLAM() выполняется сложение P <- P + P 
+[Oliveira et al., 2014, формула (3)]:
+	A = L1 Z2 + L2 Z1, B = (X1 Z2 + X2 Z1)^2,
+	X3 = A (X1 Z2) A (X2 Z1), 
+	L3 = (A (X2 Z1) + B)^2 + A B Z2 (L1 + Z1),
+	Z3 = A B Z2 Z1.
+Сложность алгоритма:
+	11M + 2S \approx 11M.
+
+В функции ec2AddALAM() выполняется сложение P <- P + A, где вторая точка 
+задана обычными аффинными координатами (x2, y2). Чтобы избежать расчета 
+lambda2 = x2 + y2 / x2, величина A умножается на x2:
+	A' = L1 x2 + (x2^2 + y2) Z1, B = (X1 + x2 Z1)^2,
+	X3 = (A' Z1)(A' X1), L3 = x2 (A' Z1 + B)^2 + A' B (L1 + Z1), 
+	Z3 = A' B Z1.
+Сложность алгоритма:
+	10M + 3S \approx 10M.
+
+По сравнению с LD-координатами сложение P <- P + P дешевле на 2M, 
+а остальные операции имеют сравнимую сложность. В ecMul() при 
+предвычислениях и в основном цикле используются именно сложения P <- P + P.
+*******************************************************************************
+*/
+
+// [3n]b <- [2n]a (P <- A)
+static bool_t ec2FromALAM(word b[], const word a[], const ec_o* ec,
 	void* stack)
+{
+	const size_t n = ec->f->n;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	ASSERT(ec2SeemsOnA(a, ec));
+	ASSERT(a == b || wwIsDisjoint2(a, 2 * n, b, 3 * n));
+	// xa == 0 => b <- T
+	if (qrIsZero(ecX(a), ec->f))
+	{
+		qrSetZero(ecX(b), ec->f);
+		qrSetUnity(ecY(b, n), ec->f);
+		qrSetUnity(ecZ(b, n), ec->f);
+		return TRUE;
+	}
+	// zb <- xa
+	qrCopy(ecZ(b, n), ecX(a), ec->f);
+	// xb <- xa^2
+	qrSqr(ecX(b), ecX(a), ec->f, stack);
+	// yb <- xb + ya
+	gf2Add(ecY(b, n), ecX(b), ecY(a, n), ec->f);
+	return TRUE;
+}
+
+// [2n]b <- [3n]a (A <- P)
+static bool_t ec2ToALAM(word b[], const word a[], const ec_o* ec, 
+	void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t1 = (word*)stack;
+	word* t2 = t1 + n;
+	stack = t2 + n;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	ASSERT(ec2SeemsOn3(a, ec));
+	ASSERT(a == b || wwIsDisjoint2(a, 3 * n, b, 2 * n));
+	// a == O => b <- O
+	if (qrIsZero(ecZ(a, n), ec->f))
+		return FALSE;
+	// a == T => b <- (0, B^{2^{m - 1}})
+	if (qrIsZero(ecX(a), ec->f))
+	{
+		size_t m = gf2Deg(ec->f);
+		qrSetZero(ecX(b), ec->f);
+		qrCopy(ecY(b, n), ec->B, ec->f);
+		while (--m)
+			qrSqr(ecY(b, n), ecY(b, n), ec->f, stack);
+		return TRUE;
+	}
+	// t1 <- za^{-1}
+	qrInv(t1, ecZ(a, n), ec->f, stack);
+	// t2 <- ya t1 [lambda]
+	qrMul(t2, ecY(a, n), t1, ec->f, stack);
+	// xb <- xa t1
+	qrMul(ecX(b), ecX(a), t1, ec->f, stack);
+	// yb <- xb (t2 + xb)
+	gf2Add2(t2, ecX(b), ec->f);
+	qrMul(ecY(b, n), ecX(b), t2, ec->f, stack);
+	// b != O
+	return TRUE;
+}
+
+static size_t ec2ToALAM_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(2 * n) + f_deep;
+}
+
+// [3n]b <- -[3n]a (P <- -P)
+static void ec2NegLAM(word b[], const word a[], const ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	ASSERT(ec2SeemsOn3(a, ec));
+	ASSERT(wwIsSameOrDisjoint(a, b, 3 * n));
+	// b <- (xa, ya + za, za)
+	wwCopy(b, a, 3 * n);
+	gf2Add2(ecY(b, n), ecZ(b, n), ec->f);
+}
+
+// [3n]b <- 2[3n]a (P <- 2P)
+static void ec2DblLAM(word b[], const word a[], const ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t1 = (word*)stack;
+	word* t2 = t1 + n;
+	word* t3 = t2 + n;
+	word* t4 = t3 + n;
+	stack = t4 + n;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	ASSERT(ec2SeemsOn3(a, ec));
+	ASSERT(wwIsSameOrDisjoint(a, b, 3 * n));
+	// za == 0 или xa == 0 (a == T)? => b <- O
+	if (qrIsZero(ecZ(a, n), ec->f) || qrIsZero(ecX(a), ec->f))
+	{
+		qrSetZero(ecZ(b, n), ec->f);
+		return;
+	}
+	// t1 <- ya za [LZ]
+	qrMul(t1, ecY(a, n), ecZ(a, n), ec->f, stack);
+	// t2 <- za^2 [Z^2]
+	qrSqr(t2, ecZ(a, n), ec->f, stack);
+	// t3 <- ya^2 + t1 + A t2 [T]
+	qrSqr(t3, ecY(a, n), ec->f, stack);
+	gf2Add2(t3, t1, ec->f);
+	if (qrIsUnity(ec->A, ec->f))
+		gf2Add2(t3, t2, ec->f);
+	else if (!qrIsZero(ec->A, ec->f))
+	{
+		qrMul(t4, ec->A, t2, ec->f, stack);
+		gf2Add2(t3, t4, ec->f);
+	}
+	// t3 == 0 => b <- T
+	if (qrIsZero(t3, ec->f))
+	{
+		qrSetZero(ecX(b), ec->f);
+		qrSetUnity(ecY(b, n), ec->f);
+		qrSetUnity(ecZ(b, n), ec->f);
+		return;
+	}
+	// t4 <- (xa za)^2 [(XZ)^2]
+	qrMul(t4, ecX(a), ecZ(a, n), ec->f, stack);
+	qrSqr(t4, t4, ec->f, stack);
+	// zb <- t3 t2 [T Z^2]
+	qrMul(ecZ(b, n), t3, t2, ec->f, stack);
+	// xb <- t3^2 [T^2]
+	qrSqr(ecX(b), t3, ec->f, stack);
+	// t1 <- t3 t1 [T LZ]
+	qrMul(t1, t3, t1, ec->f, stack);
+	// yb <- t4 + xb + t1 + zb
+	gf2Add(ecY(b, n), t4, ecX(b), ec->f);
+	gf2Add2(ecY(b, n), t1, ec->f);
+	gf2Add2(ecY(b, n), ecZ(b, n), ec->f);
+}
+
+static size_t ec2DblLAM_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(4 * n) + f_deep;
+}
+
+// [3n]b <- 2[2n]a (P <- 2A)
+static void ec2DblALAM(word b[], const word a[], const ec_o* ec, 
+	void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t1 = (word*)stack;
+	word* t2 = t1 + n;
+	word* t3 = t2 + n;
+	word* t4 = t3 + n;
+	stack = t4 + n;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	ASSERT(ec2SeemsOnA(a, ec));
+	ASSERT(a == b || wwIsDisjoint2(a, 2 * n, b, 3 * n));
+	// xa == 0? => b <- O
+	if (qrIsZero(ecX(a), ec->f))
+	{
+		qrSetZero(ecZ(b, n), ec->f);
+		return;
+	}
+	// t1 <- xa^2 [X = Z^2]
+	qrSqr(t1, ecX(a), ec->f, stack);
+	// t2 <- (t1 + ya) xa [LZ]
+	gf2Add(t2, t1, ecY(a, n), ec->f);
+	qrMul(t2, t2, ecX(a), ec->f, stack);
+	// t3 <- (t1 xa)^2 [(XZ)^2]
+	qrMul(t3, t1, ecX(a), ec->f, stack);
+	qrSqr(t3, t3, ec->f, stack);
+	// t4 <- t1^2 + B [T]
+	qrSqr(t4, t1, ec->f, stack);
+	gf2Add2(t4, ec->B, ec->f);
+	// t4 == 0 => b <- T
+	if (qrIsZero(t4, ec->f))
+	{
+		qrSetZero(ecX(b), ec->f);
+		qrSetUnity(ecY(b, n), ec->f);
+		qrSetUnity(ecZ(b, n), ec->f);
+		return;
+	}
+	// zb <- t4 t1 [T Z^2]
+	qrMul(ecZ(b, n), t4, t1, ec->f, stack);
+	// xb <- t4^2 [T^2]
+	qrSqr(ecX(b), t4, ec->f, stack);
+	// t2 <- t4 t2 [T LZ]
+	qrMul(t2, t4, t2, ec->f, stack);
+	// yb <- t3 + xb + t2 + zb
+	gf2Add(ecY(b, n), t3, ecX(b), ec->f);
+	gf2Add2(ecY(b, n), t2, ec->f);
+	gf2Add2(ecY(b, n), ecZ(b, n), ec->f);
+}
+
+static size_t ec2DblALAM_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(4 * n) + f_deep;
+}
+
+// [3n]c <- [3n]a + [2n]b через аффинные координаты (a != O)
+static void ec2AddALAMSlow(word c[], const word a[], const word b[],
+	const ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t1 = (word*)stack;
+	word* t2 = t1 + 2 * n;
+	stack = t2 + 2 * n;
+	// pre
+	ASSERT(!qrIsZero(ecZ(a, n), ec->f));
+	// t1 <- a
+	ec2ToALAM(t1, a, ec, stack);
+	// c <- t1 + b
+	if (ec2AddAA(t2, t1, b, ec, stack))
+		ec2FromALAM(c, t2, ec, stack);
+	else
+		qrSetZero(ecZ(c, n), ec->f);
+}
+
+static size_t ec2AddALAMSlow_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(4 * n) +
+		utilMax(2,
+			ec2ToALAM_deep(n, f_deep),
+			ec2AddAA_deep(n, f_deep));
+}
+
+// [3n]c <- [3n]a + [3n]b (P <- P + P)
+static void ec2AddLAM(word c[], const word a[], const word b[],
+	const ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t1 = (word*)stack;
+	word* t2 = t1 + n;
+	word* t3 = t2 + n;
+	word* t4 = t3 + n;
+	stack = t4 + n;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	ASSERT(ec2SeemsOn3(a, ec));
+	ASSERT(ec2SeemsOn3(b, ec));
+	ASSERT(wwIsSameOrDisjoint(a, c, 3 * n));
+	ASSERT(wwIsSameOrDisjoint(b, c, 3 * n));
+	// a == O => c <- b
+	if (qrIsZero(ecZ(a, n), ec->f))
+	{
+		wwCopy(c, b, 3 * n);
+		return;
+	}
+	// b == O => c <- a
+	if (qrIsZero(ecZ(b, n), ec->f))
+	{
+		wwCopy(c, a, 3 * n);
+		return;
+	}
+	// a == T или b == T => сложение через аффинные координаты
+	if (qrIsZero(ecX(a), ec->f) || qrIsZero(ecX(b), ec->f))
+	{
+		ec2ToALAM(t1, b, ec, stack);
+		ec2AddALAMSlow(c, a, t1, ec, t1 + 2 * n);
+		return;
+	}
+	// t1 <- xa zb [X1 Z2]
+	qrMul(t1, ecX(a), ecZ(b, n), ec->f, stack);
+	// t2 <- xb za [X2 Z1]
+	qrMul(t2, ecX(b), ecZ(a, n), ec->f, stack);
+	// t3 <- ya zb + yb za [A]
+	qrMul(t3, ecY(a, n), ecZ(b, n), ec->f, stack);
+	qrMul(t4, ecY(b, n), ecZ(a, n), ec->f, stack);
+	gf2Add2(t3, t4, ec->f);
+	// t4 <- (t1 + t2)^2 [B]
+	gf2Add(t4, t1, t2, ec->f);
+	qrSqr(t4, t4, ec->f, stack);
+	// t4 == 0 => a == \pm b
+	if (qrIsZero(t4, ec->f))
+	{
+		// t3 == 0 => a == b => c <- 2a
+		if (qrIsZero(t3, ec->f))
+			ec2DblLAM(c, a, ec, stack);
+		// t3 != 0 => a == -b => c <- O
+		else
+			qrSetZero(ecZ(c, n), ec->f);
+		return;
+	}
+	// t3 == 0 => c <- T
+	if (qrIsZero(t3, ec->f))
+	{
+		qrSetZero(ecX(c), ec->f);
+		qrSetUnity(ecY(c, n), ec->f);
+		qrSetUnity(ecZ(c, n), ec->f);
+		return;
+	}
+	// t2 <- t3 t2 [A X2 Z1]
+	qrMul(t2, t3, t2, ec->f, stack);
+	// t1 <- t3 t1 [A X1 Z2]
+	qrMul(t1, t3, t1, ec->f, stack);
+	// xc <- t1 t2 [A X1 Z2 A X2 Z1]
+	qrMul(ecX(c), t1, t2, ec->f, stack);
+	// t2 <- (t2 + t4)^2 [(A X2 Z1 + B)^2]
+	gf2Add2(t2, t4, ec->f);
+	qrSqr(t2, t2, ec->f, stack);
+	// t3 <- t3 t4 zb [A B Z2]
+	qrMul(t3, t3, t4, ec->f, stack);
+	qrMul(t3, t3, ecZ(b, n), ec->f, stack);
+	// t1 <- (ya + za) t3 [A B Z2 (L1 + Z1)]
+	gf2Add(t1, ecY(a, n), ecZ(a, n), ec->f);
+	qrMul(t1, t1, t3, ec->f, stack);
+	// yc <- t2 + t1
+	gf2Add(ecY(c, n), t2, t1, ec->f);
+	// zc <- t3 za [A B Z2 Z1]
+	qrMul(ecZ(c, n), t3, ecZ(a, n), ec->f, stack);
+}
+
+static size_t ec2AddLAM_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(4 * n) +
+		utilMax(3,
+			f_deep,
+			ec2DblLAM_deep(n, f_deep),
+			ec2AddALAMSlow_deep(n, f_deep));
+}
+
+// [3n]c <- [3n]a + [2n]b (P <- P + A)
+static void ec2AddALAM(word c[], const word a[], const word b[],
+	const ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t1 = (word*)stack;
+	word* t2 = t1 + n;
+	word* t3 = t2 + n;
+	word* t4 = t3 + n;
+	word* t5 = t4 + n;
+	stack = t5 + n;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	ASSERT(ec2SeemsOn3(a, ec));
+	ASSERT(ec2SeemsOnA(b, ec));
+	ASSERT(wwIsSameOrDisjoint(a,  c, 3 * n));
+	ASSERT(b == c || wwIsDisjoint2(b, 2 * n, c, 3 * n));
+	// a == O => c <- b
+	if (qrIsZero(ecZ(a, n), ec->f))
+	{
+		ec2FromALAM(c, b, ec, stack);
+		return;
+	}
+	// a == T или b == T => сложение через аффинные координаты
+	if (qrIsZero(ecX(a), ec->f) || qrIsZero(ecX(b), ec->f))
+	{
+		wwCopy(t1, b, 2 * n);
+		ec2AddALAMSlow(c, a, t1, ec, t1 + 2 * n);
+		return;
+	}
+	// t5 <- xb
+	qrCopy(t5, ecX(b), ec->f);
+	// t1 <- xb za
+	qrMul(t1, t5, ecZ(a, n), ec->f, stack);
+	// t2 <- (xa + t1)^2 [B]
+	gf2Add(t2, ecX(a), t1, ec->f);
+	qrSqr(t2, t2, ec->f, stack);
+	// t3 <- (xb^2 + yb) za + ya xb [A']
+	qrSqr(t3, t5, ec->f, stack);
+	gf2Add2(t3, ecY(b, n), ec->f);
+	qrMul(t3, t3, ecZ(a, n), ec->f, stack);
+	qrMul(t4, ecY(a, n), t5, ec->f, stack);
+	gf2Add2(t3, t4, ec->f);
+	// t2 == 0 => a == \pm b
+	if (qrIsZero(t2, ec->f))
+	{
+		// t3 == 0 => a == b => c <- 2b
+		if (qrIsZero(t3, ec->f))
+			ec2DblALAM(c, b, ec, stack);
+		// t3 != 0 => a == -b => c <- O
+		else
+			qrSetZero(ecZ(c, n), ec->f);
+		return;
+	}
+	// t3 == 0 => c <- T
+	if (qrIsZero(t3, ec->f))
+	{
+		qrSetZero(ecX(c), ec->f);
+		qrSetUnity(ecY(c, n), ec->f);
+		qrSetUnity(ecZ(c, n), ec->f);
+		return;
+	}
+	// t1 <- t3 za [A' Z1]
+	qrMul(t1, t3, ecZ(a, n), ec->f, stack);
+	// t4 <- t3 xa [A' X1]
+	qrMul(t4, t3, ecX(a), ec->f, stack);
+	// xc <- t1 t4
+	qrMul(ecX(c), t1, t4, ec->f, stack);
+	// t1 <- t5 (t1 + t2)^2 [x2 (A' Z1 + B)^2]
+	gf2Add2(t1, t2, ec->f);
+	qrSqr(t1, t1, ec->f, stack);
+	qrMul(t1, t1, t5, ec->f, stack);
+	// t3 <- t3 t2 [A' B]
+	qrMul(t3, t3, t2, ec->f, stack);
+	// t4 <- (ya + za) t3 [A' B (L1 + Z1)]
+	gf2Add(t4, ecY(a, n), ecZ(a, n), ec->f);
+	qrMul(t4, t4, t3, ec->f, stack);
+	// yc <- t1 + t4
+	gf2Add(ecY(c, n), t1, t4, ec->f);
+	// zc <- t3 za [A' B Z1]
+	qrMul(ecZ(c, n), t3, ecZ(a, n), ec->f, stack);
+}
+
+static size_t ec2AddALAM_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(5 * n) +
+		utilMax(3,
+			f_deep,
+			ec2DblALAM_deep(n, f_deep),
+			ec2AddALAMSlow_deep(n, f_deep));
+}
+
+// [3n]c <- [3n]a - [3n]b (P <- P - P)
+static void ec2SubLAM(word c[], const word a[], const word b[],
+	const ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t = (word*)stack;
+	stack = t + 3 * n;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	ASSERT(ec2SeemsOn3(a, ec));
+	ASSERT(ec2SeemsOn3(b, ec));
+	ASSERT(wwIsSameOrDisjoint(a, c, 3 * n));
+	ASSERT(wwIsSameOrDisjoint(b, c, 3 * n));
+	// t <- -b
+	ec2NegLAM(t, b, ec, stack);
+	// c <- a + t
+	ec2AddLAM(c, a, t, ec, stack);
+}
+
+static size_t ec2SubLAM_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(3 * n) + ec2AddLAM_deep(n, f_deep);
+}
+
+// [3n]c <- [3n]a - [2n]b (P <- P - A)
+static void ec2SubALAM(word c[], const word a[], const word b[],
+	const ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t = (word*)stack;
+	stack = t + 2 * n;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	ASSERT(ec2SeemsOn3(a, ec));
+	ASSERT(ec2SeemsOnA(b, ec));
+	ASSERT(wwIsSameOrDisjoint(a,  c, 3 * n));
+	ASSERT(b == c || wwIsDisjoint2(b, 2 * n, c, 3 * n));
+	// t <- -b
+	wwCopy(t, b, 2 * n);
+	gf2Add2(ecY(t, n), ecX(t), ec->f);
+	// c <- a + t
+	ec2AddALAM(c, a, t, ec, stack);
+}
+
+static size_t ec2SubALAM_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(2 * n) + ec2AddALAM_deep(n, f_deep);
+}
+
+/*
+*******************************************************************************
+Кривые Коблица
+
+Кривая y^2 + xy = x^3 + A x^2 + 1, A \in {0, 1}, определена над GF(2), 
+и на ее точках действует эндоморфизм Фробениуса tau(x, y) = (x^2, y^2). 
+В LD- и лямбда-координатах tau(X : Y : Z) = (X^2 : Y^2 : Z^2). Эндоморфизм 
+удовлетворяет уравнению tau^2 - mu tau + 2 = 0, где mu = (-1)^{1 - A}. 
+Поэтому действие числа d на точку можно заменить действием элемента 
+кольца Z[tau], а удвоения -- дешевыми применениями tau (3S)
+[Solinas J. Efficient arithmetic on Koblitz curves. Designs, Codes and 
+Cryptography, 19 (2000), 195--249].
+
+В функции ec2MulTNAF() реализованы алгоритмы 3.63 (деление с округлением 
+в Z[tau]) и 3.69, 3.70 (оконное tau-NAF-представление, кратная точка) из 
+[Hankerson D., Menezes A., Vanstone S. Guide to Elliptic Curve Cryptography,
+Springer, 2004] со следующими изменениями.
+1.	Число d редуцируется по модулю gamma = tau^m - 1, а не по модулю 
+	delta = gamma / (tau - 1). Поскольку tau^m действует на точках 
+	E(GF(2^m)) тождественно, редукция корректна для любых точек кривой, 
+	а не только для точек подгруппы простого порядка. 
+	Норма gamma равняется #E(GF(2^m)).
+2.	При делении частное округляется покоординатно (без коррекции 
+	алгоритма 3.61). Норма остатка не превосходит N(gamma), длина 
+	tau-NAF-представления увеличивается не более чем на символ.
+
+Элемент gamma = r0 + r1 tau рассчитывается при создании кривой с помощью 
+последовательности Люка: tau^k = U_k tau - 2 U_{k - 1}, где U_0 = 0, 
+U_1 = 1, U_{k + 1} = mu U_k - 2 U_{k - 1}. Для деления на gamma 
+используется сопряженный элемент 
+	gamma' = s0 + s1 tau, s0 = r0 + mu r1, s1 = -r1, 
+и частное d / gamma = (d s0 + d s1 tau) / N(gamma).
+
+Длинные знаковые числа представляются в дополнительном коде и занимают 
+nt = n + 2 машинных слова. Для окна ширины w используются представители
+alpha_u = u \mod tau^w нечетных u, 0 < u < 2^{w - 1}, с наименьшей нормой
+(деление с округлением по алгоритму 3.61). Кратные alpha_u a 
+рассчитываются по tau-NAF-представлениям alpha_u.
+
+Сложность (l = m + O(1) -- длина tau-NAF-представления):
+	l(P <- tau P) + l/(w + 1)(P <- P + P) + O(2^{w - 2} w)(P <- P + A),
+причем (P <- tau P) = 3S ~ 0M. В общем алгоритме ecMul() дополнительно 
+требуется l(P <- 2P).
+*******************************************************************************
+*/
+
+#define EC2_TNAF_W_MAX 6
+
+typedef struct
+{
+	size_t m;			/*< степень расширения */
+	size_t w;			/*< ширина окна */
+	int mu;				/*< след Фробениуса: (-1)^{1 - A} */
+	word tw;			/*< образ tau в Z / (2^w) */
+	long alpha[SIZE_1 << (EC2_TNAF_W_MAX - 2)][2];	
+						/*< alpha_{2i + 1} = alpha[i][0] + alpha[i][1] tau */
+	word gamma[];		/*< [nt]r0 || [nt]r1 || [nt]s0 || [nt]s1 || [nt]N */
+} ec2_tnaf_st;
+
+#define ec2TNAFNT(n) ((n) + 2)
+
+static size_t ec2TNAFWidth(size_t m)
+{
+	if (m >= 336)
+		return 6;
+	else if (m >= 120)
+		return 5;
+	return 4;
+}
+
+// a < 0?
+static bool_t ec2TNAFIsNeg(const word a[], size_t nt)
+{
+	return (bool_t)(a[nt - 1] >> (B_PER_W - 1));
+}
+
+// a <- a + v
+static void ec2TNAFAddI(word a[], size_t nt, long v)
+{
+	if (v >= 0)
+		zzAddW2(a, nt, (word)v);
+	else
+		zzSubW2(a, nt, (word)(-v));
+}
+
+// a <- a / 2 (a -- четное)
+static void ec2TNAFHalve(word a[], size_t nt)
+{
+	const word hi = a[nt - 1] & WORD_BIT_HI;
+	ASSERT(a[0] % 2 == 0);
+	wwShLo(a, nt, 1);
+	a[nt - 1] |= hi;
+}
+
+// c <- a b \mod B^nt (знаковые числа)
+static void ec2TNAFMul(word c[], const word a[], const word b[], size_t nt,
+	void* stack)
+{
+	word* ma = (word*)stack;
+	word* mb = ma + nt;
+	word* prod = mb + nt;
+	stack = prod + 2 * nt;
+	wwCopy(ma, a, nt);
+	if (ec2TNAFIsNeg(a, nt))
+		zzNeg(ma, ma, nt);
+	wwCopy(mb, b, nt);
+	if (ec2TNAFIsNeg(b, nt))
+		zzNeg(mb, mb, nt);
+	zzMul(prod, ma, nt, mb, nt, stack);
+	wwCopy(c, prod, nt);
+	if (ec2TNAFIsNeg(a, nt) != ec2TNAFIsNeg(b, nt))
+		zzNeg(c, c, nt);
+}
+
+static size_t ec2TNAFMul_deep(size_t nt)
+{
+	return O_OF_W(4 * nt) + zzMul_deep(nt, nt);
+}
+
+// q <- round(k s / N) (k >= 0, N > 0, s -- знаковое)
+static void ec2TNAFRound(word q[], const word k[], const word s[], 
+	const word N[], size_t nt, void* stack)
+{
+	size_t nn;
+	word* ms = (word*)stack;
+	word* num = ms + nt;
+	word* den = num + 2 * nt;
+	word* quot = den + nt;
+	word* rem = quot + 2 * nt + 1;
+	stack = rem + nt;
+	// ms <- |s|
+	wwCopy(ms, s, nt);
+	if (ec2TNAFIsNeg(s, nt))
+		zzNeg(ms, ms, nt);
+	// num <- 2 k |s| + N, den <- 2 N
+	zzMul(num, k, nt, ms, nt, stack);
+	wwShHi(num, 2 * nt, 1);
+	zzAddW2(num + nt, nt, zzAdd2(num, N, nt));
+	wwCopy(den, N, nt);
+	wwShHi(den, nt, 1);
+	nn = wwWordSize(den, nt);
+	ASSERT(nn > 0);
+	// quot <- num \div den
+	wwSetZero(quot, 2 * nt + 1);
+	zzDiv(quot, rem, num, 2 * nt, den, nn, stack);
+	// q <- \pm quot
+	wwCopy(q, quot, nt);
+	if (ec2TNAFIsNeg(s, nt))
+		zzNeg(q, q, nt);
+}
+
+static size_t ec2TNAFRound_deep(size_t nt)
+{
+	return O_OF_W(7 * nt + 1) + 
+		utilMax(2,
+			zzMul_deep(nt, nt),
+			zzDiv_deep(2 * nt, nt));
+}
+
+// r <- (r0 + r1 tau) / tau (r0 -- четное)
+static void ec2TNAFDivTau(word r0[], word r1[], size_t nt, int mu, 
+	word t[])
+{
+	// t <- r0 / 2
+	wwCopy(t, r0, nt);
+	ec2TNAFHalve(t, nt);
+	// r0 <- r1 + mu t, r1 <- -t
+	wwCopy(r0, r1, nt);
+	if (mu > 0)
+		zzAdd2(r0, t, nt);
+	else
+		zzSub2(r0, t, nt);
+	zzNeg(r1, t, nt);
+}
+
+// tau-NAF-представление (w = 2) малого элемента: возвращается длина
+static size_t ec2TNAFSmall(signed char naf[], size_t max_len, long r0, 
+	long r1, int mu)
+{
+	size_t len = 0;
+	while (r0 || r1)
+	{
+		long h;
+		if (len == max_len)
+			return SIZE_MAX;
+		if (r0 & 1)
+		{
+			naf[len] = (signed char)(2 - ((r0 - 2 * r1) & 3));
+			r0 -= naf[len];
+		}
+		else
+			naf[len] = 0;
+		++len;
+		h = r0 / 2;
+		r0 = r1 + mu * h;
+		r1 = -h;
+	}
+	return len;
+}
+
+// [3n]b <- tau([3n]a) (LD- и лямбда-координаты)
+static void ec2Tau3(word b[], const word a[], const ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	qrSqr(ecX(b), ecX(a), ec->f, stack);
+	qrSqr(ecY(b, n), ecY(a, n), ec->f, stack);
+	qrSqr(ecZ(b, n), ecZ(a, n), ec->f, stack);
+}
+
+// наименьший по норме представитель u \mod tau^w [алгоритм 3.61]
+static void ec2TNAFAlpha(long alpha[2], long u, size_t w, int mu)
+{
+	const long den = 1L << w;
+	long u0 = 0, u1 = 1, t, g0, g1, n0, n1, f0, f1, e0, e1, eta;
+	long h0 = 0, h1 = 0;
+	size_t i;
+	// tau^w = g0 + g1 tau = -2 U_{w - 1} + U_w tau
+	for (i = 1; i < w; ++i)
+		t = mu * u1 - 2 * u0, u0 = u1, u1 = t;
+	g0 = -2 * u0, g1 = u1;
+	// lambda = u / tau^w = (n0 + n1 tau) / 2^w
+	n0 = u * (g0 + mu * g1), n1 = -u * g1;
+	// f = round(lambda), e = (lambda - f) 2^w
+	f0 = n0 >= 0 ? (2 * n0 + den) / (2 * den) : 
+		-((-2 * n0 + den) / (2 * den));
+	f1 = n1 >= 0 ? (2 * n1 + den) / (2 * den) : 
+		-((-2 * n1 + den) / (2 * den));
+	e0 = n0 - f0 * den, e1 = n1 - f1 * den;
+	// коррекция
+	eta = 2 * e0 + mu * e1;
+	if (eta >= den)
+	{
+		if (e0 - 3 * mu * e1 < -den)
+			h1 = mu;
+		else
+			h0 = 1;
+	}
+	else if (e0 + 4 * mu * e1 >= 2 * den)
+		h1 = mu;
+	if (eta < -den)
+	{
+		if (e0 - 3 * mu * e1 >= den)
+			h1 = -mu;
+		else
+			h0 = -1;
+	}
+	else if (e0 + 4 * mu * e1 < -2 * den)
+		h1 = -mu;
+	f0 += h0, f1 += h1;
+	// alpha <- u - f tau^w
+	alpha[0] = u - (f0 * g0 - 2 * f1 * g1);
+	alpha[1] = -(f0 * g1 + f1 * g0 + mu * f1 * g1);
+}
+
+static bool_t ec2TNAFStart(ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	const size_t nt = ec2TNAFNT(n);
+	ec2_tnaf_st* p = (ec2_tnaf_st*)ec->params;
+	word* r0 = p->gamma;
+	word* r1 = r0 + nt;
+	word* s0 = r1 + nt;
+	word* s1 = s0 + nt;
+	word* N = s1 + nt;
+	size_t i;
+	// переменные в stack
+	word* u0 = (word*)stack;
+	word* u1 = u0 + nt;
+	word* t = u1 + nt;
+	stack = t + nt;
+	// кривая Коблица?
+	if (!qrIsUnity(ec->B, ec->f) || 
+		(!qrIsZero(ec->A, ec->f) && !qrIsUnity(ec->A, ec->f)))
+		return FALSE;
+	// параметры
+	p->m = gf2Deg(ec->f);
+	p->w = ec2TNAFWidth(p->m);
+	p->mu = qrIsZero(ec->A, ec->f) ? -1 : 1;
+	// tw: tw^2 - mu tw + 2 \equiv 0 \mod 2^w, tw -- четное
+	p->tw = 0;
+	while ((p->tw * p->tw - (word)p->mu * p->tw + 2) & ((WORD_1 << p->w) - 1))
+	{
+		p->tw += 2;
+		ASSERT(p->tw < (WORD_1 << p->w));
+	}
+	// alpha_u
+	for (i = 0; i < (SIZE_1 << (p->w - 2)); ++i)
+		ec2TNAFAlpha(p->alpha[i], (long)(2 * i + 1), p->w, p->mu);
+	// u0 <- U_0, u1 <- U_1
+	wwSetZero(u0, nt);
+	wwSetW(u1, nt, 1);
+	// u1 <- U_m, u0 <- U_{m - 1}
+	for (i = 1; i < p->m; ++i)
+	{
+		// t <- mu u1 - 2 u0
+		wwCopy(t, u1, nt);
+		if (p->mu < 0)
+			zzNeg(t, t, nt);
+		zzSub2(t, u0, nt);
+		zzSub2(t, u0, nt);
+		wwCopy(u0, u1, nt);
+		wwCopy(u1, t, nt);
+	}
+	// r0 <- -2 U_{m - 1} - 1, r1 <- U_m
+	wwCopy(r0, u0, nt);
+	wwShHi(r0, nt, 1);
+	zzAddW2(r0, nt, 1);
+	zzNeg(r0, r0, nt);
+	wwCopy(r1, u1, nt);
+	// s0 <- r0 + mu r1, s1 <- -r1
+	wwCopy(s0, r0, nt);
+	if (p->mu > 0)
+		zzAdd2(s0, r1, nt);
+	else
+		zzSub2(s0, r1, nt);
+	zzNeg(s1, r1, nt);
+	// N <- r0 s0 - 2 r1 s1 = r0^2 + mu r0 r1 + 2 r1^2
+	ec2TNAFMul(N, r0, s0, nt, stack);
+	ec2TNAFMul(t, r1, s1, nt, stack);
+	zzSub2(N, t, nt);
+	zzSub2(N, t, nt);
+	ASSERT(!ec2TNAFIsNeg(N, nt) && !wwIsZero(N, nt));
+	// очистка
+	wwSetZero(u0, 3 * nt);
+	return TRUE;
+}
+
+static size_t ec2TNAFStart_deep(size_t n)
+{
+	const size_t nt = ec2TNAFNT(n);
+	return O_OF_W(3 * nt) + ec2TNAFMul_deep(nt);
+}
+
+static size_t ec2TNAFMaxLen(size_t m, size_t w)
+{
+	return m + 2 * w + 8;
+}
+
+static bool_t ec2MulTNAF(word b[], const word a[], const ec_o* ec, 
+	const word d[], size_t m, void* stack)
+{
+	const size_t n = ec->f->n;
+	const size_t nt = ec2TNAFNT(n);
+	const ec2_tnaf_st* p = (const ec2_tnaf_st*)ec->params;
+	const word* g0 = p->gamma;
+	const word* g1 = g0 + nt;
+	const word* s0 = g1 + nt;
+	const word* s1 = s0 + nt;
+	const word* N = s1 + nt;
+	const size_t count = SIZE_1 << (p->w - 2);
+	const size_t max_len = ec2TNAFMaxLen(p->m, p->w);
+	const word mask = (WORD_1 << p->w) - 1;
+	size_t len, i, j;
+	bool_t start;
+	// переменные в stack
+	word* k;			/* [nt] d */
+	word* q0;			/* [nt] частное (первая координата) */
+	word* q1;			/* [nt] частное (вторая координата) */
+	word* r0;			/* [nt] остаток (первая координата) */
+	word* r1;			/* [nt] остаток (вторая координата) */
+	word* t;			/* [nt] вспомогательное число */
+	word* pre;			/* [count * 3n] pre[i] = alpha_{2i + 1} a */
+	signed char* naf;	/* [max_len] tau-NAF */
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	ASSERT(a == b || wwIsDisjoint2(a, 2 * n, b, 3 * n));
+	ASSERT(p != 0);
+	// d слишком длинное?
+	m = wwWordSize(d, m);
+	if (m > n + 1)
+		return FALSE;
+	// раскладка stack
+	k = (word*)stack;
+	q0 = k + nt;
+	q1 = q0 + nt;
+	r0 = q1 + nt;
+	r1 = r0 + nt;
+	t = r1 + nt;
+	pre = t + nt;
+	naf = (signed char*)(pre + count * 3 * n);
+	stack = (word*)naf + W_OF_O(max_len);
+	// k <- d
+	wwCopy(k, d, m);
+	wwSetZero(k + m, nt - m);
+	// q <- round(k / gamma)
+	ec2TNAFRound(q0, k, s0, N, nt, stack);
+	ec2TNAFRound(q1, k, s1, N, nt, stack);
+	// r0 <- k - q0 g0 + 2 q1 g1
+	wwCopy(r0, k, nt);
+	ec2TNAFMul(t, q0, g0, nt, stack);
+	zzSub2(r0, t, nt);
+	ec2TNAFMul(t, q1, g1, nt, stack);
+	zzAdd2(r0, t, nt);
+	zzAdd2(r0, t, nt);
+	// r1 <- -q0 g1 - q1 g0 - mu q1 g1
+	if (p->mu > 0)
+		zzNeg(r1, t, nt);
+	else
+		wwCopy(r1, t, nt);
+	ec2TNAFMul(t, q0, g1, nt, stack);
+	zzSub2(r1, t, nt);
+	ec2TNAFMul(t, q1, g0, nt, stack);
+	zzSub2(r1, t, nt);
+	// tau-NAF-представление r0 + r1 tau [алгоритм 3.69]
+	for (len = 0; !wwIsZero(r0, nt) || !wwIsZero(r1, nt); ++len)
+	{
+		if (len == max_len)
+			return FALSE;
+		if (r0[0] & 1)
+		{
+			// u <- (r0 + r1 tw) mods 2^w
+			word u = (r0[0] + r1[0] * p->tw) & mask;
+			if (u >> (p->w - 1))
+			{
+				u = (WORD_1 << p->w) - u;
+				naf[len] = -(signed char)u;
+				ec2TNAFAddI(r0, nt, p->alpha[u / 2][0]);
+				ec2TNAFAddI(r1, nt, p->alpha[u / 2][1]);
+			}
+			else
+			{
+				naf[len] = (signed char)u;
+				ec2TNAFAddI(r0, nt, -p->alpha[u / 2][0]);
+				ec2TNAFAddI(r1, nt, -p->alpha[u / 2][1]);
+			}
+		}
+		else
+			naf[len] = 0;
+		ec2TNAFDivTau(r0, r1, nt, p->mu, t);
+	}
+	// pre[i] <- alpha_{2i + 1} a
+	for (i = 0; i < count; ++i)
+	{
+		word* pt = pre + i * 3 * n;
+		signed char small[4 * EC2_TNAF_W_MAX + 8];
+		size_t small_len = ec2TNAFSmall(small, COUNT_OF(small), 
+			p->alpha[i][0], p->alpha[i][1], p->mu);
+		ASSERT(small_len != SIZE_MAX && small_len > 0);
+		// старший символ small[small_len - 1] \in {-1, 1}
+		ecFromA(pt, a, ec, stack);
+		if (small[small_len - 1] < 0)
+			ecNeg(pt, pt, ec, stack);
+		for (j = small_len - 1; j--;)
+		{
+			ec2Tau3(pt, pt, ec, stack);
+			if (small[j] > 0)
+				ecAddA(pt, pt, a, ec, stack);
+			else if (small[j] < 0)
+				ecSubA(pt, pt, a, ec, stack);
+		}
+	}
+	// b <- \sum naf[i] tau^i a [алгоритм 3.70]
+	start = FALSE;
+	for (i = len; i--;)
+	{
+		if (start)
+			ec2Tau3(b, b, ec, stack);
+		if (naf[i] > 0)
+		{
+			if (start)
+				ecAdd(b, b, pre + (naf[i] / 2) * 3 * n, ec, stack);
+			else
+				wwCopy(b, pre + (naf[i] / 2) * 3 * n, 3 * n);
+			start = TRUE;
+		}
+		else if (naf[i] < 0)
+		{
+			if (start)
+				ecSub(b, b, pre + (-naf[i] / 2) * 3 * n, ec, stack);
+			else
+				ecNeg(b, pre + (-naf[i] / 2) * 3 * n, ec, stack);
+			start = TRUE;
+		}
+	}
+	if (!start)
+		ecSetO(b, ec);
+	// очистка
+	wwSetZero(k, 6 * nt);
+	memSetZero(naf, max_len);
+	return TRUE;
+}
+
+static size_t ec2MulTNAF_deep(size_t n, size_t ec_deep)
+{
+	const size_t nt = ec2TNAFNT(n);
+	const size_t w = ec2TNAFWidth(B_OF_W(n));
+	return O_OF_W(6 * nt) + 
+		O_OF_W((SIZE_1 << (w - 2)) * 3 * n) +
+		O_OF_W(W_OF_O(ec2TNAFMaxLen(B_OF_W(n), w))) + 
+		utilMax(3,
+			ec2TNAFRound_deep(nt),
+			ec2TNAFMul_deep(nt),
+			ec_deep);
+}
+
+static size_t ec2TNAF_keep(size_t n)
+{
+	return sizeof(ec2_tnaf_st) + O_OF_W(5 * ec2TNAFNT(n));
+}
+
+/*
+*******************************************************************************
+Создание описания кривой
+
+Функция ec2Create() выполняет общую для ec2CreateLD() и ec2CreateLAM()
+настройку: сохраняет коэффициенты, размечает буферы, устанавливает функции
+интерфейсов из таблицы coord и, если кривая является кривой Коблица,
+подключает умножение с помощью tau-NAF. Глубина стека ec_deep функций
+интерфейсов coord рассчитывается вызывающей стороной.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	ec_froma_i froma;
+	ec_toa_i toa;
+	ec_neg_i neg;
+	ec_add_i add;
+	ec_adda_i adda;
+	ec_sub_i sub;
+	ec_suba_i suba;
+	ec_dbl_i dbl;
+	ec_dbla_i dbla;
+} ec2_coord_st;
+
+static bool_t ec2Create(ec_o* ec, const qr_o* f, const octet A[], 
+	const octet B[], const ec2_coord_st* coord, size_t ec_deep, void* stack)
 {
 	ASSERT(memIsValid(ec, sizeof(ec_o)));
 	ASSERT(gf2IsOperable(f));
@@ -541,7 +1599,7 @@ bool_t ec2CreateLD(ec_o* ec, const qr_o* f, const octet A[], const octet B[],
 	ASSERT(memIsValid(B, f->no));
 	// обнулить
 	memSetZero(ec, sizeof(ec_o));
-	// зафикисровать размерности
+	// зафиксировать размерности
 	ec->d = 3;
 	// запомнить базовое поле
 	ec->f = f;
@@ -554,38 +1612,53 @@ bool_t ec2CreateLD(ec_o* ec, const qr_o* f, const octet A[], const octet B[],
 	ec->base = ec->B + f->n;
 	ec->order = ec->base + 2 * f->n;
 	// настроить интерфейсы
-	ec->froma = ec2FromALD;
-	ec->toa = ec2ToALD;
-	ec->neg = ec2NegLD;
-	ec->add = ec2AddLD;
-	ec->adda = ec2AddALD;
-	ec->sub = ec2SubLD;
-	ec->suba = ec2SubALD;
-	ec->dbl = ec2DblLD;
-	ec->dbla = ec2DblALD;
-	ec->deep = utilMax(8,
-		ec2ToALD_deep(f->n, f->deep),
-		ec2NegLD_deep(f->n, f->deep),
-		ec2AddLD_deep(f->n, f->deep),
-		ec2AddALD_deep(f->n, f->deep),
-		ec2SubLD_deep(f->n, f->deep),
-		ec2SubALD_deep(f->n, f->deep),
-		ec2DblLD_deep(f->n, f->deep),
-		ec2DblALD_deep(f->n, f->deep));
+	ec->froma = coord->froma;
+	ec->toa = coord->toa;
+	ec->neg = coord->neg;
+	ec->add = coord->add;
+	ec->adda = coord->adda;
+	ec->sub = coord->sub;
+	ec->suba = coord->suba;
+	ec->dbl = coord->dbl;
+	ec->dbla = coord->dbla;
+	ec->deep = ec_deep;
+	// кривая Коблица?
+	ec->params = (octet*)(ec->order + f->n + 1);
+	if (ec2TNAFStart(ec, stack))
+	{
+		ec->mul = ec2MulTNAF;
+		ec->deep = ec2MulTNAF_deep(f->n, ec->deep);
+	}
+	else
+		ec->params = 0;
 	// настроить заголовок
-	ec->hdr.keep = sizeof(ec_o) + O_OF_W(5 * f->n + 1);
+	ec->hdr.keep = sizeof(ec_o) + O_OF_W(5 * f->n + 1) + 
+		(ec->params ? ec2TNAF_keep(f->n) : 0);
 	ec->hdr.p_count = 6;
 	ec->hdr.o_count = 1;
 	// все нормально
 	return TRUE;
 }
 
-size_t ec2CreateLD_keep(size_t n)
+static size_t ec2Create_keep(size_t n)
 {
-	return sizeof(ec_o) + O_OF_W(5 * n + 1);
+	return sizeof(ec_o) + O_OF_W(5 * n + 1) + ec2TNAF_keep(n);
 }
 
-size_t ec2CreateLD_deep(size_t n, size_t f_deep)
+static size_t ec2Create_deep(size_t n, size_t ec_deep)
+{
+	return utilMax(2,
+		ec2TNAFStart_deep(n),
+		ec2MulTNAF_deep(n, ec_deep));
+}
+
+static const ec2_coord_st _ec2_ld = 
+{
+	ec2FromALD, ec2ToALD, ec2NegLD, ec2AddLD, ec2AddALD, 
+	ec2SubLD, ec2SubALD, ec2DblLD, ec2DblALD
+};
+
+static size_t ec2LD_deep(size_t n, size_t f_deep)
 {
 	return utilMax(8,
 		ec2ToALD_deep(n, f_deep),
@@ -598,6 +1671,57 @@ size_t ec2CreateLD_deep(size_t n, size_t f_deep)
 		ec2DblALD_deep(n, f_deep));
 }
 
+bool_t ec2CreateLD(ec_o* ec, const qr_o* f, const octet A[], const octet B[],
+	void* stack)
+{
+	return ec2Create(ec, f, A, B, &_ec2_ld, ec2LD_deep(f->n, f->deep), stack);
+}
+
+size_t ec2CreateLD_keep(size_t n)
+{
+	return ec2Create_keep(n);
+}
+
+size_t ec2CreateLD_deep(size_t n, size_t f_deep)
+{
+	return ec2Create_deep(n, ec2LD_deep(n, f_deep));
+}
+
+static const ec2_coord_st _ec2_lam = 
+{
+	ec2FromALAM, ec2ToALAM, ec2NegLAM, ec2AddLAM, ec2AddALAM, 
+	ec2SubLAM, ec2SubALAM, ec2DblLAM, ec2DblALAM
+};
+
+static size_t ec2LAM_deep(size_t n, size_t f_deep)
+{
+	return utilMax(7,
+		ec2ToALAM_deep(n, f_deep),
+		ec2AddLAM_deep(n, f_deep),
+		ec2AddALAM_deep(n, f_deep),
+		ec2SubLAM_deep(n, f_deep),
+		ec2SubALAM_deep(n, f_deep),
+		ec2DblLAM_deep(n, f_deep),
+		ec2DblALAM_deep(n, f_deep));
+}
+
+bool_t ec2CreateLAM(ec_o* ec, const qr_o* f, const octet A[], 
+	const octet B[], void* stack)
+{
+	return ec2Create(ec, f, A, B, &_ec2_lam, ec2LAM_deep(f->n, f->deep), 
+		stack);
+}
+
+size_t ec2CreateLAM_keep(size_t n)
+{
+	return ec2Create_keep(n);
+}
+
+size_t ec2CreateLAM_deep(size_t n, size_t f_deep)
+{
+	return ec2Create_deep(n, ec2LAM_deep(n, f_deep));
+}
+
 /*
 *******************************************************************************
 Свойства кривой
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.06.26
-\version 2016.07.05
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -122,6 +122,20 @@ tpl-2007-bl [Bernstein-Lange, 2007]. Сложность алгоритма
 \todo Сравнить madd-2004-hmv с madd-2007-bl, сложность которого
 	7M + 4S + 9add + 1*4 + 3*2.
 
+В функции ecpToAJN() выполняется пакетный переход A <- P. Обратные 
+к Z_1, Z_2,..., Z_T находятся одновременно с помощью трюка Монтгомери
+[Algorithm 11.15 Simultaneous inversion, CohenFrey, p. 209]:
+	U_1 <- Z_1
+	for t = 2,..., T: U_t <- U_{t-1} Z_t
+	V <- U_T^{-1}
+	for t = T,..., 2: 
+		Z_t^{-1} <- V U_{t-1}
+		V <- V Z_t
+	Z_1^{-1} <- V
+Произведения U_t сохраняются на месте x-координат выходных точек.
+Сложность алгоритма:
+	1D + (T - 1)3M + T(3M + 1S) \approx 100M + 7TM.
+
 \todo При выполнении функции ecpAddAJ() может выясниться, что
 складываются одинаковые точки. В этом случае вызывается функция
 ecpDblAJ(). Подумать, как "помочь" этой функции, передав уже
@@ -181,6 +195,73 @@ static size_t ecpToAJ_deep(size_t n, size_t f_deep)
 	return O_OF_W(2 * n) + f_deep;
 }
 
+// [count * 2n]b <- [count * 3n]a (A <- P)
+static bool_t ecpToAJN(word b[], const word a[], size_t count, 
+	const ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	bool_t ret = TRUE;
+	size_t t;
+	// переменные в stack
+	word* v = (word*)stack;
+	word* u = v + n;
+	word* w = u + n;
+	stack = w + n;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	ASSERT(count > 0);
+	ASSERT(wwIsDisjoint2(a, 3 * n * count, b, 2 * n * count));
+	// U_t <- U_{t-1} Z_t (если a_t == O, то вместо Z_t используется 1)
+	for (t = 0; t < count; ++t)
+	{
+		const word* z = ecZ(a + 3 * n * t, n);
+		ASSERT(ecpSeemsOn3(a + 3 * n * t, ec));
+		if (qrIsZero(z, ec->f))
+			z = ec->f->unity, ret = FALSE;
+		if (t == 0)
+			qrCopy(ecX(b), z, ec->f);
+		else
+			qrMul(ecX(b + 2 * n * t), ecX(b + 2 * n * (t - 1)), z, ec->f,
+				stack);
+	}
+	// V <- U_T^{-1}
+	qrInv(v, ecX(b + 2 * n * (count - 1)), ec->f, stack);
+	// обратный ход
+	while (t--)
+	{
+		const word* at = a + 3 * n * t;
+		word* bt = b + 2 * n * t;
+		// u <- Z_t^{-1}, V <- V Z_t
+		if (t > 0)
+		{
+			qrMul(u, v, ecX(bt - 2 * n), ec->f, stack);
+			if (!qrIsZero(ecZ(at, n), ec->f))
+				qrMul(v, v, ecZ(at, n), ec->f, stack);
+		}
+		else
+			qrCopy(u, v, ec->f);
+		// a_t == O => b_t <- 0
+		if (qrIsZero(ecZ(at, n), ec->f))
+		{
+			qrSetZero(ecX(bt), ec->f);
+			qrSetZero(ecY(bt, n), ec->f);
+			continue;
+		}
+		// xb_t <- xa_t u^2
+		qrSqr(w, u, ec->f, stack);
+		qrMul(ecX(bt), ecX(at), w, ec->f, stack);
+		// yb_t <- ya_t u^3
+		qrMul(w, w, u, ec->f, stack);
+		qrMul(ecY(bt, n), ecY(at, n), w, ec->f, stack);
+	}
+	return ret;
+}
+
+static size_t ecpToAJN_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(3 * n) + f_deep;
+}
+
 // [3n]b <- -[3n]a (P <- -P)
 static void ecpNegJ(word b[], const word a[], const ec_o* ec, void* stack)
 {
@@ -844,8 +925,10 @@ bool_t ecpCreateJ(ec_o* ec, const qr_o* f, const octet A[], const octet B[],
 	ec->dbl = bA3 ? ecpDblJA3 : ecpDblJ;
 	ec->dbla = ecpDblAJ;
 	ec->tpl = bA3 ? ecpTplJA3 : ecpTplJ;
+	ec->toan = ecpToAJN;
 	ec->deep = utilMax(9,
 		ecpToAJ_deep(f->n, f->deep),
+		ecpToAJN_deep(f->n, f->deep),
 		ecpAddJ_deep(f->n, f->deep),
 		ecpAddAJ_deep(f->n, f->deep),
 		ecpSubJ_deep(f->n, f->deep),
@@ -869,9 +952,10 @@ size_t ecpCreateJ_keep(size_t n)
 
 size_t ecpCreateJ_deep(size_t n, size_t f_deep)
 {
-	return utilMax(11,
+	return utilMax(12,
 		O_OF_W(n),
 		ecpToAJ_deep(n, f_deep),
+		ecpToAJN_deep(n, f_deep),
 		ecpAddJ_deep(n, f_deep),
 		ecpAddAJ_deep(n, f_deep),
 		ecpSubJ_deep(n, f_deep),
@@ -1220,14 +1304,11 @@ void ecpSWU(word b[], const word a[], const ec_o* ec, void* stack)
 	// t <- -a^2
 	qrSqr(t, a, ec->f, stack);
 	zmNeg(t, t, ec->f);
-	// s <- p - 2
-	wwCopy(s, ec->f->mod, n);
-	zzSubW2(s, n, 2);
 	// x1 <- -B(1 + t + t^2)(A(t + t^2))^{p - 2} 
 	qrSqr(x2, t, ec->f, stack);
 	qrAdd(x2, x2, t, ec->f);
 	qrMul(x1, x2, ec->A, ec->f, stack);
-	qrPower(x1, x1, s, n, ec->f, stack);
+	qrInv(x1, x1, ec->f, stack);
 	qrAddUnity(x2, x2, ec->f);
 	qrMul(x1, x1, x2, ec->f, stack);
 	qrMul(x1, x1, ec->B, ec->f, stack);
@@ -1240,11 +1321,11 @@ void ecpSWU(word b[], const word a[], const ec_o* ec, void* stack)
 	qrAdd(y, y, ec->B, ec->f);
 	// x2 <- x1 t
 	qrMul(x2, x1, t, ec->f, stack);
-	// t <- y^{(p - 1) - (p + 1) / 4} = y^{s - (p - 3) / 4}
-	wwCopy(t, ec->f->mod, n);
-	wwShLo(t, n, 2);
-	zzSub(s, s, t, n);
-	qrPower(t, y, s, n, ec->f, stack);
+	// t <- y^{(p - 1) - (p + 1) / 4} = (y^{(p - 3) / 4})^3 y
+	zmPowerSqrt(t, y, ec->f, stack);
+	qrSqr(s, t, ec->f, stack);
+	qrMul(t, t, s, ec->f, stack);
+	qrMul(t, t, y, ec->f, stack);
 	// s <- a^3 y
 	qrSqr(s, a, ec->f, stack);
 	qrMul(s, s, a, ec->f, stack);
@@ -1265,5 +1346,5 @@ size_t ecpSWU_deep(size_t n, size_t f_deep)
 	return O_OF_W(5 * n) + 
 		utilMax(2,
 			f_deep,
-			qrPower_deep(n, n, f_deep));
+			zmPowerSqrt_deep(n, f_deep));
 }
\ No newline at end of file
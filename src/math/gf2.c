@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.17
-\version 2015.11.03
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -15,6 +15,7 @@ version 3. See Copyright Notices in bee2/info.h.
 #include "bee2/core/mem.h"
 #include "bee2/core/stack.h"
 #include "bee2/core/util.h"
+#include "bee2/core/word.h"
 #include "bee2/math/gf2.h"
 #include "bee2/math/pp.h"
 #include "bee2/math/ww.h"
@@ -379,6 +380,45 @@ static size_t gf2Div_deep(size_t n)
 	return O_OF_W(n + 1) + ppDivMod_deep(n + 1);
 }
 
+/*
+*******************************************************************************
+Маска следа
+
+След -- линейная функция: \tr(a) = \sum_i a_i \tr(x^i), где a_i -- 
+коэффициенты a. Поэтому при создании поля рассчитывается маска [n]tr из битов 
+\tr(x^i), i = 0, 1,..., m - 1, а след a определяется как четность a & tr.
+
+Маска размещается в f->descr сразу после f->unity.
+
+Следы s_k = \tr(x^k) -- это степенные суммы корней p(x). Если 
+	p(x) = x^m + e_1 x^{m - 1} + ... + e_m,
+то по тождествам Ньютона (в характеристике 2)
+	s_k = e_1 s_{k - 1} + ... + e_{k - 1} s_1 + k e_k, 0 < k < m.
+Для трехчлена и пятичлена ненулевыми являются только e_{m - p[1]}, 
+e_{m - p[2]}, e_{m - p[3]} и e_m. Поэтому маска рассчитывается 
+за O(m) операций. Кроме этого, s_0 = m mod 2.
+*******************************************************************************
+*/
+
+#define gf2TrMask(f) ((f)->unity + (f)->n)
+
+static void gf2TrMaskCalc(word tr[], const size_t p[4], size_t n)
+{
+	size_t k, i;
+	wwSetZero(tr, n);
+	wwSetBit(tr, 0, p[0] & 1);
+	for (k = 1; k < p[0]; ++k)
+	{
+		word s = 0;
+		for (i = 1; i < 4 && p[i]; ++i)
+			if (p[0] - p[i] < k)
+				s ^= wwTestBit(tr, k - (p[0] - p[i]));
+			else if (p[0] - p[i] == k)
+				s ^= k & 1;
+		wwSetBit(tr, k, (bool_t)s);
+	}
+}
+
 /*
 *******************************************************************************
 Управление описанием поля
@@ -420,7 +460,7 @@ bool_t gf2Create(qr_o* f, const size_t p[4], void* stack)
 		f->unity = f->mod + n1;
 		wwSetW(f->unity, f->n, 1);
 		// сформировать params
-		f->params = (size_t*)(f->unity + f->n);
+		f->params = (size_t*)(gf2TrMask(f) + f->n);
 		t = (gf2_trinom_st*)f->params;
 		t->m = p[0];
 		t->k = p[1];
@@ -429,6 +469,8 @@ bool_t gf2Create(qr_o* f, const size_t p[4], void* stack)
 		t->wm = p[0] / B_PER_W;
 		t->bk = (p[0] - p[1]) % B_PER_W;
 		t->wk = (p[0] - p[1]) / B_PER_W;
+		// сформировать маску следа
+		gf2TrMaskCalc(gf2TrMask(f), p, f->n);
 		// настроить интерфейсы
 		f->from = gf2From;
 		f->to = gf2To;
@@ -439,8 +481,10 @@ bool_t gf2Create(qr_o* f, const size_t p[4], void* stack)
 		f->sqr = t->bk == 0 ? gf2SqrTrinomial0 : gf2SqrTrinomial1;
 		f->inv = gf2Inv;
 		f->div = gf2Div;
+		f->safe = SAFE_DEFAULT;
 		// заголовок
-		f->hdr.keep = sizeof(qr_o) + O_OF_W(n1 + f->n) + sizeof(gf2_trinom_st);
+		f->hdr.keep = sizeof(qr_o) + O_OF_W(n1 + 2 * f->n) + 
+			sizeof(gf2_trinom_st);
 		f->hdr.p_count = 3;
 		f->hdr.o_count = 0;
 		// глубина стека
@@ -485,7 +529,7 @@ bool_t gf2Create(qr_o* f, const size_t p[4], void* stack)
 		f->unity = f->mod + n1;
 		wwSetW(f->unity, f->n, 1);
 		// сформировать params
-		f->params = (size_t*)(f->unity + f->n);
+		f->params = (size_t*)(gf2TrMask(f) + f->n);
 		t = (gf2_pentanom_st*)f->params;
 		t->m = p[0];
 		t->k = p[1];
@@ -499,6 +543,8 @@ bool_t gf2Create(qr_o* f, const size_t p[4], void* stack)
 		t->wl = (p[0] - p[2]) / B_PER_W;
 		t->bl1 = (p[0] - p[3]) % B_PER_W;
 		t->wl1 = (p[0] - p[3]) / B_PER_W;
+		// сформировать маску следа
+		gf2TrMaskCalc(gf2TrMask(f), p, f->n);
 		// настроить интерфейсы
 		f->from = gf2From;
 		f->to = gf2To;
@@ -509,8 +555,9 @@ bool_t gf2Create(qr_o* f, const size_t p[4], void* stack)
 		f->sqr = gf2SqrPentanomial;
 		f->inv = gf2Inv;
 		f->div = gf2Div;
+		f->safe = SAFE_DEFAULT;
 		// заголовок
-		f->hdr.keep = sizeof(qr_o) + O_OF_W(n1 + f->n) + 
+		f->hdr.keep = sizeof(qr_o) + O_OF_W(n1 + 2 * f->n) + 
 			sizeof(gf2_pentanom_st);
 		f->hdr.p_count = 3;
 		f->hdr.o_count = 0;
@@ -528,7 +575,7 @@ size_t gf2Create_keep(size_t m)
 {
 	const size_t n = W_OF_B(m);
 	const size_t n1 = n + (m % B_PER_W == 0);
-	return sizeof(qr_o) + O_OF_W(n1 + n) + 
+	return sizeof(qr_o) + O_OF_W(n1 + 2 * n) + 
 		utilMax(2, 
 			sizeof(gf2_trinom_st),
 			sizeof(gf2_pentanom_st));
@@ -615,30 +662,24 @@ size_t gf2Deg(const qr_o* f)
 
 bool_t gf2Tr(const word a[], const qr_o* f, void* stack)
 {
-	size_t m = gf2Deg(f);
-	word* t = (word*)stack;
-	stack = t + f->n;
+	const word* tr = gf2TrMask(f);
+	register word t = 0;
+	size_t i;
 	// pre
 	ASSERT(gf2IsOperable(f));
 	ASSERT(gf2IsIn(a, f));
-	// t <- sum_{i = 0}^{m - 1} a^{2^i}
-	qrCopy(t, a, f);
-	while (--m)
-	{
-		qrSqr(t, t, f, stack);
-		gf2Add2(t, a, f);
-	}
-	// t == 0?
-	if (qrIsZero(t, f))
-		return FALSE;
-	// t == 1?
-	ASSERT(qrIsUnity(t, f));
-	return TRUE;
+	// t <- a & tr
+	for (i = 0; i < f->n; ++i)
+		t ^= a[i] & tr[i];
+	// четность
+	i = wordParity(t);
+	t = 0;
+	return (bool_t)i;
 }
 
 size_t gf2Tr_deep(size_t n, size_t f_deep)
 {
-	return O_OF_W(n) + f_deep;
+	return 0;
 }
 
 bool_t gf2QSolve(word x[], const word a[], const word b[],
@@ -669,8 +710,13 @@ bool_t gf2QSolve(word x[], const word a[], const word b[],
 		return TRUE;
 	}
 	// t <- ba^{-2}
-	qrSqr(t, a, f, stack);
-	qrDiv(t, b, t, f, stack);
+	if (qrIsUnity(a, f))
+		qrCopy(t, b, f);
+	else
+	{
+		qrSqr(t, a, f, stack);
+		qrDiv(t, b, t, f, stack);
+	}
 	// tr(t) == 1?
 	if (gf2Tr(t, f, stack))
 		return FALSE;
@@ -684,7 +730,8 @@ bool_t gf2QSolve(word x[], const word a[], const word b[],
 		gf2Add2(x, t, f);
 	}
 	// x <- x * a
-	qrMul(x, x, a, f, stack);
+	if (!qrIsUnity(a, f))
+		qrMul(x, x, a, f, stack);
 	// решение есть
 	return TRUE;
 }
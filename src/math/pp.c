@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.03.01
-\version 2016.05.18
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -290,6 +290,137 @@ size_t ppDeg(const word a[], size_t n)
 	_MUL_MUL_S4((c)[0], (c)[1], t, b);\
 	_MUL_REPAIR_S4((c)[1], a, b);\
 
+/*
+*******************************************************************************
+Умножение без переносов
+
+На платформах x86-64 с расширением PCLMULQDQ (Intel Westmere+, AMD 
+Bulldozer+) произведение многочленов-слов рассчитывается одной командой 
+pclmulqdq. В функции ppMulClmul() многочлены малой длины n перемножаются 
+по схеме "столбиков": для каждого k = 0, 1,..., 2n - 2 накапливается сумма 
+128-битовых произведений a[i] b[k - i], ее младшее слово складывается со 
+старшим словом суммы для k - 1. Требуется n^2 команд pclmulqdq и никаких 
+обращений к таблицам. При n > 9 функция используется как базовая 
+в алгоритме Карацубы.
+
+Наличие расширения определяется во время выполнения (cpuid, лист 1, 
+ECX: бит 1), результат кэшируется. Кэш читается и записывается атомарно: 
+ppMul() может одновременно вызываться в нескольких потоках. При отсутствии 
+расширения, а также после вызова ppUseClmul(FALSE), используются 
+табличные макросы _MUL_XX (см. выше). Команда 
+pclmulqdq регулярна, поэтому ускоренные функции регулярны (в отличие 
+от табличных).
+
+\remark Для компиляторов без расширений GCC (атрибут target, встроенные
+функции cpuid.h) используются переносимые реализации.
+*******************************************************************************
+*/
+
+#if defined(__GNUC__) && defined(__x86_64__) && (B_PER_W == 64)
+
+#include <cpuid.h>
+#include <wmmintrin.h>
+
+#define PP_CLMUL
+
+static int _clmul_enabled = 1;
+
+static bool_t ppHasClmul()
+{
+	static int cache = -1;
+	int has = __atomic_load_n(&cache, __ATOMIC_RELAXED);
+	if (has < 0)
+	{
+		unsigned info[4];
+		has = __get_cpuid(1, info, info + 1, info + 2, info + 3) &&
+			(info[2] & 0x00000002) != 0;
+		__atomic_store_n(&cache, has, __ATOMIC_RELAXED);
+	}
+	return has != 0 && __atomic_load_n(&_clmul_enabled, __ATOMIC_RELAXED);
+}
+
+#define _CLMUL(a, b)\
+	_mm_clmulepi64_si128(_mm_cvtsi64_si128((long long)(a)),\
+		_mm_cvtsi64_si128((long long)(b)), 0x00)
+
+#define _CLMUL_LO(x)\
+	((word)_mm_cvtsi128_si64(x))
+
+#define _CLMUL_HI(x)\
+	((word)_mm_cvtsi128_si64(_mm_unpackhi_epi64(x, x)))
+
+__attribute__((target("pclmul,sse2")))
+static void ppMulClmul(word c[], const word a[], const word b[], size_t n)
+{
+	__m128i acc, prev = _mm_setzero_si128();
+	size_t i, k;
+	ASSERT(n > 0);
+	for (k = 0; k + 1 < 2 * n; ++k)
+	{
+		acc = _mm_setzero_si128();
+		for (i = k < n ? 0 : k - n + 1; i <= k && i < n; ++i)
+			acc = _mm_xor_si128(acc, _CLMUL(a[i], b[k - i]));
+		c[k] = _CLMUL_LO(acc) ^ _CLMUL_HI(prev);
+		prev = acc;
+	}
+	c[k] = _CLMUL_HI(prev);
+}
+
+__attribute__((target("pclmul,sse2")))
+static word ppMulWClmul(word b[], const word a[], size_t n, word w)
+{
+	__m128i prod;
+	word carry = 0;
+	size_t i;
+	for (i = 0; i < n; ++i)
+	{
+		prod = _CLMUL(a[i], w);
+		b[i] = carry ^ _CLMUL_LO(prod);
+		carry = _CLMUL_HI(prod);
+	}
+	return carry;
+}
+
+__attribute__((target("pclmul,sse2")))
+static word ppAddMulWClmul(word b[], const word a[], size_t n, word w)
+{
+	__m128i prod;
+	word carry = 0;
+	size_t i;
+	for (i = 0; i < n; ++i)
+	{
+		prod = _CLMUL(a[i], w);
+		b[i] ^= carry ^ _CLMUL_LO(prod);
+		carry = _CLMUL_HI(prod);
+	}
+	return carry;
+}
+
+__attribute__((target("pclmul,sse2")))
+static void ppSqrClmul(word b[], const word a[], size_t n)
+{
+	__m128i prod;
+	size_t i;
+	for (i = 0; i < n; ++i)
+	{
+		prod = _CLMUL(a[i], a[i]);
+		b[i + i] = _CLMUL_LO(prod);
+		b[i + i + 1] = _CLMUL_HI(prod);
+	}
+}
+
+#endif /* PP_CLMUL */
+
+bool_t ppUseClmul(bool_t use)
+{
+#ifdef PP_CLMUL
+	__atomic_store_n(&_clmul_enabled, use ? 1 : 0, __ATOMIC_RELAXED);
+	return ppHasClmul();
+#else
+	return FALSE;
+#endif
+}
+
 /*
 *******************************************************************************
 Описание базовых функций умножения
@@ -798,6 +929,10 @@ word ppMulW(word b[], const word a[], size_t n, register word w,
 	size_t i;
 	word* t = (word*)stack;
 	ASSERT(wwIsSameOrDisjoint(a, b, n));
+#ifdef PP_CLMUL
+	if (ppHasClmul())
+		return ppMulWClmul(b, a, n, w);
+#endif
 	_MUL_PRE_S4(t, w);
 	for (i = 0; i < n; ++i)
 	{
@@ -822,6 +957,10 @@ word ppAddMulW(word b[], const word a[], size_t n, register word w,
 	size_t i;
 	word* t = (word*)stack;
 	ASSERT(wwIsSameOrDisjoint(a, b, n));
+#ifdef PP_CLMUL
+	if (ppHasClmul())
+		return ppAddMulWClmul(b, a, n, w);
+#endif
 	_MUL_PRE_S4(t, w);
 	for (i = 0; i < n; ++i)
 	{
@@ -871,6 +1010,11 @@ static void ppMulEq(word c[], const word a[], const word b[], size_t n,
 	ASSERT(wwIsDisjoint2(a, n, c, 2 * n));
 	ASSERT(wwIsDisjoint2(b, n, c, 2 * n));
 	// умножение многочленов малой длины
+#ifdef PP_CLMUL
+	if (n < COUNT_OF(_mul_procs) && ppHasClmul())
+		ppMulClmul(c, a, b, n);
+	else
+#endif
 	if (n < COUNT_OF(_mul_procs))
 		_mul_procs[n](c, a, b, stack);
 	// усеченный алгоритм Карацубы, n --- четное
@@ -1038,7 +1182,8 @@ size_t ppMul_deep(size_t n, size_t m)
 Возведение в квадрат
 
 Возведение в квадрат двоичной строки, представляющей многочлен, состоит
-в прореживании строки нулями.
+в прореживании строки нулями. Прореживание выполняется командой pclmulqdq 
+(см. ppMulClmul()), а при ее отсутствии -- по таблице _squares.
 *******************************************************************************
 */
 
@@ -1104,6 +1249,13 @@ void ppSqr(word b[], const word a[], size_t n, void* stack)
 {
 	size_t i;
 	ASSERT(wwIsDisjoint2(a, n, b, 2 * n));
+#ifdef PP_CLMUL
+	if (ppHasClmul())
+	{
+		ppSqrClmul(b, a, n);
+		return;
+	}
+#endif
 	for (i = 0; i < n; ++i)
 		b[i + i] = _SQR_LO(a[i]),
 		b[i + i + 1] = _SQR_HI(a[i]);
@@ -5,13 +5,14 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.08.13
-\version 2016.07.15
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
 #include "bee2/core/mem.h"
+#include "bee2/core/mt.h"
 #include "bee2/core/prng.h"
 #include "bee2/core/util.h"
 #include "bee2/core/word.h"
@@ -376,6 +377,118 @@ static const pri_prod_t _prods[] =
 #endif
 };
 
+/*
+*******************************************************************************
+Остатки по четырем модулям
+
+Остатки числа [n]a по модулям m[0],..., m[3] рассчитываются одновременно,
+за один проход по словам a. Применяется деление двойного слова на слово 
+с предвычисленным обратным [Möller N., Granlund T. Improved Division by 
+Invariant Integers. IEEE Trans. Comput., 2011]. Модуль m нормализуется: 
+d = m << s, где s -- число старших нулевых битов m. Обратное
+	v = floor((B^2 - 1) / d) - B
+рассчитывается один раз, после чего каждое слово a (сдвинутое на s битов) 
+обрабатывается одним умножением двойной точности без деления.
+Цепочки вычислений по разным модулям независимы, и процессор может 
+выполнять их параллельно.
+
+Остаток по нормализованному модулю сдвигается вправо на s битов:
+(a << s) \mod (m << s) = (a \mod m) << s.
+*******************************************************************************
+*/
+
+#define priModDD(r, u, d, v)\
+	do {\
+		dword q = (dword)(v) * (r);\
+		q += (dword)((r) + 1) << B_PER_W | (u);\
+		(r) = (u) - (word)(q >> B_PER_W) * (d);\
+		if ((r) > (word)q)\
+			(r) += (d);\
+		if ((r) >= (d))\
+			(r) -= (d);\
+	} while (0)
+
+static void priModW4(word r[4], const word a[], size_t n, const word m[4])
+{
+	size_t s[4];
+	word d[4];
+	word v[4];
+	word u, t;
+	size_t k;
+	for (k = 0; k < 4; ++k)
+	{
+		ASSERT(m[k] > 0);
+		s[k] = wordCLZ(m[k]);
+		d[k] = m[k] << s[k];
+		v[k] = (word)(((dword)(~d[k]) << B_PER_W | WORD_MAX) / d[k]);
+		// r[k] <- старшие s[k] битов a
+		r[k] = n ? a[n - 1] >> 1 >> (B_PER_W - 1 - s[k]) : 0;
+	}
+	while (n--)
+	{
+		t = n ? a[n - 1] >> 1 : 0;
+		for (k = 0; k < 4; ++k)
+		{
+			u = a[n] << s[k] | t >> (B_PER_W - 1 - s[k]);
+			priModDD(r[k], u, d[k], v[k]);
+		}
+	}
+	for (k = 0; k < 4; ++k)
+		r[k] >>= s[k];
+	u = t = 0;
+}
+
+/*
+*******************************************************************************
+Остатки по факторной базе
+
+Простые факторной базы обрабатываются блоками: блок составляют простые 
+из четырех последовательных произведений _prods, а после исчерпания 
+_prods -- четыре последовательных простых. Остатки по модулям блока 
+рассчитываются функцией priModW4(). Остатки по отдельным простым
+получаются из остатков по произведениям делением слова на слово.
+
+Функция priBaseModBlock() рассчитывает остатки по простым очередного блока,
+начиная с простого с номером *i и произведения с номером *j, и сдвигает 
+номера. Обрабатываются только простые с номерами меньше count.
+Возвращается число рассчитанных остатков (не более PRI_BLOCK_MAX).
+*******************************************************************************
+*/
+
+#define PRI_BLOCK_MAX 64
+
+static size_t priBaseModBlock(word mods[], const word a[], size_t n, 
+	size_t* i, size_t* j, size_t count)
+{
+	word m[4], r[4];
+	size_t k, c = 0;
+	ASSERT(*i < count && count <= priBaseSize());
+	// произведения
+	if (*j < COUNT_OF(_prods))
+	{
+		for (k = 0; k < 4; ++k)
+			m[k] = _prods[MIN2(*j + k, COUNT_OF(_prods) - 1)].prod;
+		priModW4(r, a, n, m);
+		for (k = 0; k < 4 && *j < COUNT_OF(_prods) && *i < count; ++k, ++*j)
+		{
+			size_t num = _prods[*j].num;
+			for (; num-- && *i < count; ++*i)
+				mods[c++] = r[k] % _base[*i];
+		}
+	}
+	// отдельные простые
+	else
+	{
+		for (k = 0; k < 4; ++k)
+			m[k] = _base[MIN2(*i + k, count - 1)];
+		priModW4(r, a, n, m);
+		for (k = 0; k < 4 && *i < count; ++k, ++*i)
+			mods[c++] = r[k];
+	}
+	ASSERT(c <= PRI_BLOCK_MAX);
+	return c;
+}
+
 void priBaseMod(word mods[], const word a[], size_t n, size_t count)
 {
 	size_t i, j;
@@ -383,25 +496,22 @@ void priBaseMod(word mods[], const word a[], size_t n, size_t count)
 	ASSERT(wwIsValid(a, n));
 	ASSERT(count <= priBaseSize());
 	ASSERT(wwIsValid(mods, count));
-	// пробегаем произведения простых из факторной базы
-	for (i = j = 0; i < count && j < COUNT_OF(_prods); ++j)
-	{
-		size_t num = _prods[j].num;
-		// t <- a mod _base[i] * ... * _base[i + num - 1]
-		word t = zzModW(a, n, _prods[j].prod);
-		// mods[i] <- t mod _base[i]
-		while (num-- && i < count)
-			mods[i] = t % _base[i], ++i;
-	}
-	// пробегаем оставшиеся простые из факторной базы
-	for (; i < count; ++i)
-		mods[i] = zzModW(a, n, _base[i]);
+	// пробегаем блоки факторной базы
+	for (i = j = 0; i < count;)
+		priBaseModBlock(mods + i, a, n, &i, &j, count);
 }
 
 /*
 *******************************************************************************
 Использование факторной базы
 
+Остатки рассчитываются блоками (см. priBaseModBlock()). Проверка на 
+просеянность завершается на первом блоке с нулевым остатком.
+
+При проверке гладкости число a делится на найденные простые делители 
+по мере их обнаружения. Это не влияет на нулевые остатки по следующим
+простым, но уменьшает длину a.
+
 \todo Алгоритм Бернштейна выделения гладкой части 
 [http://cr.yp.to/factorization/smoothparts-20040510.pdf]:
 	z <- p1 p2 .... pm \mod a
@@ -412,6 +522,7 @@ void priBaseMod(word mods[], const word a[], size_t n, size_t count)
 
 bool_t priIsSieved(const word a[], size_t n, size_t base_count, void* stack)
 {
+	size_t i, j, c;
 	// переменные в stack
 	word* mods;
 	// pre
@@ -427,29 +538,28 @@ bool_t priIsSieved(const word a[], size_t n, size_t base_count, void* stack)
 			--base_count;
 	// раскладка stack
 	mods = (word*)stack;
-	stack = mods + base_count;
-	// найти остатки
-	priBaseMod(mods, a, n, base_count);
+	stack = mods + PRI_BLOCK_MAX;
 	// есть нулевые остатки?
-	while (base_count--)
-		if (mods[base_count] == 0)
-			return FALSE;
+	for (i = j = 0; i < base_count;)
+		for (c = priBaseModBlock(mods, a, n, &i, &j, base_count); c--;)
+			if (mods[c] == 0)
+				return FALSE;
 	// нет
 	return TRUE;
 }
 
 size_t priIsSieved_deep(size_t base_count)
 {
-	return O_OF_W(base_count);
+	return O_OF_W(MIN2(base_count, PRI_BLOCK_MAX));
 }
 
 bool_t priIsSmooth(const word a[], size_t n, size_t base_count, void* stack)
 {
-	register size_t i;
-	register word mod;
+	size_t i, j, c, k;
 	// переменные в stack
 	word* t = (word*)stack;
-	stack = t + n;
+	word* mods = t + n;
+	stack = mods + PRI_BLOCK_MAX;
 	// pre
 	ASSERT(base_count <= priBaseSize());
 	// t <- a 
@@ -458,38 +568,37 @@ bool_t priIsSmooth(const word a[], size_t n, size_t base_count, void* stack)
 	i = wwLoZeroBits(t, n);
 	wwShLo(t, n, i);
 	n = wwWordSize(t, n);
-	if (wwIsZero(t, n))
-	{
-		i = 0;
+	if (n == 0 || wwIsW(t, n, 1))
 		return TRUE;
-	}
-	// цикл по простым из факторной базы
-	for (i = 0; i < base_count;)
+	// цикл по блокам факторной базы
+	for (i = j = 0; i < base_count;)
 	{
-		mod = _base[i] < WORD_BIT_HALF ? 
-			zzModW2(t, n, _base[i]) : zzModW(t, n, _base[i]);
-		// делится на простое?
-		if (mod == 0)
+		c = priBaseModBlock(mods, t, n, &i, &j, base_count);
+		for (k = 0; k < c; ++k)
 		{
-			zzDivW(t, t, n, _base[i]);
-			n = wwWordSize(t, n);
-			if (wwIsZero(t, n))
+			register word p;
+			// не делится на простое?
+			if (mods[k] != 0)
+				continue;
+			// разделить на максимальную степень простого
+			p = _base[i - c + k];
+			do
+				zzDivW(t, t, n, p), n = wwWordSize(t, n);
+			while (zzModW(t, n, p) == 0);
+			if (wwIsW(t, n, 1))
 			{
-				i = 0, mod = 0;
+				p = 0;
 				return TRUE;
 			}
+			p = 0;
 		}
-		// .. не делится
-		else 
-			++i;
 	}
-	i = 0, mod = 0;
 	return FALSE;
 }
 
 size_t priIsSmooth_deep(size_t n)
 {
-	return O_OF_W(n);
+	return O_OF_W(n + PRI_BLOCK_MAX);
 }
 
 /*
@@ -595,11 +704,51 @@ B_PER_IMPOSSLIBLE / log_2(24) < B_PER_IMPOSSLIBLE / 4.5.
 *******************************************************************************
 */
 
+static bool_t priRMBase(word base[], const word a[], size_t n, 
+	const qr_o* qr, void* combo_state)
+{
+	size_t i = 0;
+	// base <-R {1, \ldots, a - 1} \ {\pm one}
+	do
+		if (i++ * 45 > B_PER_IMPOSSIBLE * 10 || 
+			!zzRandNZMod(base, a, n, prngCOMBOStepR, combo_state))
+			return FALSE;
+	while (wwEq(base, qr->unity, n) || zzIsSumEq(a, base, qr->unity, n));
+	return TRUE;
+}
+
+static bool_t priRMRound(word base[], const word a[], size_t n, 
+	const word r[], size_t m, size_t s, const qr_o* qr, void* stack)
+{
+	register size_t i;
+	// base <- base^r \mod a
+	qrPower(base, base, r, m, qr, stack);
+	// base == \pm one => тест пройден
+	if (wwEq(base, qr->unity, n) ||
+		zzIsSumEq(a, base, qr->unity, n))
+		return TRUE;
+	// base^{2^i} \equiv -1 \mod a?
+	for (i = s; i--;)
+	{
+		qrSqr(base, base, qr, stack);
+		if (wwEq(base, qr->unity, n))
+		{
+			i = 0;
+			return FALSE;
+		}
+		if (zzIsSumEq(a, base, qr->unity, n))
+		{
+			i = 0;
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
 bool_t priRMTest(const word a[], size_t n, size_t iter, void* stack)
 {
 	register size_t s;
 	register size_t m;
-	register size_t i;
 	// переменные в stack
 	word* r = (word*)stack;
 	word* base = r + n;
@@ -629,42 +778,13 @@ bool_t priRMTest(const word a[], size_t n, size_t iter, void* stack)
 	m = wwWordSize(r, n);
 	// итерации
 	while (iter--)
-	{
-		// base <-R {1, \ldots, a - 1} \ {\pm one}
-		i = 0;
-		do
-			if (i++ * 45 > B_PER_IMPOSSIBLE * 10 || 
-				!zzRandNZMod(base, a, n, prngCOMBOStepR, combo_state))
-			{
-				s = m = 0;
-				return FALSE;
-			}
-		while (wwEq(base, qr->unity, n) || zzIsSumEq(a, base, qr->unity, n));
-		// base <- base^r \mod a
-		qrPower(base, base, r, m, qr, stack);
-		// base == \pm one => тест пройден
-		if (wwEq(base, qr->unity, n) ||
-			zzIsSumEq(a, base, qr->unity, n))
-			continue;
-		// base^{2^i} \equiv -1 \mod a?
-		for (i = s; i--;)
+		if (!priRMBase(base, a, n, qr, combo_state) ||
+			!priRMRound(base, a, n, r, m, s, qr, stack))
 		{
-			qrSqr(base, base, qr, stack);
-			if (wwEq(base, qr->unity, n))
-			{
-				s = m = i = 0;
-				return FALSE;
-			}
-			if (zzIsSumEq(a, base, qr->unity, n))
-				break;
-		}
-		if (i == SIZE_MAX)
-		{
-			s = m = i = 0;
+			s = m = 0;
 			return FALSE;
 		}
-	}
-	s = m = i = 0;
+	s = m = 0;
 	// простое
 	return TRUE;
 }
@@ -678,6 +798,160 @@ size_t priRMTest_deep(size_t n)
 			qrPower_deep(n, n, qr_deep));
 }
 
+/*
+*******************************************************************************
+Тест Рабина -- Миллера в нескольких потоках
+
+Итерации теста распределяются между threads исполнителями: вызывающим 
+потоком и threads - 1 дополнительными. Исполнитель под защитой мьютекса 
+берет очередную итерацию и генерирует для нее основание. Поэтому основания
+генерируются в том же порядке, что и в priRMTest(): i-я итерация 
+использует i-е основание, какой бы исполнитель ее ни выполнял. 
+Найдя свидетеля непростоты, исполнитель поднимает флаг witness, после чего 
+другие исполнители не берут новые итерации.
+
+Если мьютекс или поток создать не удалось, то итерации выполняются 
+в вызывающем потоке.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	const word* a;		/*!< проверяемое число */
+	size_t n;			/*!< длина a */
+	const word* r;		/*!< нечетная часть a - 1 */
+	size_t m;			/*!< длина r */
+	size_t s;			/*!< a - 1 = r 2^s */
+	const qr_o* qr;		/*!< кольцо \mod a */
+	void* combo_state;	/*!< состояние генератора оснований */
+	size_t iter;		/*!< число оставшихся итераций */
+	bool_t witness;		/*!< найден свидетель непростоты? */
+	bool_t mt;			/*!< мьютекс создан? */
+	mt_mtx_t mtx[1];	/*!< мьютекс */
+} pri_rm_st;
+
+typedef struct
+{
+	pri_rm_st* rm;		/*!< общее состояние */
+	word* base;			/*!< основание */
+	void* stack;		/*!< вспомогательная память */
+	bool_t run;			/*!< поток запущен? */
+	mt_thrd_t thrd[1];	/*!< поток */
+} pri_rm_job_st;
+
+static int priRMWorker(void* job)
+{
+	pri_rm_job_st* j = (pri_rm_job_st*)job;
+	pri_rm_st* rm = j->rm;
+	bool_t ok;
+	while (1)
+	{
+		// взять итерацию, сгенерировать основание
+		if (rm->mt)
+			mtMtxLock(rm->mtx);
+		if (rm->witness || rm->iter == 0)
+		{
+			if (rm->mt)
+				mtMtxUnlock(rm->mtx);
+			break;
+		}
+		--rm->iter;
+		if (!(ok = priRMBase(j->base, rm->a, rm->n, rm->qr, rm->combo_state)))
+			rm->witness = TRUE;
+		if (rm->mt)
+			mtMtxUnlock(rm->mtx);
+		// выполнить итерацию
+		if (!ok)
+			break;
+		if (!priRMRound(j->base, rm->a, rm->n, rm->r, rm->m, rm->s, rm->qr,
+			j->stack))
+		{
+			if (rm->mt)
+				mtMtxLock(rm->mtx);
+			rm->witness = TRUE;
+			if (rm->mt)
+				mtMtxUnlock(rm->mtx);
+			break;
+		}
+	}
+	return 0;
+}
+
+bool_t priRMTestMT(const word a[], size_t n, size_t iter, size_t threads,
+	void* stack)
+{
+	size_t job_deep;
+	size_t i;
+	// переменные в stack
+	pri_rm_job_st* jobs;
+	pri_rm_st* rm;
+	word* r;
+	qr_o* qr;
+	octet* combo_state;
+	// pre
+	ASSERT(wwIsValid(a, n));
+	ASSERT(threads > 0);
+	// раскладка stack
+	jobs = (pri_rm_job_st*)stack;
+	rm = (pri_rm_st*)(jobs + threads);
+	r = (word*)(rm + 1);
+	qr = (qr_o*)(r + n);
+	combo_state = (octet*)qr + zmCreate_keep(O_OF_W(n));
+	stack = combo_state + prngCOMBO_keep();
+	job_deep = W_OF_O(qrPower_deep(n, n, zmCreate_deep(O_OF_W(n))));
+	// нормализация
+	n = wwWordSize(a, n);
+	// четное?
+	if (zzIsEven(a, n))
+		return wwCmpW(a, n, 2) == 0;
+	// маленькое?
+	if (n == 1 && a[0] < 49)
+		return a[0] != 1 && (a[0] == 3 || a[0] % 3) && (a[0] == 5 || a[0] % 5);
+	// подготовить генератор
+	prngCOMBOStart(combo_state, utilNonce32());
+	// создать кольцо
+	wwTo(r, O_OF_W(n), a);
+	zmCreate(qr, (octet*)r, memNonZeroSize(r, O_OF_W(n)), stack);
+	// a - 1 = r 2^s (r -- нечетное)
+	rm->a = a, rm->n = n;
+	wwCopy(r, a, n);
+	zzSubW2(r, n, 1);
+	rm->s = wwLoZeroBits(r, n);
+	wwShLo(r, n, rm->s);
+	rm->r = r, rm->m = wwWordSize(r, n);
+	rm->qr = qr, rm->combo_state = combo_state;
+	rm->iter = iter, rm->witness = FALSE;
+	// подготовить исполнителей
+	for (i = 0; i < threads; ++i)
+	{
+		jobs[i].rm = rm;
+		jobs[i].base = (word*)stack + i * (n + job_deep);
+		jobs[i].stack = jobs[i].base + n;
+		jobs[i].run = FALSE;
+	}
+	// запустить исполнителей
+	if ((rm->mt = threads > 1 && mtMtxCreate(rm->mtx)))
+		for (i = 1; i < threads; ++i)
+			jobs[i].run = mtThrdCreate(jobs[i].thrd, priRMWorker, jobs + i);
+	priRMWorker(jobs);
+	for (i = 1; i < threads; ++i)
+		if (jobs[i].run)
+			mtThrdJoin(jobs[i].thrd);
+	if (rm->mt)
+		mtMtxClose(rm->mtx);
+	return !rm->witness;
+}
+
+size_t priRMTestMT_deep(size_t n, size_t threads)
+{
+	size_t qr_deep = zmCreate_deep(O_OF_W(n));
+	return threads * sizeof(pri_rm_job_st) + sizeof(pri_rm_st) + 
+		O_OF_W(n) + zmCreate_keep(O_OF_W(n)) + prngCOMBO_keep() +
+		utilMax(2,
+			qr_deep,
+			threads * O_OF_W(n + W_OF_O(qrPower_deep(n, n, qr_deep))));
+}
+
 bool_t priIsPrime(const word a[], size_t n, void* stack)
 {
 	return priRMTest(a, n, (B_PER_IMPOSSIBLE + 1) / 2, stack);
@@ -737,6 +1011,133 @@ size_t priIsSGPrime_deep(size_t n)
 			qrPower_deep(n + 1, n, qr_deep));
 }
 
+/*
+*******************************************************************************
+Решето
+
+Кандидаты a, a + d, a + 2d,..., a + (w - 1)d просеиваются по факторной базе
+одновременно. Пусть a \equiv u \mod p_i, d \equiv v \mod p_i, где p_i -- 
+простое факторной базы. Если v != 0, то на p_i делятся кандидаты с номерами 
+k \equiv -u v^{-1} \mod p_i. Эти номера отмечаются в битовой карте окна 
+с шагом p_i. Если v == 0, то при u == 0 отмечаются все кандидаты.
+После обработки окна остаток u сдвигается: u <- u + w v \mod p_i.
+
+Обратные v^{-1} \mod p_i и сдвиги w v \mod p_i рассчитываются один раз
+в функции priSieveStart(). Для v == 0 в качестве обратного используется 0.
+
+Простые факторной базы меньше 2^16, поэтому промежуточные произведения
+остатков укладываются в u32.
+*******************************************************************************
+*/
+
+#define PRI_SIEVE_W 256
+
+static word priInvModSmall(word v, word p)
+{
+	int a = (int)p, b = (int)v;
+	int x0 = 0, x1 = 1, q, t;
+	ASSERT(0 < v && v < p);
+	while (b > 1)
+	{
+		q = a / b;
+		t = a - q * b, a = b, b = t;
+		t = x0 - q * x1, x0 = x1, x1 = t;
+	}
+	ASSERT(b == 1);
+	return (word)(x1 < 0 ? x1 + (int)p : x1);
+}
+
+static void priSieveStart(word dinvs[], word dws[], size_t base_count)
+{
+	size_t i;
+	for (i = 0; i < base_count; ++i)
+		if (dinvs[i] == 0)
+			dws[i] = 0;
+		else
+		{
+			dws[i] = (word)((u32)(PRI_SIEVE_W % _base[i]) * (u32)dinvs[i] %
+				(u32)_base[i]);
+			dinvs[i] = priInvModSmall(dinvs[i], _base[i]);
+		}
+}
+
+static void priSieve(word map[], word mods[], const word dinvs[], 
+	const word dws[], size_t base_count)
+{
+	size_t i, k, step;
+	wwSetZero(map, W_OF_B(PRI_SIEVE_W));
+	for (i = 0; i < base_count; ++i)
+	{
+		// первый кандидат, кратный _base[i]
+		if (dinvs[i] != 0)
+		{
+			k = mods[i] == 0 ? 0 : (size_t)((u32)(_base[i] - mods[i]) * 
+				(u32)dinvs[i] % (u32)_base[i]);
+			step = (size_t)_base[i];
+		}
+		else
+			k = mods[i] == 0 ? 0 : PRI_SIEVE_W, step = 1;
+		// отметить кратные
+		for (; k < PRI_SIEVE_W; k += step)
+			wwSetBit(map, k, 1);
+		// сдвинуть остаток к следующему окну
+		if ((mods[i] += dws[i]) >= _base[i])
+			mods[i] -= _base[i];
+	}
+}
+
+/*
+*******************************************************************************
+Параллельная проверка кандидатов
+
+Кандидаты, прошедшие решето, накапливаются в пакет из threads заданий.
+Задания пакета выполняются одновременно: первое -- в вызывающем потоке,
+остальные -- в дополнительных. Если поток создать не удалось, то задание 
+выполняется в вызывающем потоке. Из пакета выбирается первый подошедший 
+кандидат. Так как кандидаты перебираются в том же порядке, что и при 
+последовательной проверке, результат не зависит от числа потоков.
+*******************************************************************************
+*/
+
+typedef struct pri_job_st pri_job_st;
+
+struct pri_job_st
+{
+	bool_t (*test)(pri_job_st* job);	/*!< проверка кандидата */
+	word* p;			/*!< кандидат */
+	word* r;			/*!< множитель r (расширение) */
+	const word* q;		/*!< базовое простое (расширение) */
+	size_t n;			/*!< длина q или p (следующее простое) */
+	size_t l;			/*!< битовая длина p (расширение) */
+	size_t iter;		/*!< число итераций (следующее простое) */
+	void* stack;		/*!< вспомогательная память */
+	bool_t ret;			/*!< результат проверки */
+	bool_t run;			/*!< поток запущен? */
+	mt_thrd_t thrd[1];	/*!< поток */
+};
+
+static int priJobMain(void* job)
+{
+	pri_job_st* j = (pri_job_st*)job;
+	j->ret = j->test(j);
+	return 0;
+}
+
+static size_t priJobsRun(pri_job_st jobs[], size_t count)
+{
+	size_t i;
+	ASSERT(count > 0);
+	for (i = 1; i < count; ++i)
+		if (!(jobs[i].run = mtThrdCreate(jobs[i].thrd, priJobMain, jobs + i)))
+			priJobMain(jobs + i);
+	priJobMain(jobs);
+	for (i = 1; i < count; ++i)
+		if (jobs[i].run)
+			mtThrdJoin(jobs[i].thrd);
+	for (i = 0; i < count && !jobs[i].ret; ++i);
+	return i;
+}
+
 /*
 *******************************************************************************
 Следующее простое
@@ -772,20 +1173,42 @@ size_t priNextPrimeW_deep()
 	return priIsPrimeW_deep();
 }
 
-bool_t priNextPrime(word p[], const word a[], size_t n, size_t trials,
-	size_t base_count, size_t iter, void* stack)
+static bool_t priNextPrimeTest(pri_job_st* job)
+{
+	return priRMTest(job->p, job->n, job->iter, job->stack);
+}
+
+bool_t priNextPrimeMT(word p[], const word a[], size_t n, size_t trials,
+	size_t base_count, size_t iter, size_t threads, void* stack)
 {
+	const size_t job_deep = W_OF_O(priRMTest_deep(n));
 	size_t l;
-	size_t i;
-	bool_t base_success;
+	size_t i, k;
+	size_t count;
 	// переменные в stack
+	pri_job_st* jobs;
 	word* mods;
+	word* dinvs;
+	word* dws;
+	word* map;
 	// pre
 	ASSERT(wwIsSameOrDisjoint(a, p, n));
 	ASSERT(base_count <= priBaseSize());
+	ASSERT(threads > 0);
 	// раскладка stack
-	mods = (word*)stack;
-	stack = mods + base_count;
+	jobs = (pri_job_st*)stack;
+	mods = (word*)(jobs + threads);
+	dinvs = mods + base_count;
+	dws = dinvs + base_count;
+	map = dws + base_count;
+	stack = map + W_OF_B(PRI_SIEVE_W);
+	for (i = 0; i < threads; ++i)
+	{
+		jobs[i].test = priNextPrimeTest;
+		jobs[i].p = (word*)stack + i * (n + job_deep);
+		jobs[i].n = n, jobs[i].iter = iter;
+		jobs[i].stack = jobs[i].p + n;
+	}
 	// l <- битовая длина a
 	l = wwBitSize(a, n);
 	// 0-битовых и 1-битовых простых не существует
@@ -799,39 +1222,68 @@ bool_t priNextPrime(word p[], const word a[], size_t n, size_t trials,
 		// при необходимости скоррректировать факторную базу
 		while (base_count > 0 && priBasePrime(base_count - 1) >= p[0])
 			--base_count;
-	// рассчитать остатки от деления на малые простые
+	// рассчитать остатки от деления на малые простые, подготовить решето
 	priBaseMod(mods, p, n, base_count);
-	for (i = 0, base_success = TRUE; i < base_count; ++i)
-		if (mods[i] == 0)
-		{
-			base_success = FALSE;
-			break;
-		}
+	for (i = 0; i < base_count; ++i)
+		dinvs[i] = 2;
+	priSieveStart(dinvs, dws, base_count);
 	// попытки
-	while (trials == SIZE_MAX || trials--)
+	for (count = 0; ;)
 	{
-		// проверка простоты
-		if (base_success && priRMTest(p, n, iter, stack))
-			return TRUE;
-		// к следующему кандидату
-		if (zzAddW2(p, n, 2) || wwBitSize(p, n) > l)
-			return FALSE;
-		for (i = 0, base_success = TRUE; i < base_count; ++i)
+		// просеять окно
+		priSieve(map, mods, dinvs, dws, base_count);
+		for (k = 0; k < PRI_SIEVE_W; ++k)
 		{
-			if (mods[i] < _base[i] - 2)
-				mods[i] += 2;
-			else if (mods[i] == _base[i] - 1)
-				mods[i] = 1;
-			else
-				mods[i] = 0, base_success = FALSE;
+			// попытки исчерпаны?
+			if (trials != SIZE_MAX && trials-- == 0)
+				break;
+			// кандидат прошел решето?
+			if (!wwTestBit(map, k))
+			{
+				wwCopy(jobs[count].p, p, n);
+				// пакет заполнен: проверка простоты
+				if (++count == threads)
+				{
+					if ((i = priJobsRun(jobs, count)) < count)
+					{
+						wwCopy(p, jobs[i].p, n);
+						return TRUE;
+					}
+					count = 0;
+				}
+			}
+			// к следующему кандидату
+			if (zzAddW2(p, n, 2) || wwBitSize(p, n) > l)
+				break;
 		}
+		if (k < PRI_SIEVE_W)
+			break;
+	}
+	// проверить оставшиеся кандидаты
+	if (count && (i = priJobsRun(jobs, count)) < count)
+	{
+		wwCopy(p, jobs[i].p, n);
+		return TRUE;
 	}
 	return FALSE;
 }
 
+size_t priNextPrimeMT_deep(size_t n, size_t base_count, size_t threads)
+{
+	return threads * sizeof(pri_job_st) + 
+		O_OF_W(3 * base_count + W_OF_B(PRI_SIEVE_W)) +
+		threads * O_OF_W(n + W_OF_O(priRMTest_deep(n)));
+}
+
+bool_t priNextPrime(word p[], const word a[], size_t n, size_t trials,
+	size_t base_count, size_t iter, void* stack)
+{
+	return priNextPrimeMT(p, a, n, trials, base_count, iter, 1, stack);
+}
+
 size_t priNextPrime_deep(size_t n, size_t base_count)
 {
-	return base_count * O_PER_W + priRMTest_deep(n);
+	return priNextPrimeMT_deep(n, base_count, 1);
 }
 
 /*
@@ -858,45 +1310,113 @@ size_t priNextPrime_deep(size_t n, size_t base_count)
 \remark Если t укладывается в m слов, q -- в n слов, то r на шаге 3)
 укладывается в m - n + 1 слов. Действительно, максимальное r получается
 при t = B^m - 1, q = B^{n - 1} и равняется B^{m - n + 1} - 1.
+
+\remark Кандидаты p, p + 2q, p + 4q,... просеиваются окнами. Перед выбором 
+нового r накопленный пакет кандидатов проверяется: генератор rng не 
+должен вызываться, если среди уже построенных кандидатов есть подходящий.
+Поэтому последовательность обращений к rng не зависит от числа потоков.
 *******************************************************************************
 */
 
-bool_t priExtendPrime(word p[], size_t l, const word q[], size_t n,
-	size_t trials, size_t base_count, gen_i rng, void* rng_state, void* stack)
+static bool_t priExtendPrimeTest(pri_job_st* job)
+{
+	const size_t m = W_OF_B(job->l);
+	const size_t mo = O_OF_B(job->l);
+	// переменные в stack
+	word* t;
+	word* four;
+	qr_o* qr;
+	void* stack;
+	// раскладка stack
+	t = (word*)job->stack;
+	four = t + m;
+	qr = (qr_o*)(four + m);
+	stack = (octet*)qr + zmCreate_keep(mo);
+	// создать кольцо вычетов \mod p
+	wwTo(t, mo, job->p);
+	zmCreate(qr, (octet*)t, mo, stack);
+	// four <- 4 [в кольце qr]
+	qrAdd(four, qr->unity, qr->unity, qr);
+	qrAdd(four, four, four, qr);
+	// 4^r \mod p != 1?
+	qrPower(t, four, job->r, m - job->n + 1, qr, stack);
+	if (qrCmp(t, qr->unity, qr) == 0)
+		return FALSE;
+	// (4^r)^q \mod p == 1?
+	qrPower(t, t, job->q, job->n, qr, stack);
+	return qrCmp(t, qr->unity, qr) == 0;
+}
+
+static size_t priExtendPrimeTest_deep(size_t l)
 {
 	const size_t m = W_OF_B(l);
 	const size_t mo = O_OF_B(l);
-	size_t i;
+	const size_t qr_deep = zmCreate_deep(mo);
+	return O_OF_W(2 * m) + zmCreate_keep(mo) +
+		utilMax(2,
+			qr_deep,
+			qrPower_deep(m, m, qr_deep));
+}
+
+bool_t priExtendPrimeMT(word p[], size_t l, const word q[], size_t n,
+	size_t trials, size_t base_count, gen_i rng, void* rng_state, 
+	size_t threads, void* stack)
+{
+	const size_t m = W_OF_B(l);
+	const size_t mo = O_OF_B(l);
+	const size_t job_deep = W_OF_O(priExtendPrimeTest_deep(l));
+	size_t i, k;
+	size_t count;
+	bool_t first;
 	// переменные в stack
+	pri_job_st* jobs;
 	word* r;
 	word* t;
-	word* four;
 	word* mods;
-	word* mods1;
-	qr_o* qr;
+	word* dinvs;
+	word* dws;
+	word* map;
 	// pre
 	ASSERT(wwIsDisjoint2(q, n, p, m));
 	ASSERT(zzIsOdd(q, n) && wwCmpW(q, n, 3) >= 0);
 	ASSERT(wwBitSize(q, n) + 1 <= l && l <= 2 * wwBitSize(q, n));
 	ASSERT(base_count <= priBaseSize());
 	ASSERT(rng != 0);
+	ASSERT(threads > 0);
 	// подкорректировать n
 	n = wwWordSize(q, n);
 	// раскладка stack
-	r = (word*)stack;
+	jobs = (pri_job_st*)stack;
+	r = (word*)(jobs + threads);
 	t = r + m - n + 1;
-	four = t + m + 1;
-	mods = four + m;
-	mods1 = mods + base_count;
-	qr = (qr_o*)(mods1 + base_count);
-	stack = (octet*)qr + zmCreate_keep(mo);
+	mods = t + m + 1;
+	dinvs = mods + base_count;
+	dws = dinvs + base_count;
+	map = dws + base_count;
+	stack = map + W_OF_B(PRI_SIEVE_W);
+	for (i = 0; i < threads; ++i)
+	{
+		jobs[i].test = priExtendPrimeTest;
+		jobs[i].p = (word*)stack + i * (m + m - n + 1 + job_deep);
+		jobs[i].r = jobs[i].p + m;
+		jobs[i].q = q, jobs[i].n = n, jobs[i].l = l;
+		jobs[i].stack = jobs[i].r + m - n + 1;
+	}
+	stack = (word*)stack + threads * (m + m - n + 1 + job_deep);
 	// малое p?
 	if (l < B_PER_W)
 		// при необходимости уменьшить факторную базу
 		while (base_count > 0 && 
 			priBasePrime(base_count - 1) > WORD_BIT_POS(l - 1))
 			--base_count;
+	// подготовить решето: шаг 2q
+	priBaseMod(dinvs, q, n, base_count);
+	for (i = 0; i < base_count; ++i)
+		if ((dinvs[i] += dinvs[i]) >= _base[i])
+			dinvs[i] -= _base[i];
+	priSieveStart(dinvs, dws, base_count);
 	// попытки
+	count = 0;
 	while (trials == SIZE_MAX || trials--)
 	{
 		// t <-R [2^{l - 2}, 2^{l - 1})
@@ -917,67 +1437,88 @@ bool_t priExtendPrime(word p[], size_t l, const word q[], size_t n,
 		wwShHi(p, m, 1);
 		++p[0];
 		ASSERT(wwBitSize(p, m) == l);
-		// рассчитать вычеты p, 2q по малым модулям
+		// рассчитать вычеты p по малым модулям
 		priBaseMod(mods, p, m, base_count);
-		priBaseMod(mods1, q, n, base_count);
-		for (i = 0; i < base_count; ++i)
-			if ((mods1[i] += mods1[i]) >= _base[i])
-				mods1[i] -= _base[i];
-		// проверка простоты
-		while (1)
+		// перебор кандидатов p, p + 2q,...
+		for (first = TRUE; ;)
 		{
-			// p делится на малые простые?
-			for (i = 0; i < base_count; ++i)
-				if (mods[i] == 0)
-					break;
-			// не делится: тест Демитко
-			if (i == base_count)
+			// просеять окно
+			priSieve(map, mods, dinvs, dws, base_count);
+			for (k = 0; k < PRI_SIEVE_W; ++k)
 			{
-				// создать кольцо вычетов \mod p
-				wwTo(t, mo, p);
-				zmCreate(qr, (octet*)t, mo, stack);
-				// four <- 4 [в кольце qr]
-				qrAdd(four, qr->unity, qr->unity, qr);
-				qrAdd(four, four, four, qr);
-				// 4^r \mod p != 1?
-				qrPower(t, four, r, m - n + 1, qr, stack);
-				if (qrCmp(t, qr->unity, qr) != 0)
+				// к следующему кандидату
+				if (!first)
 				{
-					// (4^r)^q \mod p == 1?
-					qrPower(t, t, q, n, qr, stack);
-					if (qrCmp(t, qr->unity, qr) == 0)
+					// p <- p + 2q, переполнение?
+					if (zzAddW2(p + n, m - n, zzAdd2(p, q, n)) ||
+						zzAddW2(p + n, m - n, zzAdd2(p, q, n)) ||
+						wwBitSize(p, m) > l)
+						break;
+					// r <- r + 1
+					zzAddW2(r, m - n + 1, 1);
+					// попытки исчерпаны?
+					if (trials != SIZE_MAX && trials-- == 0)
+					{
+						trials = 0;
+						break;
+					}
+				}
+				first = FALSE;
+				// кандидат прошел решето?
+				if (wwTestBit(map, k))
+					continue;
+				wwCopy(jobs[count].p, p, m);
+				wwCopy(jobs[count].r, r, m - n + 1);
+				// пакет заполнен: тест Демитко
+				if (++count == threads)
+				{
+					if ((i = priJobsRun(jobs, count)) < count)
+					{
+						wwCopy(p, jobs[i].p, m);
 						return TRUE;
+					}
+					count = 0;
 				}
 			}
-			// p <- p + 2q, переполнение?
-			if (zzAddW2(p + n, m - n, zzAdd2(p, q, n)) ||
-				zzAddW2(p + n, m - n, zzAdd2(p, q, n)) ||
-				wwBitSize(p, m) > l)
+			if (k < PRI_SIEVE_W)
 				break;
-			// r <- r + 1, t <- t + q, пересчитать mods
-			zzAddW2(r, m - n + 1, 1);
-			zzAddW2(t + n, m - n, zzAdd2(t, q, n));
-			for (i = 0; i < base_count; ++i)
-				if ((mods[i] += mods1[i]) >= _base[i])
-					mods[i] -= _base[i];
-			// к следующей попытке
-			if (trials != SIZE_MAX && trials-- == 0)
-				return FALSE;
+		}
+		// проверить оставшиеся кандидаты до обращения к rng
+		if (count)
+		{
+			if ((i = priJobsRun(jobs, count)) < count)
+			{
+				wwCopy(p, jobs[i].p, m);
+				return TRUE;
+			}
+			count = 0;
 		}
 	}
 	return FALSE;
 }
 
-size_t priExtendPrime_deep(size_t l, size_t n, size_t base_count)
+size_t priExtendPrimeMT_deep(size_t l, size_t n, size_t base_count,
+	size_t threads)
 {
 	const size_t m = W_OF_B(l);
-	const size_t mo = O_OF_B(l);
-	const size_t qr_deep = zmCreate_deep(mo);
 	ASSERT(m >= n);
-	return O_OF_W(m - n + 1 + m + 1 + m + 2 * base_count) + zmCreate_keep(mo) +
-		utilMax(4,
+	return threads * sizeof(pri_job_st) + 
+		O_OF_W(m - n + 1 + m + 1 + 3 * base_count + W_OF_B(PRI_SIEVE_W)) +
+		threads * O_OF_W(m + m - n + 1 + 
+			W_OF_O(priExtendPrimeTest_deep(l))) +
+		utilMax(2,
 			zzDiv_deep(m, n),
-			zzMul_deep(n, m - n + 1),
-			qr_deep,
-			qrPower_deep(m, m, qr_deep));
+			zzMul_deep(n, m - n + 1));
+}
+
+bool_t priExtendPrime(word p[], size_t l, const word q[], size_t n,
+	size_t trials, size_t base_count, gen_i rng, void* rng_state, void* stack)
+{
+	return priExtendPrimeMT(p, l, q, n, trials, base_count, rng, rng_state,
+		1, stack);
+}
+
+size_t priExtendPrime_deep(size_t l, size_t n, size_t base_count)
+{
+	return priExtendPrimeMT_deep(l, n, base_count, 1);
 }
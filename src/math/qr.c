@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2013.09.14
-\version 2014.04.17
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -13,6 +13,7 @@ version 3. See Copyright Notices in bee2/info.h.
 
 #include "bee2/core/mem.h"
 #include "bee2/core/util.h"
+#include "bee2/core/word.h"
 #include "bee2/math/qr.h"
 #include "bee2/math/ww.h"
 
@@ -96,6 +97,27 @@ static size_t qrCalcSlideWidth(size_t m)
 	return 7;
 }
 
+static void qrCalcSlidePowers(word powers[], const word a[], 
+	size_t powers_count, const qr_o* r, void* stack)
+{
+	size_t i;
+	ASSERT(powers_count > 0);
+	if (powers_count == 1)
+	{
+		wwCopy(powers, a, r->n);
+		return;
+	}
+	// powers[0] <- a^2
+	qrSqr(powers, a, r, stack);
+	// powers[1] <- a^3
+	qrMul(powers + r->n, a, powers, r, stack);
+	// powers[i] <- a^{2i + 1} = powers[i - 1] * powers[0]
+	for (i = 2; i < powers_count; ++i)
+		qrMul(powers + r->n * i, powers + r->n * i - r->n, powers, r, stack);
+	// powers[0] <- a
+	wwCopy(powers, a, r->n);
+}
+
 void qrPower(word c[], const word a[], const word b[], size_t m, 
 	const qr_o* r, void* stack)
 {
@@ -123,23 +145,7 @@ void qrPower(word c[], const word a[], const word b[], size_t m,
 		return;
 	}
 	// расчет малых степеней a
-	ASSERT(w > 0);
-	if (w == 1)
-		wwCopy(powers, a, r->n);
-	else
-	{
-		size_t i;
-		// powers[0] <- a^2
-		qrSqr(powers, a, r, stack);
-		// powers[1] <- a^3
-		qrMul(powers + r->n, a, powers, r, stack);
-		// powers[i] <- a^{2i + 1} = powers[i - 1] * powers[0]
-		for (i = 2; i < powers_count; ++i)
-			qrMul(powers + r->n * i, powers + r->n * i - r->n, powers, r, 
-				stack);
-		// powers[0] <- a
-		wwCopy(powers, a, r->n);
-	}
+	qrCalcSlidePowers(powers, a, powers_count, r, stack);
 	// pos <- l - 1
 	pos = wwBitSize(b, m) - 1;
 	ASSERT(pos != SIZE_MAX);
@@ -183,3 +189,323 @@ size_t qrPower_deep(size_t n, size_t m, size_t r_deep)
 	const size_t powers_count = SIZE_1 << (qrCalcSlideWidth(m) - 1);
 	return O_OF_W(n + n * powers_count) + r_deep;
 }
+
+/*
+*******************************************************************************
+Произведение степеней
+
+В функции qrPower2() реализован метод чередующихся скользящих окон 
+(interleaved sliding windows, обобщение трюка Шамира, см. алгоритм 14.88
+в [Menezes A., van Oorschot P., Vanstone S. Handbook of Applied 
+Cryptography, CRC Press, 1996] и алгоритм 3.51 в [Hankerson D., Menezes A., 
+Vanstone S. Guide to Elliptic Curve Cryptography, Springer, 2004]).
+
+Для каждого основания a[i] рассчитываются малые нечетные степени 
+(ширина окна w[i] выбирается по длине b[i] так же, как в qrPower()). 
+Затем биты показателей просматриваются одновременно от старших 
+к младшим. На каждом шаге накопленное произведение возводится в квадрат. 
+Если в позиции pos начинается (со стороны старших разрядов) слайд b[i], 
+то он запоминается вместе с позицией своего младшего бита. При достижении 
+этой позиции произведение умножается на соответствующую малую степень a[i].
+
+Общее число возведений в квадрат -- около max(l[1], l[2]), где 
+l[i] = wwBitSize(b[i]), вместо l[1] + l[2] при раздельных вычислениях.
+Число умножений примерно такое же, как при раздельных вычислениях.
+*******************************************************************************
+*/
+
+void qrPower2(word c[], const word a1[], const word b1[], size_t m1,
+	const word a2[], const word b2[], size_t m2, const qr_o* r, void* stack)
+{
+	const size_t count1 = SIZE_1 << (qrCalcSlideWidth(m1) - 1);
+	const size_t count2 = SIZE_1 << (qrCalcSlideWidth(m2) - 1);
+	const word* b[2];
+	size_t w[2];
+	size_t l[2];
+	size_t end[2];
+	word slide[2];
+	bool_t unity = TRUE;
+	size_t pos, i;
+	// переменные в stack
+	word* power;
+	word* powers[2];
+	// pre
+	ASSERT(qrIsOperable(r));
+	ASSERT(wwIsValid(a1, r->n) && wwIsValid(a2, r->n));
+	ASSERT(wwIsValid(b1, m1) && wwIsValid(b2, m2));
+	ASSERT(wwIsValid(c, r->n));
+	// раскладка stack
+	power = (word*)stack;
+	powers[0] = power + r->n;
+	powers[1] = powers[0] + r->n * count1;
+	stack = powers[1] + r->n * count2;
+	// подготовить показатели
+	b[0] = b1, b[1] = b2;
+	w[0] = qrCalcSlideWidth(m1), w[1] = qrCalcSlideWidth(m2);
+	l[0] = wwBitSize(b1, m1), l[1] = wwBitSize(b2, m2);
+	end[0] = end[1] = SIZE_MAX;
+	slide[0] = slide[1] = 0;
+	// расчет малых степеней a1, a2
+	if (l[0])
+		qrCalcSlidePowers(powers[0], a1, count1, r, stack);
+	if (l[1])
+		qrCalcSlidePowers(powers[1], a2, count2, r, stack);
+	// пробегаем биты b1, b2
+	for (pos = MAX2(l[0], l[1]); pos--;)
+	{
+		// power <- power^2
+		if (!unity)
+			qrSqr(power, power, r, stack);
+		for (i = 0; i < 2; ++i)
+		{
+			// в позиции pos начинается слайд b[i]?
+			if (end[i] == SIZE_MAX && pos < l[i] && wwTestBit(b[i], pos))
+			{
+				size_t slide_size = MIN2(pos + 1, w[i]);
+				slide[i] = wwGetBits(b[i], pos - slide_size + 1, slide_size);
+				while (slide[i] % 2 == 0)
+					slide[i] >>= 1, slide_size--;
+				end[i] = pos - slide_size + 1;
+			}
+			// в позиции pos заканчивается слайд b[i]?
+			if (end[i] == pos)
+			{
+				// power <- power * powers[i][slide[i] / 2]
+				if (unity)
+					wwCopy(power, powers[i] + r->n * (slide[i] / 2), r->n);
+				else
+					qrMul(power, power, powers[i] + r->n * (slide[i] / 2), 
+						r, stack);
+				unity = FALSE;
+				end[i] = SIZE_MAX;
+			}
+		}
+	}
+	// b1 == b2 == 0? => power <- unity
+	if (unity)
+		wwCopy(power, r->unity, r->n);
+	// очистка и возврат
+	slide[0] = slide[1] = 0;
+	wwCopy(c, power, r->n);
+}
+
+size_t qrPower2_deep(size_t n, size_t m1, size_t m2, size_t r_deep)
+{
+	const size_t count1 = SIZE_1 << (qrCalcSlideWidth(m1) - 1);
+	const size_t count2 = SIZE_1 << (qrCalcSlideWidth(m2) - 1);
+	return O_OF_W(n + n * count1 + n * count2) + r_deep;
+}
+
+/*
+*******************************************************************************
+Возведение в степень специального вида
+
+В функции qrPowerChain() показатель 2^l - d, 0 < d < 2^l, записывается 
+в виде 
+	2^l - d = (2^m - 1) 2^t + e,	t = wordBitSize(d), m = l - t, e = 2^t - d.
+Если d мало, то двоичная запись показателя начинается с длинной серии 
+единиц и этой серии соответствует степень a^{2^m - 1}. Степень 
+рассчитывается по аддитивной цепочке, которая строится по двоичной 
+записи m:
+	a^{2^{2k} - 1} = (a^{2^k - 1})^{2^k} * a^{2^k - 1},
+	a^{2^{k + 1} - 1} = (a^{2^k - 1})^2 * a.
+Затем результат t раз возводится в квадрат и умножается на a^e. Степень 
+a^e рассчитывается бинарным методом.
+
+Общее число возведений в квадрат -- около l, общее число умножений --
+около 2 log_2(m) + wordBitSize(e). Для показателей p - 2 и (p - 3) / 4, 
+где p = 2^l - c -- модуль Крэндалла (c мало), умножений требуется в 
+несколько раз меньше, чем в скользящем оконном методе qrPower().
+
+Последовательность операций определяется только l и d.
+*******************************************************************************
+*/
+
+static size_t qrBitSizeW(register word w)
+{
+	register size_t l = 0;
+	for (; w; w >>= 1, ++l);
+	return l;
+}
+
+void qrPowerChain(word b[], const word a[], size_t l, word d, 
+	const qr_o* r, void* stack)
+{
+	register size_t t;
+	register word e;
+	size_t m, k, pos;
+	// переменные в stack
+	word* x = (word*)stack;
+	word* y = x + r->n;
+	word* z = y + r->n;
+	stack = z + r->n;
+	// pre
+	ASSERT(qrIsOperable(r));
+	ASSERT(wwIsValid(a, r->n));
+	ASSERT(wwIsValid(b, r->n));
+	ASSERT(d != 0);
+	// t <- битовая длина d, e <- 2^t - d
+	t = qrBitSizeW(d);
+	e = (WORD_0 - d) & (WORD_MAX >> (B_PER_W - t));
+	ASSERT(l > t);
+	m = l - t;
+	// x <- a
+	wwCopy(x, a, r->n);
+	// y <- x^{2^k - 1}, k = 1
+	wwCopy(y, x, r->n);
+	k = 1;
+	// пробегаем биты m, начиная со второго старшего
+	pos = qrBitSizeW((word)m) - 1;
+	while (pos--)
+	{
+		size_t i;
+		// y <- y^{2^k} y = x^{2^{2k} - 1}
+		wwCopy(z, y, r->n);
+		for (i = 0; i < k; ++i)
+			qrSqr(z, z, r, stack);
+		qrMul(y, z, y, r, stack);
+		k *= 2;
+		// y <- y^2 x = x^{2^{k + 1} - 1}?
+		if ((m >> pos) & 1)
+		{
+			qrSqr(y, y, r, stack);
+			qrMul(y, y, x, r, stack);
+			++k;
+		}
+	}
+	ASSERT(k == m);
+	// y <- y^{2^t}
+	for (k = 0; k < t; ++k)
+		qrSqr(y, y, r, stack);
+	// z <- x^e
+	ASSERT(e != 0);
+	wwCopy(z, x, r->n);
+	for (pos = qrBitSizeW(e) - 1; pos--;)
+	{
+		qrSqr(z, z, r, stack);
+		if ((e >> pos) & 1)
+			qrMul(z, z, x, r, stack);
+	}
+	// b <- y z
+	qrMul(b, y, z, r, stack);
+	// очистка
+	t = 0, e = 0;
+}
+
+size_t qrPowerChain_deep(size_t n, size_t r_deep)
+{
+	return O_OF_W(3 * n) + r_deep;
+}
+
+/*
+*******************************************************************************
+Возведение в степень с фиксированным основанием
+
+В функциях qrPowerCombStart(), qrPowerComb() реализован гребенчатый метод 
+Лима -- Ли [Lim C.H., Lee P.J. More flexible exponentiation with 
+precomputation. CRYPTO 1994, LNCS 839, 95--107]. Показатель b длины l 
+битов разбивается на h строк по d = \ceil(l / h) битов:
+	b = \sum_{j = 0}^{h - 1} b_j 2^{j d},	0 <= b_j < 2^d.
+Для основания a предварительно рассчитываются элементы
+	t[i - 1] = \prod_{j: i_j = 1} a^{2^{j d}},	i = 1, 2,..., 2^h - 1,
+где i_j -- j-й бит числа i. Затем степень a^b рассчитывается за d возведений
+в квадрат и не более чем d умножений: на шаге k = d - 1,..., 0 результат 
+возводится в квадрат и умножается на t[i - 1], где i_j = k-й бит b_j.
+
+Расчет таблицы требует (h - 1) d возведений в квадрат и 2^h - h - 1 
+умножений, т.е. примерно столько же, сколько одно обычное возведение 
+в степень. Поэтому таблицу следует рассчитывать один раз для основания 
+и использовать многократно.
+
+Выбор h -- компромисс между объемом таблицы ((2^h - 1) элементов) 
+и скоростью: при l = 256 и h = 6 требуется 43 возведения в квадрат 
+и не более 43 умножений против 256 возведений в квадрат и примерно 
+43 умножений в qrPower().
+*******************************************************************************
+*/
+
+size_t qrPowerComb_keep(size_t n, size_t h)
+{
+	ASSERT(1 <= h && h < B_PER_W);
+	return O_OF_W(n * ((SIZE_1 << h) - 1));
+}
+
+void qrPowerCombStart(word t[], const word a[], size_t l, size_t h, 
+	const qr_o* r, void* stack)
+{
+	const size_t d = (l + h - 1) / h;
+	size_t i, j;
+	// pre
+	ASSERT(qrIsOperable(r));
+	ASSERT(wwIsValid(a, r->n));
+	ASSERT(l > 0 && 1 <= h && h < B_PER_W);
+	ASSERT(wwIsValid(t, r->n * ((SIZE_1 << h) - 1)));
+	// t[2^j - 1] <- a^{2^{j d}}
+	wwCopy(t, a, r->n);
+	for (j = 1; j < h; ++j)
+	{
+		word* tj = t + r->n * ((SIZE_1 << j) - 1);
+		wwCopy(tj, t + r->n * ((SIZE_1 << (j - 1)) - 1), r->n);
+		for (i = 0; i < d; ++i)
+			qrSqr(tj, tj, r, stack);
+	}
+	// t[i - 1] <- t[i - 2^j - 1] t[2^j - 1], 2^j < i < 2^{j + 1}
+	for (j = 1; j < h; ++j)
+	{
+		const size_t hi = SIZE_1 << j;
+		for (i = hi + 1; i < 2 * hi; ++i)
+			qrMul(t + r->n * (i - 1), t + r->n * (i - hi - 1), 
+				t + r->n * (hi - 1), r, stack);
+	}
+}
+
+size_t qrPowerCombStart_deep(size_t n, size_t r_deep)
+{
+	return r_deep;
+}
+
+void qrPowerComb(word c[], const word t[], const word b[], size_t m, 
+	size_t l, size_t h, const qr_o* r, void* stack)
+{
+	const size_t d = (l + h - 1) / h;
+	register size_t i;
+	register size_t j;
+	register size_t pos;
+	bool_t unity = TRUE;
+	size_t k;
+	// переменные в stack
+	word* power = (word*)stack;
+	stack = power + r->n;
+	// pre
+	ASSERT(qrIsOperable(r));
+	ASSERT(wwIsValid(b, m));
+	ASSERT(wwIsValid(c, r->n));
+	ASSERT(l > 0 && 1 <= h && h < B_PER_W);
+	ASSERT(wwBitSize(b, m) <= l);
+	ASSERT(wwIsValid(t, r->n * ((SIZE_1 << h) - 1)));
+	// power <- 1
+	wwCopy(power, r->unity, r->n);
+	// цикл по столбцам
+	for (k = d; k--;)
+	{
+		// i <- биты столбца k
+		for (i = 0, j = 0, pos = k; j < h && pos < B_OF_W(m); ++j, pos += d)
+			i |= (size_t)wwTestBit(b, pos) << j;
+		// power <- power^2 * t[i - 1]
+		if (!unity)
+			qrSqr(power, power, r, stack);
+		if (i)
+		{
+			qrMul(power, power, t + r->n * (i - 1), r, stack);
+			unity = FALSE;
+		}
+	}
+	// очистка и возврат
+	i = j = pos = 0;
+	wwCopy(c, power, r->n);
+}
+
+size_t qrPowerComb_deep(size_t n, size_t r_deep)
+{
+	return O_OF_W(n) + r_deep;
+}
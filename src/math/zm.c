@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2013.09.14
-\version 2016.07.04
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -38,27 +38,54 @@ static void zmTo(octet b[], const word a[], const qr_o* r, void* stack)
 	wwTo(b, r->no, a);
 }
 
-static void zmAdd2(word c[], const word a[], const word b[], const qr_o* r)
+static void SAFE(zmAdd2)(word c[], const word a[], const word b[], 
+	const qr_o* r)
 {
 	ASSERT(zmIsOperable(r));
 	ASSERT(zmIsIn(a, r));
 	ASSERT(zmIsIn(b, r));
-	zzAddMod(c, a, b, r->mod, r->n);
+	SAFE(zzAddMod)(c, a, b, r->mod, r->n);
 }
 
-static void zmSub2(word c[], const word a[], const word b[], const qr_o* r)
+static void FAST(zmAdd2)(word c[], const word a[], const word b[], 
+	const qr_o* r)
 {
 	ASSERT(zmIsOperable(r));
 	ASSERT(zmIsIn(a, r));
 	ASSERT(zmIsIn(b, r));
-	zzSubMod(c, a, b, r->mod, r->n);
+	FAST(zzAddMod)(c, a, b, r->mod, r->n);
 }
 
-static void zmNeg2(word b[], const word a[], const qr_o* r)
+static void SAFE(zmSub2)(word c[], const word a[], const word b[], 
+	const qr_o* r)
 {
 	ASSERT(zmIsOperable(r));
 	ASSERT(zmIsIn(a, r));
-	zzNegMod(b, a, r->mod, r->n);
+	ASSERT(zmIsIn(b, r));
+	SAFE(zzSubMod)(c, a, b, r->mod, r->n);
+}
+
+static void FAST(zmSub2)(word c[], const word a[], const word b[], 
+	const qr_o* r)
+{
+	ASSERT(zmIsOperable(r));
+	ASSERT(zmIsIn(a, r));
+	ASSERT(zmIsIn(b, r));
+	FAST(zzSubMod)(c, a, b, r->mod, r->n);
+}
+
+static void SAFE(zmNeg2)(word b[], const word a[], const qr_o* r)
+{
+	ASSERT(zmIsOperable(r));
+	ASSERT(zmIsIn(a, r));
+	SAFE(zzNegMod)(b, a, r->mod, r->n);
+}
+
+static void FAST(zmNeg2)(word b[], const word a[], const qr_o* r)
+{
+	ASSERT(zmIsOperable(r));
+	ASSERT(zmIsIn(a, r));
+	FAST(zzNegMod)(b, a, r->mod, r->n);
 }
 
 static void zmMul(word c[], const word a[], const word b[],
@@ -76,9 +103,10 @@ static void zmMul(word c[], const word a[], const word b[],
 
 static size_t zmMul_deep(size_t n)
 {
-	return utilMax(2,
-		zzMul_deep(n, n),
-		zzRed_deep(n));
+	return O_OF_W(2 * n) +
+		utilMax(2,
+			zzMul_deep(n, n),
+			zzRed_deep(n));
 }
 
 static void zmSqr(word b[], const word a[], const qr_o* r, void* stack)
@@ -94,9 +122,10 @@ static void zmSqr(word b[], const word a[], const qr_o* r, void* stack)
 
 static size_t zmSqr_deep(size_t n)
 {
-	return utilMax(2,
-		zzSqr_deep(n),
-		zzRed_deep(n));
+	return O_OF_W(2 * n) +
+		utilMax(2,
+			zzSqr_deep(n),
+			zzRed_deep(n));
 }
 
 static void zmInv(word b[], const word a[], const qr_o* r, void* stack)
@@ -152,6 +181,7 @@ void zmCreatePlain(qr_o* r, const octet mod[], size_t no, void* stack)
 	r->sqr = zmSqr;
 	r->inv = zmInv;
 	r->div = zmDiv;
+	r->safe = SAFE_DEFAULT;
 	r->deep = utilMax(4,
 		zmMul_deep(r->n),
 		zmSqr_deep(r->n),
@@ -185,7 +215,7 @@ size_t zmCreatePlain_deep(size_t no)
 *******************************************************************************
 */
 
-static void zmMulCrand(word c[], const word a[], const word b[],
+static void SAFE(zmMulCrand)(word c[], const word a[], const word b[],
 	const qr_o* r, void* stack)
 {
 	word* prod = (word*)stack;
@@ -194,35 +224,159 @@ static void zmMulCrand(word c[], const word a[], const word b[],
 	ASSERT(zmIsIn(b, r));
 	stack = prod + 2 * r->n;
 	zzMul(prod, a, r->n, b, r->n, stack);
-	zzRedCrand(prod, r->mod, r->n, stack);
+	SAFE(zzRedCrand)(prod, r->mod, r->n, stack);
+	wwCopy(c, prod, r->n);
+}
+
+static void FAST(zmMulCrand)(word c[], const word a[], const word b[],
+	const qr_o* r, void* stack)
+{
+	word* prod = (word*)stack;
+	ASSERT(zmIsOperable(r));
+	ASSERT(zmIsIn(a, r));
+	ASSERT(zmIsIn(b, r));
+	stack = prod + 2 * r->n;
+	zzMul(prod, a, r->n, b, r->n, stack);
+	FAST(zzRedCrand)(prod, r->mod, r->n, stack);
 	wwCopy(c, prod, r->n);
 }
 
 static size_t zmMulCrand_deep(size_t n)
 {
-	return utilMax(2,
-		zzMul_deep(n, n),
-		zzRedCrand_deep(n));
+	return O_OF_W(2 * n) +
+		utilMax(2,
+			zzMul_deep(n, n),
+			zzRedCrand_deep(n));
+}
+
+static void SAFE(zmSqrCrand)(word b[], const word a[], const qr_o* r, void* stack)
+{
+	word* prod = (word*)stack;
+	ASSERT(zmIsOperable(r));
+	ASSERT(zmIsIn(a, r));
+	stack = prod + 2 * r->n;
+	zzSqr(prod, a, r->n, stack);
+	SAFE(zzRedCrand)(prod, r->mod, r->n, stack);
+	wwCopy(b, prod, r->n);
 }
 
-static void zmSqrCrand(word b[], const word a[], const qr_o* r, void* stack)
+static void FAST(zmSqrCrand)(word b[], const word a[], const qr_o* r, void* stack)
 {
 	word* prod = (word*)stack;
 	ASSERT(zmIsOperable(r));
 	ASSERT(zmIsIn(a, r));
 	stack = prod + 2 * r->n;
 	zzSqr(prod, a, r->n, stack);
-	zzRedCrand(prod, r->mod, r->n, stack);
+	FAST(zzRedCrand)(prod, r->mod, r->n, stack);
 	wwCopy(b, prod, r->n);
 }
 
 static size_t zmSqrCrand_deep(size_t n)
 {
-	return utilMax(2,
-		zzSqr_deep(n),
-		zzRedCrand_deep(n));
+	return O_OF_W(2 * n) +
+		utilMax(2,
+			zzSqr_deep(n),
+			zzRedCrand_deep(n));
+}
+
+/*
+*******************************************************************************
+Специализированные ядра редукции Крэндалла
+
+Для модулей mod = B^n - c длины 256, 384 и 512 битов (именно такие модули 
+используются в стандартных кривых СТБ 34.101.45) умножение и возведение 
+в квадрат выполняются функциями zmMulCrandW() / zmSqrCrandW(). Произведение
+рассчитывается функциями zzMul() / zzSqr(), которые при n <= 8 вызывают 
+развернутые ядра Комбы (см. zz_mul.c).
+
+Редукция выполняется в функции zmRedCrandW() по той же схеме, что и 
+в zzRedCrand(), но без ветвлений: на последнем шаге вычитание модуля
+(прибавление c) выполняется по маске.
+
+Ядра поддерживаются только при B_PER_W == 64, когда n = 4, 6, 8.
+*******************************************************************************
+*/
+
+#if (B_PER_W == 64)
+
+static void zmRedCrandW(word b[], const word a[], size_t n, word c, 
+	void* stack)
+{
+	register dword acc;
+	register word carry;
+	register word mask;
+	size_t i;
+	// переменные в stack
+	word* t = (word*)stack;
+	// pre
+	ASSERT(2 <= n && n <= 8);
+	ASSERT(wwIsDisjoint2(a, 2 * n, t, n));
+	// iter1: b <- a0 + a1 c
+	for (i = 0, carry = 0; i < n; ++i)
+	{
+		acc = (dword)a[n + i] * c + a[i] + carry;
+		b[i] = (word)acc;
+		carry = (word)(acc >> B_PER_W);
+	}
+	// iter2: b <- b + carry c
+	acc = (dword)carry * c + b[0];
+	b[0] = (word)acc;
+	carry = (word)(acc >> B_PER_W);
+	for (i = 1; i < n; ++i)
+		b[i] += carry, carry = (word)(b[i] < carry);
+	// t <- b + c
+	acc = (dword)b[0] + c;
+	t[0] = (word)acc;
+	mask = (word)(acc >> B_PER_W);
+	for (i = 1; i < n; ++i)
+		t[i] = b[i] + mask, mask = (word)(t[i] < mask);
+	// correct: b >= B^n - c => b <- t
+	mask = WORD_0 - (carry | mask);
+	for (i = 0; i < n; ++i)
+		b[i] = (t[i] & mask) | (b[i] & ~mask);
+	// очистка
+	acc = 0;
+	carry = mask = 0;
+}
+
+static void zmMulCrandW(word c[], const word a[], const word b[],
+	const qr_o* r, void* stack)
+{
+	word* t = (word*)stack;
+	ASSERT(zmIsOperable(r));
+	ASSERT(zmIsIn(a, r));
+	ASSERT(zmIsIn(b, r));
+	stack = t + 2 * r->n;
+	// t <- a * b
+	zzMul(t, a, r->n, b, r->n, stack);
+	// c <- t \mod r->mod
+	zmRedCrandW(c, t, r->n, WORD_0 - r->mod[0], stack);
+}
+
+static void zmSqrCrandW(word b[], const word a[], const qr_o* r,
+	void* stack)
+{
+	word* t = (word*)stack;
+	ASSERT(zmIsOperable(r));
+	ASSERT(zmIsIn(a, r));
+	stack = t + 2 * r->n;
+	// t <- a^2
+	zzSqr(t, a, r->n, stack);
+	// b <- t \mod r->mod
+	zmRedCrandW(b, t, r->n, WORD_0 - r->mod[0], stack);
 }
 
+static size_t zmMulCrandW_deep(size_t n)
+{
+	return O_OF_W(2 * n) +
+		utilMax(3,
+			zzMul_deep(n, n),
+			zzSqr_deep(n),
+			O_OF_W(n));
+}
+
+#endif /* B_PER_W == 64 */
+
 void zmCreateCrand(qr_o* r, const octet mod[], size_t no, void* stack)
 {
 	ASSERT(memIsValid(r, sizeof(qr_o)));
@@ -253,11 +407,24 @@ void zmCreateCrand(qr_o* r, const octet mod[], size_t no, void* stack)
 	r->sqr = zmSqrCrand;
 	r->inv = zmInv;
 	r->div = zmDiv;
+	r->safe = SAFE_DEFAULT;
+#if (B_PER_W == 64)
+	// специализированные ядра
+	if (r->n == 4 || r->n == 6 || r->n == 8)
+		r->mul = zmMulCrandW, r->sqr = zmSqrCrandW;
+	r->deep = utilMax(5,
+		zmMulCrand_deep(r->n),
+		zmSqrCrand_deep(r->n),
+		zmMulCrandW_deep(r->n),
+		zmInv_deep(r->n),
+		zmDiv_deep(r->n));
+#else
 	r->deep = utilMax(4,
 		zmMulCrand_deep(r->n),
 		zmSqrCrand_deep(r->n),
 		zmInv_deep(r->n),
 		zmDiv_deep(r->n));
+#endif
 	// настроить заголовок
 	r->hdr.keep = sizeof(qr_o) + O_OF_W(2 * r->n);
 	r->hdr.p_count = 3;
@@ -273,11 +440,20 @@ size_t zmCreateCrand_keep(size_t no)
 size_t zmCreateCrand_deep(size_t no)
 {
 	const size_t n = W_OF_O(no);
+#if (B_PER_W == 64)
+	return utilMax(5,
+		zmMulCrand_deep(n),
+		zmSqrCrand_deep(n),
+		zmMulCrandW_deep(n),
+		zmInv_deep(n),
+		zmDiv_deep(n));
+#else
 	return utilMax(4,
 		zmMulCrand_deep(n),
 		zmSqrCrand_deep(n),
 		zmInv_deep(n),
 		zmDiv_deep(n));
+#endif
 }
 
 /*
@@ -286,7 +462,20 @@ size_t zmCreateCrand_deep(size_t no)
 *******************************************************************************
 */
 
-static void zmMulBarr(word c[], const word a[], const word b[],
+static void SAFE(zmMulBarr)(word c[], const word a[], const word b[],
+	const qr_o* r, void* stack)
+{
+	word* prod = (word*)stack;
+	ASSERT(zmIsOperable(r));
+	ASSERT(zmIsIn(a, r));
+	ASSERT(zmIsIn(b, r));
+	stack = prod + 2 * r->n;
+	zzMul(prod, a, r->n, b, r->n, stack);
+	SAFE(zzRedBarr)(prod, r->mod, r->n, r->params, stack);
+	wwCopy(c, prod, r->n);
+}
+
+static void FAST(zmMulBarr)(word c[], const word a[], const word b[],
 	const qr_o* r, void* stack)
 {
 	word* prod = (word*)stack;
@@ -295,33 +484,46 @@ static void zmMulBarr(word c[], const word a[], const word b[],
 	ASSERT(zmIsIn(b, r));
 	stack = prod + 2 * r->n;
 	zzMul(prod, a, r->n, b, r->n, stack);
-	zzRedBarr(prod, r->mod, r->n, r->params, stack);
+	FAST(zzRedBarr)(prod, r->mod, r->n, r->params, stack);
 	wwCopy(c, prod, r->n);
 }
 
 static size_t zmMulBarr_deep(size_t n)
 {
-	return utilMax(2,
-		zzMul_deep(n, n),
-		zzRedBarr_deep(n));
+	return O_OF_W(2 * n) +
+		utilMax(2,
+			zzMul_deep(n, n),
+			zzRedBarr_deep(n));
+}
+
+static void SAFE(zmSqrBarr)(word b[], const word a[], const qr_o* r, void* stack)
+{
+	word* prod = (word*)stack;
+	ASSERT(zmIsOperable(r));
+	ASSERT(zmIsIn(a, r));
+	stack = prod + 2 * r->n;
+	zzSqr(prod, a, r->n, stack);
+	SAFE(zzRedBarr)(prod, r->mod, r->n, r->params, stack);
+	wwCopy(b, prod, r->n);
 }
 
-static void zmSqrBarr(word b[], const word a[], const qr_o* r, void* stack)
+static void FAST(zmSqrBarr)(word b[], const word a[], const qr_o* r, void* stack)
 {
 	word* prod = (word*)stack;
 	ASSERT(zmIsOperable(r));
 	ASSERT(zmIsIn(a, r));
 	stack = prod + 2 * r->n;
 	zzSqr(prod, a, r->n, stack);
-	zzRedBarr(prod, r->mod, r->n, r->params, stack);
+	FAST(zzRedBarr)(prod, r->mod, r->n, r->params, stack);
 	wwCopy(b, prod, r->n);
 }
 
 static size_t zmSqrBarr_deep(size_t n)
 {
-	return utilMax(2,
-		zzSqr_deep(n),
-		zzRedBarr_deep(n));
+	return O_OF_W(2 * n) +
+		utilMax(2,
+			zzSqr_deep(n),
+			zzRedBarr_deep(n));
 }
 
 void zmCreateBarr(qr_o* r, const octet mod[], size_t no, void* stack)
@@ -352,6 +554,7 @@ void zmCreateBarr(qr_o* r, const octet mod[], size_t no, void* stack)
 	r->sqr = zmSqrBarr;
 	r->inv = zmInv;
 	r->div = zmDiv;
+	r->safe = SAFE_DEFAULT;
 	r->deep = utilMax(4,
 		zmMulBarr_deep(r->n),
 		zmSqrBarr_deep(r->n),
@@ -435,7 +638,7 @@ static size_t zmToMont_deep(size_t n)
 	return O_OF_W(2 * n) + zzRedMont_deep(n);
 }
 
-static void zmMulMont(word c[], const word a[], const word b[],
+static void SAFE(zmMulMont)(word c[], const word a[], const word b[],
 	const qr_o* r, void* stack)
 {
 	word* prod = (word*)stack;
@@ -444,73 +647,229 @@ static void zmMulMont(word c[], const word a[], const word b[],
 	ASSERT(zmIsIn(b, r));
 	stack = prod + 2 * r->n;
 	zzMul(prod, a, r->n, b, r->n, stack);
-	zzRedMont(prod, r->mod, r->n, *(word*)r->params, stack);
+	SAFE(zzRedMont)(prod, r->mod, r->n, *(word*)r->params, stack);
+	wwCopy(c, prod, r->n);
+}
+
+static void FAST(zmMulMont)(word c[], const word a[], const word b[],
+	const qr_o* r, void* stack)
+{
+	word* prod = (word*)stack;
+	ASSERT(zmIsOperable(r));
+	ASSERT(zmIsIn(a, r));
+	ASSERT(zmIsIn(b, r));
+	stack = prod + 2 * r->n;
+	zzMul(prod, a, r->n, b, r->n, stack);
+	FAST(zzRedMont)(prod, r->mod, r->n, *(word*)r->params, stack);
 	wwCopy(c, prod, r->n);
 }
 
 static size_t zmMulMont_deep(size_t n)
 {
-	return utilMax(2,
-		zzMul_deep(n, n),
-		zzRedMont_deep(n));
+	return O_OF_W(2 * n) +
+		utilMax(2,
+			zzMul_deep(n, n),
+			zzRedMont_deep(n));
+}
+
+static void SAFE(zmSqrMont)(word b[], const word a[], const qr_o* r, void* stack)
+{
+	word* prod = (word*)stack;
+	ASSERT(zmIsOperable(r));
+	ASSERT(zmIsIn(a, r));
+	stack = prod + 2 * r->n;
+	zzSqr(prod, a, r->n, stack);
+	SAFE(zzRedMont)(prod, r->mod, r->n, *(word*)r->params, stack);
+	wwCopy(b, prod, r->n);
 }
 
-static void zmSqrMont(word b[], const word a[], const qr_o* r, void* stack)
+static void FAST(zmSqrMont)(word b[], const word a[], const qr_o* r, void* stack)
 {
 	word* prod = (word*)stack;
 	ASSERT(zmIsOperable(r));
 	ASSERT(zmIsIn(a, r));
 	stack = prod + 2 * r->n;
 	zzSqr(prod, a, r->n, stack);
-	zzRedMont(prod, r->mod, r->n, *(word*)r->params, stack);
+	FAST(zzRedMont)(prod, r->mod, r->n, *(word*)r->params, stack);
 	wwCopy(b, prod, r->n);
 }
 
 static size_t zmSqrMont_deep(size_t n)
 {
-	return utilMax(2,
-		zzSqr_deep(n),
-		zzRedMont_deep(n));
+	return O_OF_W(2 * n) +
+		utilMax(2,
+			zzSqr_deep(n),
+			zzRedMont_deep(n));
 }
 
-static void zmInvMont(word b[], const word a[], const qr_o* r, void* stack)
+/*
+*******************************************************************************
+Специализированные ядра редукции Монтгомери
+
+Для 512-битовых модулей (такие модули используются, например, в наборе 
+параметров id-tc26-gost-3410-12-512-paramSetB, см. g12s.c) умножение 
+и возведение в квадрат выполняются функциями zmMulMont8() / zmSqrMont8(). 
+Произведение рассчитывается функциями zzMul() / zzSqr() (развернутые ядра 
+Комбы, см. zz_mul.c), редукция Монтгомери zmRedMont8() -- по строкам: в строке i к t прибавляется (t[i] m* \mod B) mod B^i. Итоговое 
+вычитание модуля выполняется по маске.
+
+Ядра поддерживаются только при B_PER_W == 64, когда n = 8.
+*******************************************************************************
+*/
+
+#if (B_PER_W == 64)
+
+#define _ZM_MONT_MAC(i, j)\
+	acc = (dword)w * mod[j] + t[(i) + (j)] + carry,\
+	t[(i) + (j)] = (word)acc, carry = (word)(acc >> B_PER_W)
+
+#define _ZM_MONT_ROW(i)\
+	w = t[i] * mont_param,\
+	acc = (dword)w * mod[0] + t[i], carry = (word)(acc >> B_PER_W),\
+	_ZM_MONT_MAC(i, 1), _ZM_MONT_MAC(i, 2), _ZM_MONT_MAC(i, 3),\
+	_ZM_MONT_MAC(i, 4), _ZM_MONT_MAC(i, 5), _ZM_MONT_MAC(i, 6),\
+	_ZM_MONT_MAC(i, 7),\
+	acc = (dword)t[(i) + 8] + carry + over,\
+	t[(i) + 8] = (word)acc, over = (word)(acc >> B_PER_W)
+
+static void zmRedMont8(word b[], word t[], const word mod[], 
+	register word mont_param)
 {
-	register size_t k;
+	register dword acc;
+	register word carry;
+	register word over = 0;
+	register word w;
+	register word mask;
+	// pre
+	ASSERT(wwIsDisjoint2(t, 16, mod, 8));
+	ASSERT(mod[7] != 0 && mod[0] % 2);
+	ASSERT((word)(mod[0] * mont_param + 1) == 0);
+	// t <- (t + (t * m* \mod B^8) mod) / B^8
+	_ZM_MONT_ROW(0);
+	_ZM_MONT_ROW(1);
+	_ZM_MONT_ROW(2);
+	_ZM_MONT_ROW(3);
+	_ZM_MONT_ROW(4);
+	_ZM_MONT_ROW(5);
+	_ZM_MONT_ROW(6);
+	_ZM_MONT_ROW(7);
+	// b <- t - mod (если t >= mod)
+	acc = (dword)t[8] - mod[0];
+	b[0] = (word)acc;
+	acc = (dword)t[9] - mod[1] - (word)(acc >> (2 * B_PER_W - 1));
+	b[1] = (word)acc;
+	acc = (dword)t[10] - mod[2] - (word)(acc >> (2 * B_PER_W - 1));
+	b[2] = (word)acc;
+	acc = (dword)t[11] - mod[3] - (word)(acc >> (2 * B_PER_W - 1));
+	b[3] = (word)acc;
+	acc = (dword)t[12] - mod[4] - (word)(acc >> (2 * B_PER_W - 1));
+	b[4] = (word)acc;
+	acc = (dword)t[13] - mod[5] - (word)(acc >> (2 * B_PER_W - 1));
+	b[5] = (word)acc;
+	acc = (dword)t[14] - mod[6] - (word)(acc >> (2 * B_PER_W - 1));
+	b[6] = (word)acc;
+	acc = (dword)t[15] - mod[7] - (word)(acc >> (2 * B_PER_W - 1));
+	b[7] = (word)acc;
+	mask = WORD_0 - ((word)(acc >> (2 * B_PER_W - 1)) & (over ^ 1));
+	b[0] = (b[0] & ~mask) | (t[8] & mask);
+	b[1] = (b[1] & ~mask) | (t[9] & mask);
+	b[2] = (b[2] & ~mask) | (t[10] & mask);
+	b[3] = (b[3] & ~mask) | (t[11] & mask);
+	b[4] = (b[4] & ~mask) | (t[12] & mask);
+	b[5] = (b[5] & ~mask) | (t[13] & mask);
+	b[6] = (b[6] & ~mask) | (t[14] & mask);
+	b[7] = (b[7] & ~mask) | (t[15] & mask);
+	// очистка
+	acc = 0;
+	carry = over = w = mask = 0;
+}
+
+static void zmMulMont8(word c[], const word a[], const word b[],
+	const qr_o* r, void* stack)
+{
+	word* t = (word*)stack;
 	ASSERT(zmIsOperable(r));
+	ASSERT(r->n == 8);
 	ASSERT(zmIsIn(a, r));
-	// b <- a^{-1} 2^k \mod mod
-	k = zzAlmostInvMod(b, a, r->mod, r->n, stack);
-	ASSERT(wwBitSize(r->mod, r->n) <= k);
-	ASSERT(k <= 2 * wwBitSize(r->mod, r->n));
-	// b <- a^{-1} R^2 \mod mod
-	for (; k < 2 * r->n * B_PER_W; ++k)
-		zzDoubleMod(b, b, r->mod, r->n);
+	ASSERT(zmIsIn(b, r));
+	stack = t + 16;
+	// t <- a * b
+	zzMul(t, a, 8, b, 8, stack);
+	// c <- t / R \mod r->mod
+	zmRedMont8(c, t, r->mod, *(word*)r->params);
 }
 
-static size_t zmInvMont_deep(size_t n)
+static void zmSqrMont8(word b[], const word a[], const qr_o* r,
+	void* stack)
 {
-	return zzAlmostInvMod_deep(n);
+	word* t = (word*)stack;
+	ASSERT(zmIsOperable(r));
+	ASSERT(r->n == 8);
+	ASSERT(zmIsIn(a, r));
+	stack = t + 16;
+	// t <- a^2
+	zzSqr(t, a, 8, stack);
+	// b <- t / R \mod r->mod
+	zmRedMont8(b, t, r->mod, *(word*)r->params);
 }
 
-static void zmDivMont(word b[], const word divident[], const word a[],
-	const qr_o* r, void* stack)
+static size_t zmMulMont8_deep()
+{
+	return O_OF_W(16) +
+		utilMax(2,
+			zzMul_deep(8, 8),
+			zzSqr_deep(8));
+}
+
+#endif /* B_PER_W == 64 */
+
+static void zmDivMontL(word b[], const word divident[], const word a[],
+	const qr_o* r, size_t l, void* stack)
 {
 	word* c = (word*)stack;
 	ASSERT(zmIsOperable(r));
 	ASSERT(zmIsIn(divident, r));
 	ASSERT(zmIsIn(a, r));
-	stack = c + r->n;
-	// c <- a^{(-1)} (в кольце Монтгомери)
-	zmInvMont(c, a, r, stack);
-	// b <- divident * c
-	zmMulMont(b, divident, c, r, stack);
+	ASSERT(l <= B_OF_W(r->n));
+	stack = c + 2 * r->n;
+	// c <- divident 2^l \mod mod
+	wwCopy(c, divident, r->n);
+	wwSetZero(c + r->n, r->n);
+	wwShHi(c, 2 * r->n, l);
+	zzMod(c, c, 2 * r->n, r->mod, r->n, stack);
+	// b <- c / a \mod mod
+	zzDivMod(b, c, a, r->mod, r->n, stack);
+}
+
+static size_t zmDivMontL_deep(size_t n)
+{
+	return O_OF_W(2 * n) +
+		utilMax(2,
+			zzMod_deep(2 * n, n),
+			zzDivMod_deep(n));
+}
+
+static void zmInvMont(word b[], const word a[], const qr_o* r, void* stack)
+{
+	// b <- R^2 / (a R) = a^{-1} R \mod mod
+	zmDivMontL(b, r->unity, a, r, B_OF_W(r->n), stack);
+}
+
+static size_t zmInvMont_deep(size_t n)
+{
+	return zmDivMontL_deep(n);
+}
+
+static void zmDivMont(word b[], const word divident[], const word a[],
+	const qr_o* r, void* stack)
+{
+	// b <- (divident R) / (a R) \cdot R = divident a^{-1} R \mod mod
+	zmDivMontL(b, divident, a, r, B_OF_W(r->n), stack);
 }
 
 static size_t zmDivMont_deep(size_t n)
 {
-	return utilMax(2,
-		zmInvMont_deep(n),
-		zmMulMont_deep(n));
+	return zmDivMontL_deep(n);
 }
 
 void zmCreateMont(qr_o* r, const octet mod[], size_t no, void* stack)
@@ -543,6 +902,7 @@ void zmCreateMont(qr_o* r, const octet mod[], size_t no, void* stack)
 	r->sqr = zmSqrMont;
 	r->inv = zmInvMont;
 	r->div = zmDivMont;
+	r->safe = SAFE_DEFAULT;
 	r->deep = utilMax(6,
 		zmFromMont_deep(r->n),
 		zmToMont_deep(r->n),
@@ -550,6 +910,14 @@ void zmCreateMont(qr_o* r, const octet mod[], size_t no, void* stack)
 		zmSqrMont_deep(r->n),
 		zmInvMont_deep(r->n),
 		zmDivMont_deep(r->n));
+#if (B_PER_W == 64)
+	// специализированные ядра
+	if (r->n == 8)
+	{
+		r->mul = zmMulMont8, r->sqr = zmSqrMont8;
+		r->deep = MAX2(r->deep, zmMulMont8_deep());
+	}
+#endif
 	// настроить заголовок
 	r->hdr.keep = sizeof(qr_o) + O_OF_W(2 * r->n + 1);
 	r->hdr.p_count = 3;
@@ -565,6 +933,17 @@ size_t zmCreateMont_keep(size_t no)
 size_t zmCreateMont_deep(size_t no)
 {
 	const size_t n = W_OF_O(no);
+#if (B_PER_W == 64)
+	return utilMax(8,
+		zzMod_deep(n, n),
+		zmFromMont_deep(n),
+		zmToMont_deep(n),
+		zmMulMont_deep(n),
+		zmSqrMont_deep(n),
+		zmMulMont8_deep(),
+		zmInvMont_deep(n),
+		zmDivMont_deep(n));
+#else
 	return utilMax(7,
 		zzMod_deep(n, n),
 		zmFromMont_deep(n),
@@ -573,6 +952,7 @@ size_t zmCreateMont_deep(size_t no)
 		zmSqrMont_deep(n),
 		zmInvMont_deep(n),
 		zmDivMont_deep(n));
+#endif
 }
 
 /*
@@ -648,7 +1028,29 @@ typedef struct
 	size_t l;			/* размерность */
 } zm_mont_params_st;
 
-static void zmMulMont2(word c[], const word a[], const word b[],
+static void SAFE(zmMulMont2)(word c[], const word a[], const word b[],
+	const qr_o* r, void* stack)
+{
+	register size_t k;
+	const zm_mont_params_st* params;
+	word* prod = (word*)stack;
+	// pre
+	ASSERT(zmIsOperable(r));
+	ASSERT(zmIsIn(a, r));
+	ASSERT(zmIsIn(b, r));
+	// настроить указатели
+	params = (const zm_mont_params_st*)r->params;
+	stack = prod + 2 * r->n;
+	// c <- a b B^{-n} \mod mod
+	zzMul(prod, a, r->n, b, r->n, stack);
+	SAFE(zzRedMont)(prod, r->mod, r->n, *(word*)r->params, stack);
+	wwCopy(c, prod, r->n);
+	// c <- c * B^n / 2^l \mod mod
+	for (k = params->l; k < B_PER_W * r->n; ++k)
+		SAFE(zzDoubleMod)(c, c, r->mod, r->n);
+}
+
+static void FAST(zmMulMont2)(word c[], const word a[], const word b[],
 	const qr_o* r, void* stack)
 {
 	register size_t k;
@@ -663,21 +1065,22 @@ static void zmMulMont2(word c[], const word a[], const word b[],
 	stack = prod + 2 * r->n;
 	// c <- a b B^{-n} \mod mod
 	zzMul(prod, a, r->n, b, r->n, stack);
-	zzRedMont(prod, r->mod, r->n, *(word*)r->params, stack);
+	FAST(zzRedMont)(prod, r->mod, r->n, *(word*)r->params, stack);
 	wwCopy(c, prod, r->n);
 	// c <- c * B^n / 2^l \mod mod
 	for (k = params->l; k < B_PER_W * r->n; ++k)
-		zzDoubleMod(c, c, r->mod, r->n);
+		FAST(zzDoubleMod)(c, c, r->mod, r->n);
 }
 
 static size_t zmMulMont2_deep(size_t n)
 {
-	return utilMax(2,
-		zzMul_deep(n, n),
-		zzRedMont_deep(n));
+	return O_OF_W(2 * n) +
+		utilMax(2,
+			zzMul_deep(n, n),
+			zzRedMont_deep(n));
 }
 
-static void zmSqrMont2(word b[], const word a[], const qr_o* r, void* stack)
+static void SAFE(zmSqrMont2)(word b[], const word a[], const qr_o* r, void* stack)
 {
 	register size_t k;
 	const zm_mont_params_st* params;
@@ -690,60 +1093,64 @@ static void zmSqrMont2(word b[], const word a[], const qr_o* r, void* stack)
 	stack = prod + 2 * r->n;
 	// b <- a^2 B^{-n} \mod mod
 	zzSqr(prod, a, r->n, stack);
-	zzRedMont(prod, r->mod, r->n, *(word*)r->params, stack);
+	SAFE(zzRedMont)(prod, r->mod, r->n, *(word*)r->params, stack);
 	wwCopy(b, prod, r->n);
 	// b <- b * B^n / 2^l \mod mod
 	for (k = params->l; k < B_PER_W * r->n; ++k)
-		zzDoubleMod(b, b, r->mod, r->n);
+		SAFE(zzDoubleMod)(b, b, r->mod, r->n);
 }
 
-static size_t zmSqrMont2_deep(size_t n)
-{
-	return utilMax(2,
-		zzSqr_deep(n),
-		zzRedMont_deep(n));
-}
-
-static void zmInvMont2(word b[], const word a[], const qr_o* r, void* stack)
+static void FAST(zmSqrMont2)(word b[], const word a[], const qr_o* r, void* stack)
 {
 	register size_t k;
 	const zm_mont_params_st* params;
+	word* prod = (word*)stack;
+	// pre
 	ASSERT(zmIsOperable(r));
 	ASSERT(zmIsIn(a, r));
+	// настроить указатели
 	params = (const zm_mont_params_st*)r->params;
-	// b <- a^{-1} 2^k \mod mod
-	k = zzAlmostInvMod(b, a, r->mod, r->n, stack);
-	ASSERT(wwBitSize(r->mod, r->n) <= k);
-	ASSERT(k <= 2 * wwBitSize(r->mod, r->n));
-	// b <- a^{-1} R^2 \mod mod
-	for (; k < 2 * params->l; ++k)
-		zzDoubleMod(b, b, r->mod, r->n);
+	stack = prod + 2 * r->n;
+	// b <- a^2 B^{-n} \mod mod
+	zzSqr(prod, a, r->n, stack);
+	FAST(zzRedMont)(prod, r->mod, r->n, *(word*)r->params, stack);
+	wwCopy(b, prod, r->n);
+	// b <- b * B^n / 2^l \mod mod
+	for (k = params->l; k < B_PER_W * r->n; ++k)
+		FAST(zzDoubleMod)(b, b, r->mod, r->n);
+}
+
+static size_t zmSqrMont2_deep(size_t n)
+{
+	return O_OF_W(2 * n) +
+		utilMax(2,
+			zzSqr_deep(n),
+			zzRedMont_deep(n));
+}
+
+static void zmInvMont2(word b[], const word a[], const qr_o* r, void* stack)
+{
+	const zm_mont_params_st* params = (const zm_mont_params_st*)r->params;
+	// b <- R^2 / (a R) = a^{-1} R \mod mod
+	zmDivMontL(b, r->unity, a, r, params->l, stack);
 }
 
 static size_t zmInvMont2_deep(size_t n)
 {
-	return zzAlmostInvMod_deep(n);
+	return zmDivMontL_deep(n);
 }
 
 static void zmDivMont2(word b[], const word divident[], const word a[],
 	const qr_o* r, void* stack)
 {
-	word* c = (word*)stack;
-	ASSERT(zmIsOperable(r));
-	ASSERT(zmIsIn(divident, r));
-	ASSERT(zmIsIn(a, r));
-	stack = c + r->n;
-	// c <- a^{(-1)} (в кольце Монтгомери)
-	zmInvMont2(c, a, r, stack);
-	// b <- divident * c
-	zmMulMont2(b, divident, c, r, stack);
+	const zm_mont_params_st* params = (const zm_mont_params_st*)r->params;
+	// b <- (divident R) / (a R) \cdot R = divident a^{-1} R \mod mod
+	zmDivMontL(b, divident, a, r, params->l, stack);
 }
 
 static size_t zmDivMont2_deep(size_t n)
 {
-	return utilMax(2,
-		zmInvMont2_deep(n),
-		zmMulMont2_deep(n));
+	return zmDivMontL_deep(n);
 }
 
 void zmMontCreate(qr_o* r, const octet mod[], size_t no, size_t l, void* stack)
@@ -781,6 +1188,7 @@ void zmMontCreate(qr_o* r, const octet mod[], size_t no, size_t l, void* stack)
 	r->sqr = zmSqrMont2;
 	r->inv = zmInvMont2;
 	r->div = zmDivMont2;
+	r->safe = SAFE_DEFAULT;
 	r->deep = utilMax(4,
 		zmMulMont2_deep(r->n),
 		zmSqrMont2_deep(r->n),
@@ -808,3 +1216,113 @@ size_t zmMontCreate_deep(size_t no)
 		zmInvMont_deep(n),
 		zmDivMont_deep(n));
 }
+
+/*
+*******************************************************************************
+Возведение в степень
+*******************************************************************************
+*/
+
+void zmPowerMod(word c[], const word a[], const word b[], size_t m,
+	const qr_o* r, void* stack)
+{
+	// переменные в stack
+	word* t = (word*)stack;
+	stack = t + r->n;
+	// pre
+	ASSERT(zmIsOperable(r));
+	ASSERT(wwCmp(a, r->mod, r->n) < 0);
+	// t <- a
+	wwTo(t, r->no, a);
+	qrFrom(t, (octet*)t, r, stack);
+	// t <- a^b
+	qrPower(t, t, b, m, r, stack);
+	// c <- t
+	qrTo((octet*)t, t, r, stack);
+	wwFrom(c, t, r->no);
+}
+
+size_t zmPowerMod_deep(size_t n, size_t m, size_t f_deep)
+{
+	return O_OF_W(n) + qrPower_deep(n, m, f_deep);
+}
+
+/*
+*******************************************************************************
+Степень для извлечения квадратного корня
+
+Если модуль p имеет вид Крэндалла, т.е. p = B^n - c, 0 < c < B, то
+	(p - 3) / 4 = 2^{B_PER_W * n - 2} - ((c >> 2) + 1)
+и для возведения в степень используется аддитивная цепочка qrPowerChain().
+Учитывается, что c \equiv 1 \mod 4. Для остальных модулей используется
+скользящий оконный метод qrPower().
+*******************************************************************************
+*/
+
+void zmPowerSqrt(word b[], const word a[], const qr_o* r, void* stack)
+{
+	word* e = (word*)stack;
+	ASSERT(zmIsOperable(r));
+	ASSERT(zmIsIn(a, r));
+	ASSERT(wwGetBits(r->mod, 0, 2) == 3);
+	// модуль Крэндалла?
+	if (r->n >= 2 && wwIsRepW(r->mod + 1, r->n - 1, WORD_MAX))
+	{
+		qrPowerChain(b, a, B_OF_W(r->n) - 2, ((WORD_0 - r->mod[0]) >> 2) + 1,
+			r, stack);
+		return;
+	}
+	// e <- (p - 3) / 4
+	stack = e + r->n;
+	wwCopy(e, r->mod, r->n);
+	wwShLo(e, r->n, 2);
+	// b <- a^e
+	qrPower(b, a, e, r->n, r, stack);
+}
+
+size_t zmPowerSqrt_deep(size_t n, size_t f_deep)
+{
+	return utilMax(2,
+		qrPowerChain_deep(n, f_deep),
+		O_OF_W(n) + qrPower_deep(n, n, f_deep));
+}
+
+/*
+*******************************************************************************
+Выбор редакций
+
+Функции колец, которые обращаются к функциям zz с двумя редакциями 
+(zzAddMod(), zzRedCrand(), zzRedMont() и др.), также представлены в двух 
+редакциях. При создании кольца устанавливаются редакции по умолчанию 
+(определяются директивой SAFE_FAST). Функция zmSetSafe() переустанавливает
+указатели на функции. Развернутые ядра zmMulCrandN / zmSqrCrandN, 
+zmMulMont8 / zmSqrMont8 регулярны и не меняются.
+*******************************************************************************
+*/
+
+#define _ZM_SELECT(f, tag)\
+	if (r->f == SAFE(tag) || r->f == FAST(tag))\
+		r->f = safe ? SAFE(tag) : FAST(tag)
+
+void zmSetSafe(qr_o* r, bool_t safe)
+{
+	ASSERT(zmIsOperable(r));
+	_ZM_SELECT(add, zmAdd2);
+	_ZM_SELECT(sub, zmSub2);
+	_ZM_SELECT(neg, zmNeg2);
+	_ZM_SELECT(mul, zmMulCrand);
+	_ZM_SELECT(sqr, zmSqrCrand);
+	_ZM_SELECT(mul, zmMulBarr);
+	_ZM_SELECT(sqr, zmSqrBarr);
+	_ZM_SELECT(mul, zmMulMont);
+	_ZM_SELECT(sqr, zmSqrMont);
+	_ZM_SELECT(mul, zmMulMont2);
+	_ZM_SELECT(sqr, zmSqrMont2);
+	r->safe = safe;
+}
+
+bool_t zmIsSafe(const qr_o* r)
+{
+	ASSERT(zmIsOperable(r));
+	return r->safe;
+}
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.22
-\version 2016.07.01
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -16,6 +16,97 @@ version 3. See Copyright Notices in bee2/info.h.
 #include "bee2/core/word.h"
 #include "bee2/math/ww.h"
 #include "bee2/math/zz.h"
+#include "zz_lcl.h"
+
+/*
+*******************************************************************************
+Сложение / вычитание: малые размерности
+
+Для n = 2, 3,..., ZZ_FIXED_MAX используются полностью развернутые 
+варианты. Шаги снабжаются условиями (i < N), где N -- 
+константа, и лишние шаги исключаются компилятором.
+
+Переносы и заемы обрабатываются с помощью двойного слова, без ветвлений. 
+Поэтому варианты регулярны и используются как в режиме SAFE, так и 
+в режиме FAST. В режиме FAST это устраняет ошибки предсказания 
+ветвлений на случайных данных.
+*******************************************************************************
+*/
+
+#if (ZZ_FIXED_MAX != 8)
+	#error "_ZZ_ADD_FIXED/_ZZ_SUB_FIXED cover steps 0..7 only"
+#endif
+
+#define _ZZ_ADD_STEP(i, N)\
+	if ((i) < (N))\
+		acc += (dword)a[i] + b[i], c[i] = (word)acc, acc >>= B_PER_W
+
+#define _ZZ_SUB_STEP(i, N)\
+	if ((i) < (N))\
+		acc = (dword)a[i] - b[i] - (word)acc, c[i] = (word)acc,\
+		acc = (word)0 - (word)(acc >> B_PER_W)
+
+#define _ZZ_ADD_FIXED(N)\
+static word zzAddFixed##N(word c[], const word a[], const word b[])\
+{\
+	register dword acc = 0;\
+	register word carry;\
+	_ZZ_ADD_STEP(0, N);\
+	_ZZ_ADD_STEP(1, N);\
+	_ZZ_ADD_STEP(2, N);\
+	_ZZ_ADD_STEP(3, N);\
+	_ZZ_ADD_STEP(4, N);\
+	_ZZ_ADD_STEP(5, N);\
+	_ZZ_ADD_STEP(6, N);\
+	_ZZ_ADD_STEP(7, N);\
+	carry = (word)acc, acc = 0;\
+	return carry;\
+}
+
+#define _ZZ_SUB_FIXED(N)\
+static word zzSubFixed##N(word c[], const word a[], const word b[])\
+{\
+	register dword acc = 0;\
+	register word borrow;\
+	_ZZ_SUB_STEP(0, N);\
+	_ZZ_SUB_STEP(1, N);\
+	_ZZ_SUB_STEP(2, N);\
+	_ZZ_SUB_STEP(3, N);\
+	_ZZ_SUB_STEP(4, N);\
+	_ZZ_SUB_STEP(5, N);\
+	_ZZ_SUB_STEP(6, N);\
+	_ZZ_SUB_STEP(7, N);\
+	borrow = (word)acc, acc = 0;\
+	return borrow;\
+}
+
+_ZZ_ADD_FIXED(2)
+_ZZ_ADD_FIXED(3)
+_ZZ_ADD_FIXED(4)
+_ZZ_ADD_FIXED(5)
+_ZZ_ADD_FIXED(6)
+_ZZ_ADD_FIXED(7)
+_ZZ_ADD_FIXED(8)
+
+_ZZ_SUB_FIXED(2)
+_ZZ_SUB_FIXED(3)
+_ZZ_SUB_FIXED(4)
+_ZZ_SUB_FIXED(5)
+_ZZ_SUB_FIXED(6)
+_ZZ_SUB_FIXED(7)
+_ZZ_SUB_FIXED(8)
+
+typedef word (*zz_add_fixed_i)(word c[], const word a[], const word b[]);
+
+static const zz_add_fixed_i zz_add_fixed[ZZ_FIXED_MAX + 1] = {
+	0, 0, zzAddFixed2, zzAddFixed3, zzAddFixed4, zzAddFixed5, zzAddFixed6,
+	zzAddFixed7, zzAddFixed8,
+};
+
+static const zz_add_fixed_i zz_sub_fixed[ZZ_FIXED_MAX + 1] = {
+	0, 0, zzSubFixed2, zzSubFixed3, zzSubFixed4, zzSubFixed5, zzSubFixed6,
+	zzSubFixed7, zzSubFixed8,
+};
 
 /*
 *******************************************************************************
@@ -47,6 +138,8 @@ word zzAdd(word c[], const word a[], const word b[], size_t n)
 	size_t i;
 	ASSERT(wwIsSameOrDisjoint(a, c, n));
 	ASSERT(wwIsSameOrDisjoint(b, c, n));
+	if (2 <= n && n <= ZZ_FIXED_MAX)
+		return zz_add_fixed[n](c, a, b);
 	for (i = 0; i < n; ++i)
 	{
 #ifndef SAFE_FAST
@@ -72,6 +165,8 @@ word zzAdd2(word b[], const word a[], size_t n)
 	register word w;
 	size_t i;
 	ASSERT(wwIsSameOrDisjoint(a, b, n));
+	if (2 <= n && n <= ZZ_FIXED_MAX)
+		return zz_add_fixed[n](b, b, a);
 	for (i = 0; i < n; ++i)
 	{
 #ifndef SAFE_FAST
@@ -217,6 +312,8 @@ word zzSub(word c[], const word a[], const word b[], size_t n)
 	size_t i;
 	ASSERT(wwIsSameOrDisjoint(a, c, n));
 	ASSERT(wwIsSameOrDisjoint(b, c, n));
+	if (2 <= n && n <= ZZ_FIXED_MAX)
+		return zz_sub_fixed[n](c, a, b);
 	for (i = 0; i < n; ++i)
 	{
 #ifndef SAFE_FAST
@@ -242,6 +339,8 @@ word zzSub2(word b[], const word a[], size_t n)
 	register word w;
 	size_t i;
 	ASSERT(wwIsSameOrDisjoint(a, b, n));
+	if (2 <= n && n <= ZZ_FIXED_MAX)
+		return zz_sub_fixed[n](b, b, a);
 	for (i = 0; i < n; ++i)
 	{
 #ifndef SAFE_FAST
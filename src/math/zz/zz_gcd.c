@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.22
-\version 2016.07.05
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -13,8 +13,10 @@ version 3. See Copyright Notices in bee2/info.h.
 
 #include "bee2/core/mem.h"
 #include "bee2/core/util.h"
+#include "bee2/core/word.h"
 #include "bee2/math/ww.h"
 #include "bee2/math/zz.h"
+#include "zz_lcl.h"
 
 /*
 *******************************************************************************
@@ -352,116 +354,194 @@ size_t zzExGCD_deep(size_t n, size_t m)
 *******************************************************************************
 Деление по модулю
 
-В zzDivMod() реализован упрощенный вариант zzExGCD(): рассчитываются
-только da0, da, причем da0 = divident (а не 1).
+В zzDivMod() реализован алгоритм safegcd [D. Bernstein, B.-Y. Yang. Fast 
+constant-time gcd computation and modular inversion. IACR TCHES, 2019(3), 
+340--398] в редакции libsecp256k1 (модуль modinv64).
 
-\todo Реализовать в zzDivMod() случай произвольного (а не только 
-нечетного) mod.
+Основной элемент алгоритма -- шаг divstep:
+	divstep(delta, f, g) =
+		(1 - delta, g, (g - f) / 2), если delta > 0 и g -- нечетное,
+		(1 + delta, f, (g + (g mod 2) f) / 2) в противном случае.
+Начиная с delta = 1, f = mod, g = a, после L шагов, где
+	L = floor((49 l + 80) / 17), l < 46,
+	L = floor((49 l + 57) / 17), l >= 46,
+l = wwBitSize(mod), будет получено g = 0, f = \pm \gcd(a, mod).
+
+Шаги выполняются пакетами по S = B_PER_W - 2 шагов. Каждый пакет 
+выполняется над младшими словами f и g и дает матрицу перехода
+	T = [u v; q r], |u| + |v|, |q| + |r| <= 2^S,
+такую, что (f, g) <- T (f, g) / 2^S. Матрица применяется к длинным f, g 
+и к коэффициентам d, e, для которых поддерживаются инварианты
+	d a \equiv f divident \mod mod, e a \equiv g divident \mod mod.
+Деление d, e на 2^S выполняется после добавления к ним кратных mod, 
+которые обнуляют младшие S битов. Кратные выбираются так, что d, e остаются
+в интервале (-2 mod, mod). После последнего пакета f = \pm 1 и 
+	divident / a \equiv \pm d \mod mod.
+
+Числа f, g, d, e хранятся в дополнительном коде в (n + 2) машинных словах.
+Умножение на знаковое слово w (|w| <= 2^S) выполняется по формуле
+	w x = (word)w x - (w < 0) x B.
+
+Число пакетов зависит только от битовой длины mod. Ветвления 
+и обращения к памяти не зависят от a и divident, т.е. функция регулярна.
 *******************************************************************************
 */
 
+#define ZZ_DIVSTEPS (B_PER_W - 2)
+
+static word zzSignW(const word a[], size_t n)
+{
+	return WORD_0 - (a[n - 1] >> (B_PER_W - 1));
+}
+
+static void zzAddMulSW(word c[], const word a[], size_t n, register word w)
+{
+	zzAddMulW(c, a, n, w);
+	zzSubAndW(c + 1, a, n - 1, WORD_0 - (w >> (B_PER_W - 1)));
+	w = 0;
+}
+
+static void zzShSLo(word a[], size_t n, size_t shift)
+{
+	register word sign = zzSignW(a, n);
+	ASSERT(0 < shift && shift < B_PER_W);
+	wwShLo(a, n, shift);
+	a[n - 1] |= sign << (B_PER_W - shift);
+	sign = 0;
+}
+
+static word zzDivSteps(word t[4], register word delta, register word f, 
+	register word g)
+{
+	register word u = 1, v = 0, q = 0, r = 1;
+	register word c1, c2, x;
+	size_t i;
+	for (i = 0; i < ZZ_DIVSTEPS; ++i)
+	{
+		// c1 <- (delta > 0) ? WORD_MAX : 0, c2 <- g mod 2 ? WORD_MAX : 0
+		c1 = WORD_0 - ((WORD_0 - delta) >> (B_PER_W - 1));
+		c2 = WORD_0 - (g & 1);
+		// (g, q, r) <- (g, q, r) \pm c2 (f, u, v)
+		x = (f ^ c1) - c1, g += x & c2;
+		x = (u ^ c1) - c1, q += x & c2;
+		x = (v ^ c1) - c1, r += x & c2;
+		// c1 && c2? (f, u, v) <- (f, u, v) + (g, q, r), delta <- -delta 
+		c1 &= c2;
+		delta = (delta ^ c1) - c1 + 1;
+		f += g & c1, u += q & c1, v += r & c1;
+		// g <- g / 2, (u, v) <- 2 (u, v)
+		g >>= 1, u <<= 1, v <<= 1;
+	}
+	t[0] = u, t[1] = v, t[2] = q, t[3] = r;
+	u = v = q = r = c1 = c2 = x = f = g = 0;
+	return delta;
+}
+
 void zzDivMod(word b[], const word divident[], const word a[],
 	const word mod[], size_t n, void* stack)
 {
-	register size_t nu, nv;
-	register int sign0 = 0, sign = 1;
+	const size_t m = n + 2;
+	size_t l, steps;
+	register word delta = 1;
+	register word minv;
+	register word sd, se, md, me;
+	word t[4];
 	// переменные в stack
-	word* u = (word*)stack;
-	word* v = u + n;
-	word* da0 = v + n;
-	word* da = da0 + n;
-	stack = da + n;
+	word* f = (word*)stack;
+	word* g = f + m;
+	word* d = g + m;
+	word* e = d + m;
+	word* tf = e + m;
+	word* tg = tf + m;
+	word* mm = tg + m;
+	stack = mm + m;
 	// pre
 	ASSERT(wwCmp(a, mod, n) < 0);
 	ASSERT(wwCmp(divident, mod, n) < 0);
 	ASSERT(wwIsDisjoint(b, mod, n));
 	ASSERT(zzIsOdd(mod, n) && mod[n - 1] != 0);
-	// da0 <- divident, da <- 0
-	wwCopy(da0, divident, n);
-	wwSetZero(da, n);
-	// u <- a, v <- mod
-	wwCopy(u, a, n);
-	wwCopy(v, mod, n);
-	nu = wwWordSize(u, n);
-	nv = n;
-	// итерации со следующими инвариантами:
-	//	da0 * a \equiv (-1)^sign0 * divident * u \mod mod
-	//	da * a \equiv (-1)^sign * divident * v \mod mod
-	while (!wwIsZero(u, nu))
+	// f <- mod, g <- a, d <- 0, e <- divident
+	wwCopy(mm, mod, n), mm[n] = mm[n + 1] = 0;
+	wwCopy(f, mm, m);
+	wwCopy(g, a, n), g[n] = g[n + 1] = 0;
+	wwSetZero(d, m);
+	wwCopy(e, divident, n), e[n] = e[n + 1] = 0;
+	// minv <- mod^{-1} \mod B
+	minv = WORD_0 - wordNegInv(mod[0]);
+	// число шагов
+	l = wwBitSize(mod, n);
+	steps = l < 46 ? (49 * l + 80) / 17 : (49 * l + 57) / 17;
+	// пакеты шагов
+	for (; steps; steps -= MIN2(steps, ZZ_DIVSTEPS))
 	{
-		// пока u -- четное
-		for (; u[0] % 2 == 0; wwShLo(u, nu, 1))
-			if (da0[0] % 2 == 0)
-				// da0 <- da0 / 2
-				wwShLo(da0, n, 1);
-			else
-				// da0 <- (da0 + mod) / 2
-				wwShLoCarry(da0, n, 1, zzAdd2(da0, mod, n));
-		// пока v -- четное
-		for (; v[0] % 2 == 0; wwShLo(v, nv, 1))
-			if (da[0] % 2 == 0)
-				// da <- da / 2
-				wwShLo(da, n, 1);
-			else
-				// da <- (da + mod) / 2
-				wwShLoCarry(da, n, 1, zzAdd2(da, mod, n));
-		// нормализация
-		nu = wwWordSize(u, nu);
-		nv = wwWordSize(v, nv);
-		// u >= v?
-		if (wwCmp2(u, nu, v, nv) >= 0)
-		{
-			// u <- u - v
-			zzSubW2(u + nv, nu - nv, zzSub2(u, v, nv));
-			if (sign0 != sign)
-			{
-				if (zzAdd2(da0, da, n) || wwCmp(da0, mod, n) >= 0)
-					zzSub2(da0, mod, n);
-			}
-			else if (wwCmp(da0, da, n) >= 0)
-				zzSub2(da0, da, n);
-			else
-				zzSub(da0, da, da0, n),
-				sign0 = 1 - sign0;
-		}
-		else
-		{
-			// v <- v - u
-			zzSubW2(v + nu, nv - nu, zzSub2(v, u, nu));
-			if (sign0 != sign)
-			{
-				if (zzAdd2(da, da0, n) || wwCmp(da, mod, n) >= 0)
-					zzSub2(da, mod, n);
-			}
-			else if (wwCmp(da, da0, n) >= 0)
-				zzSub2(da, da0, n);
-			else
-				zzSub(da, da0, da, n),
-				sign = 1 - sign;
-		}
+		// t <- матрица перехода
+		delta = zzDivSteps(t, delta, f[0], g[0]);
+		// (f, g) <- t (f, g) / 2^S
+		wwSetZero(tf, m);
+		zzAddMulSW(tf, f, m, t[0]);
+		zzAddMulSW(tf, g, m, t[1]);
+		wwSetZero(tg, m);
+		zzAddMulSW(tg, f, m, t[2]);
+		zzAddMulSW(tg, g, m, t[3]);
+		ASSERT(tf[0] % (WORD_1 << ZZ_DIVSTEPS) == 0);
+		ASSERT(tg[0] % (WORD_1 << ZZ_DIVSTEPS) == 0);
+		zzShSLo(tf, m, ZZ_DIVSTEPS);
+		zzShSLo(tg, m, ZZ_DIVSTEPS);
+		wwCopy(f, tf, m);
+		wwCopy(g, tg, m);
+		// (md, me) <- кратные mod, которые обнуляют младшие S битов
+		sd = zzSignW(d, m), se = zzSignW(e, m);
+		md = (t[0] & sd) + (t[1] & se);
+		me = (t[2] & sd) + (t[3] & se);
+		md -= (minv * (t[0] * d[0] + t[1] * e[0]) + md) &
+			((WORD_1 << ZZ_DIVSTEPS) - 1);
+		me -= (minv * (t[2] * d[0] + t[3] * e[0]) + me) &
+			((WORD_1 << ZZ_DIVSTEPS) - 1);
+		// (d, e) <- (t (d, e) + mod (md, me)) / 2^S
+		wwSetZero(tf, m);
+		zzAddMulSW(tf, d, m, t[0]);
+		zzAddMulSW(tf, e, m, t[1]);
+		zzAddMulSW(tf, mm, m, md);
+		wwSetZero(tg, m);
+		zzAddMulSW(tg, d, m, t[2]);
+		zzAddMulSW(tg, e, m, t[3]);
+		zzAddMulSW(tg, mm, m, me);
+		ASSERT(tf[0] % (WORD_1 << ZZ_DIVSTEPS) == 0);
+		ASSERT(tg[0] % (WORD_1 << ZZ_DIVSTEPS) == 0);
+		zzShSLo(tf, m, ZZ_DIVSTEPS);
+		zzShSLo(tg, m, ZZ_DIVSTEPS);
+		wwCopy(d, tf, m);
+		wwCopy(e, tg, m);
 	}
-	// здесь v == (a, mod)
-	EXPECT(wwIsW(v, nv, 1));
+	// здесь g == 0, f == \pm \gcd(a, mod)
+	ASSERT(wwIsZero(g, m));
+	// d <- d + mod (d < 0)
+	zzAddAndW(d, mm, m, zzSignW(d, m));
+	// (f, d) <- -(f, d) (f < 0)
+	sd = zzSignW(f, m);
+	for (l = 0; l < m; ++l)
+		f[l] ^= sd, d[l] ^= sd;
+	zzAddW2(f, m, sd & 1);
+	zzAddW2(d, m, sd & 1);
+	// d <- d + mod (d < 0)
+	zzAddAndW(d, mm, m, zzSignW(d, m));
+	ASSERT(wwCmp2(d, m, mod, n) < 0);
 	// \gcd(a, mod) != 1? b <- 0
-	if (!wwIsW(v, nv, 1))
+	EXPECT(wwIsW(f, m, 1));
+	if (!wwIsW(f, m, 1))
 		wwSetZero(b, n);
-	// здесь da * a \equiv (-1)^sign * divident \mod mod
-	// если sign == 1, то b <- mod - da, иначе b <- da
-	else if (sign == 1)
-		zzSub(b, mod, da, n);
 	else
-		wwCopy(b, da, n);
+		wwCopy(b, d, n);
 	// очистка
-	sign0 = sign = 0;
-	nu = nv = 0;
+	delta = minv = sd = se = md = me = 0;
+	t[0] = t[1] = t[2] = t[3] = 0;
 }
 
 size_t zzDivMod_deep(size_t n)
 {
-	return O_OF_W(4 * n);
+	return O_OF_W(7 * (n + 2));
 }
 
-
 /*
 *******************************************************************************
 Почти обращение по модулю
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2016.07.01
-\version 2019.06.27
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -64,6 +64,18 @@ comparison of promoted ~unsigned with unsigned [-Werror=sign-compare].
 void zzAddAndW(word b[], const word a[], size_t n, register word w);
 word zzSubAndW(word b[], const word a[], size_t n, register word w);
 
+/*
+*******************************************************************************
+Малые размерности
+
+Для длин n = 2, 3,..., ZZ_FIXED_MAX (в машинных словах) функции сложения, 
+вычитания, умножения и возведения в квадрат используют развернутые 
+варианты (см. zz_add.c, zz_mul.c).
+*******************************************************************************
+*/
+
+#define ZZ_FIXED_MAX 8
+
 /*
 *******************************************************************************
 Макросы умножения слов
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.22
-\version 2019.06.26
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -20,19 +20,171 @@ version 3. See Copyright Notices in bee2/info.h.
 
 /*
 *******************************************************************************
-Умножение / возведение в квадрат
+Умножение на машинное слово
+
+На платформах x86-64 с расширениями BMI2 и ADX (Intel Broadwell+, 
+AMD Zen+) используются ассемблерные ядра на основе команд mulx, adcx, adox. 
+Команда mulx не изменяет флаги, команды adcx и adox распространяют переносы 
+через различные флаги (CF и OF). Поэтому в zzAddMulW() сложение младших слов 
+произведений с b[i] и сложение со старшими словами предыдущих произведений 
+выполняются по двум независимым цепочкам переносов. В zzSubMulW() сложение 
+произведений выполняется по цепочке OF, а вычитание -- по цепочке CF 
+с помощью тождества b - p - borrow = b + ~p + (1 - borrow) (команда sbb 
+не подходит, поскольку изменяет OF).
+
+Ядра обрабатывают сначала n % 4 слов по одному, затем остальные слова 
+блоками по 4. Счетчики отрицательны и увеличиваются командой lea, выход 
+из цикла -- по команде jrcxz: эти команды не изменяют флаги.
 
-\todo Возведение в квадрат за один проход (?), сначала с квадратов (?).
-\todo Умножение Карацубы.
+Наличие расширений определяется во время выполнения (cpuid, лист 7, 
+EBX: бит 8 -- BMI2, бит 19 -- ADX), результат кэшируется. Кэш читается 
+и записывается атомарно: арифметика может одновременно выполняться 
+в нескольких потоках. Ядра регулярны: время их работы зависит только от n.
+
+\remark Для компиляторов без ассемблерных вставок в синтаксисе GCC 
+(в частности, MSVC) используются переносимые реализации.
 *******************************************************************************
 */
 
+#if defined(__GNUC__) && defined(__x86_64__) && (B_PER_W == 64)
+
+#include <cpuid.h>
+
+#define ZZ_MULX
+
+static bool_t zzHasMulx()
+{
+	static int cache = -1;
+	int has = __atomic_load_n(&cache, __ATOMIC_RELAXED);
+	if (has < 0)
+	{
+		unsigned info[4];
+		has = __get_cpuid_count(7, 0, info, info + 1, info + 2, info + 3) &&
+			(info[1] & 0x00080100) == 0x00080100;
+		__atomic_store_n(&cache, has, __ATOMIC_RELAXED);
+	}
+	return has != 0;
+}
+
+#define _ZZ_MULX_LOOP(body1, body4)\
+	"mov %[r], %%rcx\n\t"\
+	"jrcxz 2f\n"\
+	"1:\n\t"\
+	body1\
+	"lea 8(%[a]), %[a]\n\t"\
+	"lea 8(%[b]), %[b]\n\t"\
+	"lea 1(%%rcx), %%rcx\n\t"\
+	"jrcxz 2f\n\t"\
+	"jmp 1b\n"\
+	"2:\n\t"\
+	"mov %[q], %%rcx\n\t"\
+	"jrcxz 4f\n"\
+	"3:\n\t"\
+	body4\
+	"lea 32(%[a]), %[a]\n\t"\
+	"lea 32(%[b]), %[b]\n\t"\
+	"lea 1(%%rcx), %%rcx\n\t"\
+	"jrcxz 4f\n\t"\
+	"jmp 3b\n"\
+	"4:\n\t"
+
+#define _ZZ_MULW_STEP(o, lo, hi)\
+	"mulx " #o "(%[a]), %%r9, %%" #hi "\n\t"\
+	"adcx %%" #lo ", %%r9\n\t"\
+	"mov %%r9, " #o "(%[b])\n\t"
+
+#define _ZZ_ADDMULW_STEP(o, lo, hi)\
+	"mulx " #o "(%[a]), %%r9, %%" #hi "\n\t"\
+	"adox " #o "(%[b]), %%r9\n\t"\
+	"adcx %%" #lo ", %%r9\n\t"\
+	"mov %%r9, " #o "(%[b])\n\t"
+
+#define _ZZ_SUBMULW_STEP(o, lo, hi)\
+	"mulx " #o "(%[a]), %%r9, %%" #hi "\n\t"\
+	"adox %%" #lo ", %%r9\n\t"\
+	"not %%r9\n\t"\
+	"adcx " #o "(%[b]), %%r9\n\t"\
+	"mov %%r9, " #o "(%[b])\n\t"
+
+static word zzMulWMulx(word b[], const word a[], size_t n, word w)
+{
+	word carry;
+	__asm__ volatile(
+		"xor %%r8d, %%r8d\n\t"
+		_ZZ_MULX_LOOP(
+			_ZZ_MULW_STEP(0, r8, r10)
+			"mov %%r10, %%r8\n\t",
+			_ZZ_MULW_STEP(0, r8, r10)
+			_ZZ_MULW_STEP(8, r10, r8)
+			_ZZ_MULW_STEP(16, r8, r10)
+			_ZZ_MULW_STEP(24, r10, r8))
+		"mov $0, %%r9d\n\t"
+		"adcx %%r9, %%r8\n\t"
+		"mov %%r8, %[c]\n\t"
+		: [c] "=r" (carry), [a] "+r" (a), [b] "+r" (b)
+		: [r] "r" ((size_t)0 - n % 4), [q] "r" ((size_t)0 - n / 4), "d" (w)
+		: "rcx", "r8", "r9", "r10", "cc", "memory");
+	return carry;
+}
+
+static word zzAddMulWMulx(word b[], const word a[], size_t n, word w)
+{
+	word carry;
+	__asm__ volatile(
+		"xor %%r8d, %%r8d\n\t"
+		_ZZ_MULX_LOOP(
+			_ZZ_ADDMULW_STEP(0, r8, r10)
+			"mov %%r10, %%r8\n\t",
+			_ZZ_ADDMULW_STEP(0, r8, r10)
+			_ZZ_ADDMULW_STEP(8, r10, r8)
+			_ZZ_ADDMULW_STEP(16, r8, r10)
+			_ZZ_ADDMULW_STEP(24, r10, r8))
+		"mov $0, %%r9d\n\t"
+		"adox %%r9, %%r8\n\t"
+		"adcx %%r9, %%r8\n\t"
+		"mov %%r8, %[c]\n\t"
+		: [c] "=r" (carry), [a] "+r" (a), [b] "+r" (b)
+		: [r] "r" ((size_t)0 - n % 4), [q] "r" ((size_t)0 - n / 4), "d" (w)
+		: "rcx", "r8", "r9", "r10", "cc", "memory");
+	return carry;
+}
+
+static word zzSubMulWMulx(word b[], const word a[], size_t n, word w)
+{
+	word borrow;
+	__asm__ volatile(
+		"xor %%r8d, %%r8d\n\t"
+		"stc\n\t"
+		_ZZ_MULX_LOOP(
+			_ZZ_SUBMULW_STEP(0, r8, r10)
+			"mov %%r10, %%r8\n\t",
+			_ZZ_SUBMULW_STEP(0, r8, r10)
+			_ZZ_SUBMULW_STEP(8, r10, r8)
+			_ZZ_SUBMULW_STEP(16, r8, r10)
+			_ZZ_SUBMULW_STEP(24, r10, r8))
+		"mov $0, %%r9d\n\t"
+		"adox %%r9, %%r8\n\t"
+		"cmc\n\t"
+		"adc %%r9, %%r8\n\t"
+		"mov %%r8, %[c]\n\t"
+		: [c] "=r" (borrow), [a] "+r" (a), [b] "+r" (b)
+		: [r] "r" ((size_t)0 - n % 4), [q] "r" ((size_t)0 - n / 4), "d" (w)
+		: "rcx", "r8", "r9", "r10", "cc", "memory");
+	return borrow;
+}
+
+#endif /* ZZ_MULX */
+
 word zzMulW(word b[], const word a[], size_t n, register word w)
 {
 	register word carry = 0;
 	register dword prod;
 	size_t i;
 	ASSERT(wwIsSameOrDisjoint(a, b, n));
+#ifdef ZZ_MULX
+	if (zzHasMulx())
+		return zzMulWMulx(b, a, n, w);
+#endif
 	for (i = 0; i < n; ++i)
 	{
 		_MUL(prod, w, a[i]);
@@ -50,6 +202,10 @@ word zzAddMulW(word b[], const word a[], size_t n, register word w)
 	register dword prod;
 	size_t i;
 	ASSERT(wwIsSameOrDisjoint(a, b, n));
+#ifdef ZZ_MULX
+	if (zzHasMulx())
+		return zzAddMulWMulx(b, a, n, w);
+#endif
 	for (i = 0; i < n; ++i)
 	{
 		_MUL(prod, w, a[i]);
@@ -68,6 +224,10 @@ word zzSubMulW(word b[], const word a[], size_t n, register word w)
 	register dword prod;
 	size_t i;
 	ASSERT(wwIsSameOrDisjoint(a, b, n));
+#ifdef ZZ_MULX
+	if (zzHasMulx())
+		return zzSubMulWMulx(b, a, n, w);
+#endif
 	for (i = 0; i < n; ++i)
 	{
 		_MUL(prod, w, a[i]);
@@ -81,84 +241,447 @@ word zzSubMulW(word b[], const word a[], size_t n, register word w)
 	return borrow;
 }
 
-void zzMul(word c[], const word a[], size_t n, const word b[], size_t m, 
-	void* stack)
+/*
+*******************************************************************************
+Умножение / возведение в квадрат
+
+Базовый алгоритм -- умножение по столбцам (метод Комбы): в столбце k 
+накапливается сумма a[i] b[k - i] в трехсловном аккумуляторе (acc, hi), 
+младшее слово аккумулятора сохраняется в c[k], аккумулятор сдвигается 
+на слово. При возведении в квадрат произведения a[i] a[j], i < j, 
+рассчитываются один раз и добавляются дважды. В отличие от умножения 
+по строкам, промежуточные значения c[i + j] не перечитываются из памяти.
+
+Для n == m >= ZZ_KARA_THRESHOLD используется умножение Карацубы:
+	(a1 B^h + a0)(b1 B^h + b0) =
+		a1 b1 B^{2h} + [(a1 + a0)(b1 + b0) - a1 b1 - a0 b0] B^h + a0 b0,
+где h = n / 2, a0 = a[0..h-1], a1 = a[h..n-1], b0 = b[0..h-1], 
+b1 = b[h..n-1]. 
+
+Схема вычислений (k = n - h):
+	c[0..2h-1]  <- a0 b0
+	c[2h..2n-1] <- a1 b1
+	t0          <- a0 + a1 (k + 1 слово)
+	t1          <- b0 + b1 (k + 1 слово)
+	t2          <- t0 t1 - a0 b0 - a1 b1 (2k + 2 слова)
+	c[h..2n-1]  <- c[h..2n-1] + t2
+Подчиненные умножения выполняются рекурсивно (с помощью zzMul()). 
+Возведение в квадрат организуется аналогично.
+
+Глубина стека (в машинных словах) при n >= ZZ_KARA_THRESHOLD:
+	deep(Kara_n) = 4k + 4 + deep(Kara_{k+1}),
+а при n < ZZ_KARA_THRESHOLD -- нулевая. Глубина не убывает с ростом n. 
+Поэтому zzMul_deep(n, m) = deep(Kara_{min(n, m)}) покрывает умножения 
+с любыми длинами n' <= n, m' <= m.
+
+Порог ZZ_KARA_THRESHOLD подобран экспериментально (x86-64, gcc -O2).
+*******************************************************************************
+*/
+
+#define ZZ_KARA_THRESHOLD 64
+
+#define _ZZ_MAC(x, y)\
+	_MUL(prod, x, y), acc += prod, hi += (word)(acc < prod)
+
+#define _ZZ_COL(z)\
+	(z) = (word)acc, acc >>= B_PER_W, acc |= (dword)hi << B_PER_W, hi = 0
+
+static void zzMulComba(word c[], const word a[], size_t n, const word b[], 
+	size_t m)
 {
-	register word carry = 0;
+	register dword acc = 0;
 	register dword prod;
-	size_t i, j;
+	register word hi = 0;
+	size_t i, k;
 	ASSERT(wwIsDisjoint2(a, n, c, n + m));
 	ASSERT(wwIsDisjoint2(b, m, c, n + m));
-	wwSetZero(c, n + m);
-	for (i = 0; i < n; ++i)
+	if (n == 0 || m == 0)
 	{
-		for (j = 0; j < m; ++j)
-		{
-			_MUL(prod, a[i], b[j]);
-			prod += carry;
-			prod += c[i + j];
-			c[i + j] = (word)prod;
-			carry = (word)(prod >> B_PER_W);
-		}
-		c[i + j] = carry;
-		carry = 0;
+		wwSetZero(c, n + m);
+		return;
 	}
-	prod = 0;
-}
-
-size_t zzMul_deep(size_t n, size_t m)
-{
-	return 0;
+	for (k = 0; k + 1 < n + m; ++k)
+	{
+		i = k < m ? 0 : k - m + 1;
+		for (; i < n && i <= k; ++i)
+			_ZZ_MAC(a[i], b[k - i]);
+		_ZZ_COL(c[k]);
+	}
+	c[k] = (word)acc;
+	acc = prod = 0, hi = 0;
 }
 
-void zzSqr(word b[], const word a[], size_t n, void* stack)
+static void zzSqrComba(word b[], const word a[], size_t n)
 {
-	register word carry = 0;
-	register word carry1;
+	register dword acc = 0;
 	register dword prod;
-	size_t i, j;
+	register word hi = 0;
+	size_t i, j, k;
 	ASSERT(wwIsDisjoint2(a, n, b, n + n));
-	// b <- \sum_{i < j} a_i a_j B^{i + j}
-	wwSetZero(b, n + n);
-	for (i = 0; i < n; ++i)
+	if (n == 0)
+		return;
+	for (k = 0; k + 1 < n + n; ++k)
 	{
-		for (j = i + 1; j < n; ++j)
+		i = k < n ? 0 : k - n + 1;
+		for (j = k - i; i < j; ++i, --j)
 		{
 			_MUL(prod, a[i], a[j]);
-			prod += carry;
-			prod += b[i + j];
-			b[i + j] = (word)prod;
-			carry = (word)(prod >> B_PER_W);
+			acc += prod, hi += (word)(acc < prod);
+			acc += prod, hi += (word)(acc < prod);
 		}
-		b[i + j] = carry;
-		carry = 0;
-	}
-	// b <- 2 b
-	for (i = 0; i < n + n; ++i)
-	{
-		carry1 = b[i] >> (B_PER_W - 1);
-		b[i] = (b[i] << 1) | carry;
-		carry = carry1;
+		if (i == j)
+			_ZZ_MAC(a[i], a[i]);
+		_ZZ_COL(b[k]);
 	}
-	// b <- b + \sum_i a_i^2 B^{i + i}
-	for (i = 0; i < n; ++i)
+	b[k] = (word)acc;
+	acc = prod = 0, hi = 0;
+}
+
+static size_t zzKara_deep(size_t n)
+{
+	size_t deep = 0;
+	while (n >= ZZ_KARA_THRESHOLD)
 	{
-		_MUL(prod, a[i], a[i]);
-		prod += carry;
-		prod += b[i + i];
-		b[i + i] = (word)prod;
-		prod >>= B_PER_W;
-		prod += b[i + i + 1];
-		b[i + i + 1] = (word)prod;
-		carry = (word)(prod >> B_PER_W);
+		const size_t k = n - n / 2;
+		deep += O_OF_W(4 * k + 4);
+		n = k + 1;
 	}
-	prod = 0;
-	carry = carry1 = 0;
+	return deep;
+}
+
+static void zzMulKara(word c[], const word a[], const word b[], size_t n,
+	void* stack)
+{
+	const size_t h = n / 2;
+	const size_t k = n - h;
+	word carry;
+	// переменные в stack
+	word* t0 = (word*)stack;
+	word* t1 = t0 + k + 1;
+	word* t2 = t1 + k + 1;
+	stack = t2 + 2 * k + 2;
+	// pre
+	ASSERT(h >= 2);
+	ASSERT(wwIsDisjoint2(a, n, c, 2 * n));
+	ASSERT(wwIsDisjoint2(b, n, c, 2 * n));
+	// c[0..2h-1] <- a0 b0
+	zzMul(c, a, h, b, h, stack);
+	// c[2h..2n-1] <- a1 b1
+	zzMul(c + 2 * h, a + h, k, b + h, k, stack);
+	// t0 <- a0 + a1
+	wwCopy(t0, a + h, k);
+	t0[k] = zzAddW2(t0 + h, k - h, zzAdd2(t0, a, h));
+	// t1 <- b0 + b1
+	wwCopy(t1, b + h, k);
+	t1[k] = zzAddW2(t1 + h, k - h, zzAdd2(t1, b, h));
+	// t2 <- t0 t1 - a0 b0 - a1 b1
+	zzMul(t2, t0, k + 1, t1, k + 1, stack);
+	carry = zzSubW2(t2 + 2 * h, 2 * k + 2 - 2 * h, zzSub2(t2, c, 2 * h));
+	ASSERT(carry == 0);
+	carry = zzSubW2(t2 + 2 * k, 2, zzSub2(t2, c + 2 * h, 2 * k));
+	ASSERT(carry == 0);
+	// c[h..2n-1] <- c[h..2n-1] + t2
+	carry = zzAddW2(c + h + 2 * k + 2, 2 * n - h - 2 * k - 2, 
+		zzAdd2(c + h, t2, 2 * k + 2));
+	ASSERT(carry == 0);
+	carry = 0;
+}
+
+static void zzSqrKara(word b[], const word a[], size_t n, void* stack)
+{
+	const size_t h = n / 2;
+	const size_t k = n - h;
+	word carry;
+	// переменные в stack
+	word* t0 = (word*)stack;
+	word* t2 = t0 + 2 * k + 2;
+	stack = t2 + 2 * k + 2;
+	// pre
+	ASSERT(h >= 2);
+	ASSERT(wwIsDisjoint2(a, n, b, 2 * n));
+	// b[0..2h-1] <- a0^2
+	zzSqr(b, a, h, stack);
+	// b[2h..2n-1] <- a1^2
+	zzSqr(b + 2 * h, a + h, k, stack);
+	// t0 <- a0 + a1
+	wwCopy(t0, a + h, k);
+	t0[k] = zzAddW2(t0 + h, k - h, zzAdd2(t0, a, h));
+	// t2 <- t0^2 - a0^2 - a1^2
+	zzSqr(t2, t0, k + 1, stack);
+	carry = zzSubW2(t2 + 2 * h, 2 * k + 2 - 2 * h, zzSub2(t2, b, 2 * h));
+	ASSERT(carry == 0);
+	carry = zzSubW2(t2 + 2 * k, 2, zzSub2(t2, b + 2 * h, 2 * k));
+	ASSERT(carry == 0);
+	// b[h..2n-1] <- b[h..2n-1] + t2
+	carry = zzAddW2(b + h + 2 * k + 2, 2 * n - h - 2 * k - 2, 
+		zzAdd2(b + h, t2, 2 * k + 2));
+	ASSERT(carry == 0);
+	carry = 0;
+}
+
+/*
+*******************************************************************************
+Умножение / возведение в квадрат: малые размерности
+
+Для n = m = 2, 3,..., ZZ_FIXED_MAX используются полностью развернутые 
+варианты метода Комбы. Варианты строятся по макросам _ZZ_MUL_N(N), 
+_ZZ_SQR_N(N), которые описывают столбцы для максимальной размерности 
+ZZ_FIXED_MAX. Каждое умножение слов и каждая запись столбца снабжены
+условиями вида (i < N), где N -- константа. Компилятор вычисляет эти условия 
+на этапе компиляции и исключает лишние операции. В результате в вариантах
+нет циклов и вычислений индексов.
+
+При ZZ_FIXED_MAX = 8 и 64-битовых словах охватываются, в частности, 
+кривые bign (n = 4, 6, 8) и кривые g12s (n = 4, 8).
+*******************************************************************************
+*/
+
+#define _ZZ_MAC_N(i, j, N)\
+	if ((i) < (N) && (j) < (N)) _ZZ_MAC(a[i], b[j])
+
+#define _ZZ_MAC2_N(i, j, N)\
+	if ((j) < (N)) _ZZ_MAC(a[i], a[j]), acc += prod, hi += (word)(acc < prod)
+
+#define _ZZ_DIAG_N(i, N)\
+	if ((i) < (N)) _ZZ_MAC(a[i], a[i])
+
+#define _ZZ_COL_N(k, N)\
+	if ((k) + 1 < 2 * (N)) _ZZ_COL(c[k])
+
+#define _ZZ_MUL_COL0(N)\
+	_ZZ_MAC_N(0, 0, N);\
+	_ZZ_COL_N(0, N)
+
+#define _ZZ_MUL_COL1(N)\
+	_ZZ_MAC_N(0, 1, N); _ZZ_MAC_N(1, 0, N);\
+	_ZZ_COL_N(1, N)
+
+#define _ZZ_MUL_COL2(N)\
+	_ZZ_MAC_N(0, 2, N); _ZZ_MAC_N(1, 1, N); _ZZ_MAC_N(2, 0, N);\
+	_ZZ_COL_N(2, N)
+
+#define _ZZ_MUL_COL3(N)\
+	_ZZ_MAC_N(0, 3, N); _ZZ_MAC_N(1, 2, N); _ZZ_MAC_N(2, 1, N);\
+	_ZZ_MAC_N(3, 0, N);\
+	_ZZ_COL_N(3, N)
+
+#define _ZZ_MUL_COL4(N)\
+	_ZZ_MAC_N(0, 4, N); _ZZ_MAC_N(1, 3, N); _ZZ_MAC_N(2, 2, N);\
+	_ZZ_MAC_N(3, 1, N); _ZZ_MAC_N(4, 0, N);\
+	_ZZ_COL_N(4, N)
+
+#define _ZZ_MUL_COL5(N)\
+	_ZZ_MAC_N(0, 5, N); _ZZ_MAC_N(1, 4, N); _ZZ_MAC_N(2, 3, N);\
+	_ZZ_MAC_N(3, 2, N); _ZZ_MAC_N(4, 1, N); _ZZ_MAC_N(5, 0, N);\
+	_ZZ_COL_N(5, N)
+
+#define _ZZ_MUL_COL6(N)\
+	_ZZ_MAC_N(0, 6, N); _ZZ_MAC_N(1, 5, N); _ZZ_MAC_N(2, 4, N);\
+	_ZZ_MAC_N(3, 3, N); _ZZ_MAC_N(4, 2, N); _ZZ_MAC_N(5, 1, N);\
+	_ZZ_MAC_N(6, 0, N);\
+	_ZZ_COL_N(6, N)
+
+#define _ZZ_MUL_COL7(N)\
+	_ZZ_MAC_N(0, 7, N); _ZZ_MAC_N(1, 6, N); _ZZ_MAC_N(2, 5, N);\
+	_ZZ_MAC_N(3, 4, N); _ZZ_MAC_N(4, 3, N); _ZZ_MAC_N(5, 2, N);\
+	_ZZ_MAC_N(6, 1, N); _ZZ_MAC_N(7, 0, N);\
+	_ZZ_COL_N(7, N)
+
+#define _ZZ_MUL_COL8(N)\
+	_ZZ_MAC_N(1, 7, N); _ZZ_MAC_N(2, 6, N); _ZZ_MAC_N(3, 5, N);\
+	_ZZ_MAC_N(4, 4, N); _ZZ_MAC_N(5, 3, N); _ZZ_MAC_N(6, 2, N);\
+	_ZZ_MAC_N(7, 1, N);\
+	_ZZ_COL_N(8, N)
+
+#define _ZZ_MUL_COL9(N)\
+	_ZZ_MAC_N(2, 7, N); _ZZ_MAC_N(3, 6, N); _ZZ_MAC_N(4, 5, N);\
+	_ZZ_MAC_N(5, 4, N); _ZZ_MAC_N(6, 3, N); _ZZ_MAC_N(7, 2, N);\
+	_ZZ_COL_N(9, N)
+
+#define _ZZ_MUL_COL10(N)\
+	_ZZ_MAC_N(3, 7, N); _ZZ_MAC_N(4, 6, N); _ZZ_MAC_N(5, 5, N);\
+	_ZZ_MAC_N(6, 4, N); _ZZ_MAC_N(7, 3, N);\
+	_ZZ_COL_N(10, N)
+
+#define _ZZ_MUL_COL11(N)\
+	_ZZ_MAC_N(4, 7, N); _ZZ_MAC_N(5, 6, N); _ZZ_MAC_N(6, 5, N);\
+	_ZZ_MAC_N(7, 4, N);\
+	_ZZ_COL_N(11, N)
+
+#define _ZZ_MUL_COL12(N)\
+	_ZZ_MAC_N(5, 7, N); _ZZ_MAC_N(6, 6, N); _ZZ_MAC_N(7, 5, N);\
+	_ZZ_COL_N(12, N)
+
+#define _ZZ_MUL_COL13(N)\
+	_ZZ_MAC_N(6, 7, N); _ZZ_MAC_N(7, 6, N);\
+	_ZZ_COL_N(13, N)
+
+#define _ZZ_MUL_COL14(N)\
+	_ZZ_MAC_N(7, 7, N);\
+	_ZZ_COL_N(14, N)
+
+#define _ZZ_SQR_COL0(N)\
+	_ZZ_DIAG_N(0, N);\
+	_ZZ_COL_N(0, N)
+
+#define _ZZ_SQR_COL1(N)\
+	_ZZ_MAC2_N(0, 1, N);\
+	_ZZ_COL_N(1, N)
+
+#define _ZZ_SQR_COL2(N)\
+	_ZZ_MAC2_N(0, 2, N); _ZZ_DIAG_N(1, N);\
+	_ZZ_COL_N(2, N)
+
+#define _ZZ_SQR_COL3(N)\
+	_ZZ_MAC2_N(0, 3, N); _ZZ_MAC2_N(1, 2, N);\
+	_ZZ_COL_N(3, N)
+
+#define _ZZ_SQR_COL4(N)\
+	_ZZ_MAC2_N(0, 4, N); _ZZ_MAC2_N(1, 3, N); _ZZ_DIAG_N(2, N);\
+	_ZZ_COL_N(4, N)
+
+#define _ZZ_SQR_COL5(N)\
+	_ZZ_MAC2_N(0, 5, N); _ZZ_MAC2_N(1, 4, N); _ZZ_MAC2_N(2, 3, N);\
+	_ZZ_COL_N(5, N)
+
+#define _ZZ_SQR_COL6(N)\
+	_ZZ_MAC2_N(0, 6, N); _ZZ_MAC2_N(1, 5, N); _ZZ_MAC2_N(2, 4, N);\
+	_ZZ_DIAG_N(3, N);\
+	_ZZ_COL_N(6, N)
+
+#define _ZZ_SQR_COL7(N)\
+	_ZZ_MAC2_N(0, 7, N); _ZZ_MAC2_N(1, 6, N); _ZZ_MAC2_N(2, 5, N);\
+	_ZZ_MAC2_N(3, 4, N);\
+	_ZZ_COL_N(7, N)
+
+#define _ZZ_SQR_COL8(N)\
+	_ZZ_MAC2_N(1, 7, N); _ZZ_MAC2_N(2, 6, N); _ZZ_MAC2_N(3, 5, N);\
+	_ZZ_DIAG_N(4, N);\
+	_ZZ_COL_N(8, N)
+
+#define _ZZ_SQR_COL9(N)\
+	_ZZ_MAC2_N(2, 7, N); _ZZ_MAC2_N(3, 6, N); _ZZ_MAC2_N(4, 5, N);\
+	_ZZ_COL_N(9, N)
+
+#define _ZZ_SQR_COL10(N)\
+	_ZZ_MAC2_N(3, 7, N); _ZZ_MAC2_N(4, 6, N); _ZZ_DIAG_N(5, N);\
+	_ZZ_COL_N(10, N)
+
+#define _ZZ_SQR_COL11(N)\
+	_ZZ_MAC2_N(4, 7, N); _ZZ_MAC2_N(5, 6, N);\
+	_ZZ_COL_N(11, N)
+
+#define _ZZ_SQR_COL12(N)\
+	_ZZ_MAC2_N(5, 7, N); _ZZ_DIAG_N(6, N);\
+	_ZZ_COL_N(12, N)
+
+#define _ZZ_SQR_COL13(N)\
+	_ZZ_MAC2_N(6, 7, N);\
+	_ZZ_COL_N(13, N)
+
+#define _ZZ_SQR_COL14(N)\
+	_ZZ_DIAG_N(7, N);\
+	_ZZ_COL_N(14, N)
+
+#if (ZZ_FIXED_MAX != 8)
+	#error "_ZZ_MUL_N/_ZZ_SQR_N cover columns 0..14 only"
+#endif
+
+#define _ZZ_MUL_N(N)\
+	_ZZ_MUL_COL0(N); _ZZ_MUL_COL1(N); _ZZ_MUL_COL2(N); _ZZ_MUL_COL3(N);\
+	_ZZ_MUL_COL4(N); _ZZ_MUL_COL5(N); _ZZ_MUL_COL6(N); _ZZ_MUL_COL7(N);\
+	_ZZ_MUL_COL8(N); _ZZ_MUL_COL9(N); _ZZ_MUL_COL10(N); _ZZ_MUL_COL11(N);\
+	_ZZ_MUL_COL12(N); _ZZ_MUL_COL13(N); _ZZ_MUL_COL14(N);\
+	c[2 * (N) - 1] = (word)acc
+
+#define _ZZ_SQR_N(N)\
+	_ZZ_SQR_COL0(N); _ZZ_SQR_COL1(N); _ZZ_SQR_COL2(N); _ZZ_SQR_COL3(N);\
+	_ZZ_SQR_COL4(N); _ZZ_SQR_COL5(N); _ZZ_SQR_COL6(N); _ZZ_SQR_COL7(N);\
+	_ZZ_SQR_COL8(N); _ZZ_SQR_COL9(N); _ZZ_SQR_COL10(N); _ZZ_SQR_COL11(N);\
+	_ZZ_SQR_COL12(N); _ZZ_SQR_COL13(N); _ZZ_SQR_COL14(N);\
+	c[2 * (N) - 1] = (word)acc
+
+#define _ZZ_MUL_FIXED(N)\
+static void zzMulComba##N(word c[], const word a[], const word b[])\
+{\
+	register dword acc = 0;\
+	register dword prod;\
+	register word hi = 0;\
+	_ZZ_MUL_N(N);\
+	acc = prod = 0, hi = 0;\
+}
+
+#define _ZZ_SQR_FIXED(N)\
+static void zzSqrComba##N(word c[], const word a[])\
+{\
+	register dword acc = 0;\
+	register dword prod;\
+	register word hi = 0;\
+	_ZZ_SQR_N(N);\
+	acc = prod = 0, hi = 0;\
+}
+
+_ZZ_MUL_FIXED(2)
+_ZZ_MUL_FIXED(3)
+_ZZ_MUL_FIXED(4)
+_ZZ_MUL_FIXED(5)
+_ZZ_MUL_FIXED(6)
+_ZZ_MUL_FIXED(7)
+_ZZ_MUL_FIXED(8)
+
+_ZZ_SQR_FIXED(2)
+_ZZ_SQR_FIXED(3)
+_ZZ_SQR_FIXED(4)
+_ZZ_SQR_FIXED(5)
+_ZZ_SQR_FIXED(6)
+_ZZ_SQR_FIXED(7)
+_ZZ_SQR_FIXED(8)
+
+typedef void (*zz_mul_fixed_i)(word c[], const word a[], const word b[]);
+typedef void (*zz_sqr_fixed_i)(word c[], const word a[]);
+
+static const zz_mul_fixed_i zz_mul_fixed[ZZ_FIXED_MAX + 1] = {
+	0, 0, zzMulComba2, zzMulComba3, zzMulComba4, zzMulComba5, zzMulComba6,
+	zzMulComba7, zzMulComba8,
+};
+
+static const zz_sqr_fixed_i zz_sqr_fixed[ZZ_FIXED_MAX + 1] = {
+	0, 0, zzSqrComba2, zzSqrComba3, zzSqrComba4, zzSqrComba5, zzSqrComba6,
+	zzSqrComba7, zzSqrComba8,
+};
+
+void zzMul(word c[], const word a[], size_t n, const word b[], size_t m, 
+	void* stack)
+{
+	ASSERT(wwIsDisjoint2(a, n, c, n + m));
+	ASSERT(wwIsDisjoint2(b, m, c, n + m));
+	if (n == m && 2 <= n && n <= ZZ_FIXED_MAX)
+		zz_mul_fixed[n](c, a, b);
+	else if (n == m && n >= ZZ_KARA_THRESHOLD)
+		zzMulKara(c, a, b, n, stack);
+	else
+		zzMulComba(c, a, n, b, m);
+}
+
+size_t zzMul_deep(size_t n, size_t m)
+{
+	return zzKara_deep(MIN2(n, m));
+}
+
+void zzSqr(word b[], const word a[], size_t n, void* stack)
+{
+	ASSERT(wwIsDisjoint2(a, n, b, n + n));
+	if (2 <= n && n <= ZZ_FIXED_MAX)
+		zz_sqr_fixed[n](b, a);
+	else if (n >= ZZ_KARA_THRESHOLD)
+		zzSqrKara(b, a, n, stack);
+	else
+		zzSqrComba(b, a, n);
 }
 
 size_t zzSqr_deep(size_t n)
 {
-	return 0;
+	return zzKara_deep(n);
 }
 
 /*
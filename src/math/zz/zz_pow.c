@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.22
-\version 2016.07.01
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -43,24 +43,18 @@ void zzPowerMod(word c[], const word a[], size_t n, const word b[], size_t m,
 	// r <- Zm(mod)
 	wwTo(t, no, mod);
 	zmCreate(r, (octet*)t, no, stack);
-	// t <- a
-	wwTo(t, no, a);
-	qrFrom(t, (octet*)t, r, stack);
-	// t <- a^b
-	qrPower(t, t, b, m, r, stack);
-	// c <- t
-	qrTo((octet*)t, t, r, stack);
-	wwFrom(c, t, no);
+	// c <- a^b
+	zmPowerMod(c, a, b, m, r, stack);
 }
 
 size_t zzPowerMod_deep(size_t n, size_t m)
 {
 	const size_t no = O_OF_W(n);
 	const size_t r_deep = zmCreate_deep(no);
-	return no + 
+	return no + zmCreate_keep(no) + 
 		utilMax(2,
 			r_deep,
-			qrPower_deep(n, m, r_deep));
+			zmPowerMod_deep(n, m, r_deep));
 }
 
 /*
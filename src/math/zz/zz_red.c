@@ -6,7 +6,7 @@
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \author (C) Stanislav Poruchnik [poruchnikstanislav@gmail.com]
 \created 2012.04.22
-\version 2019.06.26
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -231,6 +231,12 @@ DSP56000. Advances in Cryptology -- EUROCRYPT 90, LNCS 473, 230–244. 1990]:
                a <- a / B^n
              if (a >= mod)
                a <- a - mod
+
+Перенос при добавлении t * mod * B^i к a не распространяется по всем 
+старшим словам a, а накапливается в слове carry и учитывается на следующем 
+шаге при добавлении к a[i + n + 1]. Тем самым сложность редукции -- n^2, 
+а не 1.5 n^2 операций со словами. Основная нагрузка приходится на 
+zzAddMulW().
 *******************************************************************************
 */
 
@@ -248,7 +254,9 @@ void FAST(zzRedMont)(word a[], const word mod[], size_t n,
 	for (i = 0; i < n; ++i)
 	{
 		_MUL_LO(w, a[i], mont_param);
-		carry |= zzAddW2(a + i + n, n - i, zzAddMulW(a + i, mod, n, w));
+		w = zzAddMulW(a + i, mod, n, w);
+		a[i + n] += carry, carry = a[i + n] < carry;
+		a[i + n] += w, carry |= a[i + n] < w;
 	}
 	ASSERT(wwIsZero(a, n));
 	// a <- a / B^n
@@ -276,8 +284,11 @@ void SAFE(zzRedMont)(word a[], const word mod[], size_t n,
 	for (i = 0; i < n; ++i)
 	{
 		_MUL_LO(w, a[i], mont_param);
-		carry |= zzAddW2(a + i + n, n - i, zzAddMulW(a + i, mod, n, w));
+		w = zzAddMulW(a + i, mod, n, w);
+		a[i + n] += carry, carry = wordLess01(a[i + n], carry);
+		a[i + n] += w, carry |= wordLess01(a[i + n], w);
 	}
+	w = WORD_1;
 	ASSERT(wwIsZero(a, n));
 	// a <- a / B^n, a >= mod?
 	for (i = 0; i < n; ++i)
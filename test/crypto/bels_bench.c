@@ -0,0 +1,93 @@
+/*
+*******************************************************************************
+\file bels_bench.c
+\brief Benchmarks for STB 34.101.60 (bels)
+\project bee2/test
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.18
+\version 2026.10.18
+\license This program is released under the GNU General Public License 
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+#include <stdio.h>
+#include <bee2/core/mem.h>
+#include <bee2/core/prng.h>
+#include <bee2/core/tm.h>
+#include <bee2/core/util.h>
+#include <bee2/crypto/bels.h>
+
+/*
+*******************************************************************************
+Замер производительности
+
+Сравнивается восстановление секрета функцией belsRecover() и с помощью 
+объекта восстановления (belsRecStep()). Секрет разделяется между 
+count == 8 пользователями с порогом 8. Оценивается также время построения 
+объекта.
+*******************************************************************************
+*/
+
+bool_t belsBench()
+{
+	const size_t count = 8;
+	octet combo_state[256];
+	octet rec[8 * 32 * 32 * 8 + 64];
+	octet m0[32];
+	octet mi[32 * 8];
+	octet s[32];
+	octet si[32 * 8];
+	octet t[32];
+	size_t len, i;
+	// подготовить генератор
+	ASSERT(prngCOMBO_keep() <= sizeof(combo_state));
+	prngCOMBOStart(combo_state, utilNonce32());
+	// цикл по длинам
+	for (len = 16; len <= 32; len += 8)
+	{
+		const size_t reps = 200;
+		tm_ticks_t ticks;
+		// загрузить ключи и разделить секрет
+		belsStdM(m0, len, 0);
+		for (i = 0; i < count; ++i)
+			belsStdM(mi + i * len, len, i + 1);
+		prngCOMBOStepR(s, len, combo_state);
+		if (belsShare(si, count, count, len, s, m0, mi, prngCOMBOStepR,
+			combo_state) != ERR_OK)
+			return FALSE;
+		// belsRecover
+		for (i = 0, ticks = tmTicks(); i < reps; ++i)
+			belsRecover(t, count, len, si, m0, mi);
+		ticks = tmTicks() - ticks;
+		if (!memEq(t, s, len))
+			return FALSE;
+		printf("belsBench::belsRecover%u: %u cycles/secret "
+			"[%u secrets/sec]\n",
+			(unsigned)(len * 8),
+			(unsigned)(ticks / reps),
+			(unsigned)tmSpeed(reps, ticks));
+		// belsRecStart
+		ASSERT(belsRec_keep(count, len) <= sizeof(rec));
+		ticks = tmTicks();
+		if (belsRecStart(rec, count, len, m0, mi) != ERR_OK)
+			return FALSE;
+		ticks = tmTicks() - ticks;
+		printf("belsBench::belsRecStart%u: %u cycles\n",
+			(unsigned)(len * 8),
+			(unsigned)ticks);
+		// belsRecStep
+		for (i = 0, ticks = tmTicks(); i < 10 * reps; ++i)
+			belsRecStep(t, si, rec);
+		ticks = tmTicks() - ticks;
+		if (!memEq(t, s, len))
+			return FALSE;
+		printf("belsBench::belsRecStep%u: %u cycles/secret "
+			"[%u secrets/sec]\n",
+			(unsigned)(len * 8),
+			(unsigned)(ticks / reps / 10),
+			(unsigned)tmSpeed(10 * reps, ticks));
+	}
+	// все нормально
+	return TRUE;
+}
@@ -5,12 +5,13 @@
 \project bee2/test
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2013.06.27
-\version 2018.11.30
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
+#include <bee2/core/err.h>
 #include <bee2/core/mem.h>
 #include <bee2/core/hex.h>
 #include <bee2/core/prng.h>
@@ -36,6 +37,8 @@ bool_t belsTest()
 	octet mi[32 * 5];
 	octet s[32];
 	octet si[32 * 5];
+	octet si2[32 * 5 * 3];
+	octet rec[3 * 32 * 32 * 8 + 64];
 	char id[] = "Alice";
 	octet echo_state[64];
 	octet combo_state[512];
@@ -304,6 +307,59 @@ bool_t belsTest()
 			!memEq(s, beltH(), len))
 			return FALSE;
 	}
+	// проверка belsBatchShare
+	for (len = 16; len <= 32; len += 8)
+	{
+		u32 seed = utilNonce32();
+		// загрузить открытые ключи (последний -- с ненулевым старшим словом)
+		belsStdM(m0, len, 0);
+		belsStdM(mi + 0 * len, len, 1);
+		belsStdM(mi + 1 * len, len, 2);
+		belsStdM(mi + 2 * len, len, 3);
+		belsStdM(mi + 3 * len, len, 4);
+		prngCOMBOStart(combo_state, seed);
+		if (belsGenMi(mi + 4 * len, len, m0, prngCOMBOStepR, 
+			combo_state) != ERR_OK)
+			return FALSE;
+		// недопустимые размерности
+		if (belsBatchShare(si2, 0, 5, 3, len, beltH(), m0, mi, 
+				prngCOMBOStepR, combo_state) != ERR_BAD_INPUT ||
+			belsBatchShare(si2, 2, SIZE_MAX / len, 3, len, beltH(), m0, mi, 
+				prngCOMBOStepR, combo_state) != ERR_BAD_INPUT)
+			return FALSE;
+		// разделить секреты
+		prngCOMBOStart(combo_state, seed);
+		if (belsBatchShare(si2, 3, 5, 3, len, beltH(), m0, mi, 
+			prngCOMBOStepR, combo_state) != ERR_OK)
+			return FALSE;
+		// сравнить с belsShare
+		prngCOMBOStart(combo_state, seed);
+		for (num = 0; num < 3; ++num)
+			if (belsShare(si, 5, 3, len, beltH() + num * len, m0, mi, 
+					prngCOMBOStepR, combo_state) != ERR_OK ||
+				!memEq(si, si2 + num * 5 * len, 5 * len))
+				return FALSE;
+		// восстановить секреты
+		for (num = 0; num < 3; ++num)
+			if (belsRecover(s, 3, len, si2 + num * 5 * len + 2 * len, 
+					m0, mi + 2 * len) != ERR_OK ||
+				!memEq(s, beltH() + num * len, len))
+				return FALSE;
+		// восстановить секреты с помощью объекта
+		ASSERT(sizeof(rec) >= belsRec_keep(3, len));
+		if (belsRecStart(rec, 3, len, m0, mi + 2 * len) != ERR_OK)
+			return FALSE;
+		for (num = 0; num < 3; ++num)
+			if (belsRecStep(s, si2 + num * 5 * len + 2 * len, rec) != ERR_OK ||
+				!memEq(s, beltH() + num * len, len))
+				return FALSE;
+		// объект для двух пользователей: как belsRecover()
+		if (belsRecStart(rec, 2, len, m0, mi) != ERR_OK ||
+			belsRecStep(s, si2, rec) != ERR_OK ||
+			belsRecover(si, 2, len, si2, m0, mi) != ERR_OK ||
+			!memEq(s, si, len))
+			return FALSE;
+	}
 	// все нормально
 	return TRUE;
 }
@@ -5,12 +5,13 @@
 \project bee2/test
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.08.27
-\version 2020.11.25
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
+#include <bee2/core/err.h>
 #include <bee2/core/mem.h>
 #include <bee2/core/hex.h>
 #include <bee2/core/str.h>
@@ -101,8 +102,15 @@ bool_t bignTest()
 	octet hash[64];
 	octet id_hash[64];
 	octet sig[64 + 32];
+	octet sig1[64 + 32];
 	octet id_sig[64 + 32 + 128];
 	octet brng_state[1024];
+	octet brng_state1[1024];
+	octet pool[2048];
+	octet ctx[2048];
+	octet ctx_stack[4096];
+	octet privkeys[257 * 32];
+	octet pubkeys[257 * 64];
 	octet zz_stack[512];
 	octet token[80];
 	word q[W_OF_O(32)];
@@ -116,6 +124,9 @@ bool_t bignTest()
 	octet theta[32];
 	// создать стек
 	ASSERT(sizeof(brng_state) >= brngCTRX_keep());
+	ASSERT(sizeof(pool) >= bignPool_keep(128, 2));
+	ASSERT(sizeof(ctx) >= bignCtx_keep(128));
+	ASSERT(sizeof(ctx_stack) >= bignCtx_deep(128));
 	ASSERT(sizeof(zz_stack) >= zzMulMod_deep(W_OF_O(32)));
 	// проверить таблицы Б.1, Б.2, Б.3
 	if (bignStdParams(params, "1.2.112.0.2.0.34.101.45.3.3") != ERR_OK ||
@@ -190,6 +201,114 @@ bool_t bignTest()
 	if (bignVerify(params, oid_der, oid_len, hash, sig, pubkey) == ERR_OK)
 		return FALSE;
 	pubkey[0] ^= 1;
+	// тест Г.2 с предвычислениями
+	brngCTRXStart(beltH() + 128, beltH() + 128 + 64,
+		beltH(), 8 * 32, brng_state1);
+	if (bignGenKeypair(privkey, pubkey, params, brngCTRXStepR, 
+		brng_state1) != ERR_OK)
+		return FALSE;
+	if (bignPoolStart(pool, params, 2) != ERR_OK)
+		return FALSE;
+	if (bignPoolSign(sig1, pool, oid_der, oid_len, hash, privkey) != 
+		ERR_NOT_READY ||
+		bignPoolFill(pool, 1, brngCTRXStepR, brng_state1) != ERR_OK ||
+		bignPoolSize(pool) != 1 ||
+		bignPoolSign(sig1, pool, oid_der, oid_len, hash, privkey) != ERR_OK ||
+		bignPoolSize(pool) != 0)
+	{
+		bignPoolClose(pool);
+		return FALSE;
+	}
+	if (!hexEq(sig1, 
+		"E36B7F0377AE4C524027C387FADF1B20"
+		"CE72F1530B71F2B5FD3A8C584FE2E1AE"
+		"D20082E30C8AF65011F4FB54649DFD3D"))
+	{
+		bignPoolClose(pool);
+		return FALSE;
+	}
+	if (bignPoolFill(pool, 3, brngCTRXStepR, brng_state1) != ERR_OK ||
+		bignPoolSize(pool) != 2 ||
+		bignPoolSign(sig1, pool, oid_der, oid_len, hash, privkey) != ERR_OK ||
+		bignVerify(params, oid_der, oid_len, hash, sig1, pubkey) != ERR_OK ||
+		bignPoolSign(sig1, pool, oid_der, oid_len, hash, privkey) != ERR_OK ||
+		bignVerify(params, oid_der, oid_len, hash, sig1, pubkey) != ERR_OK ||
+		bignPoolSign(sig1, pool, oid_der, oid_len, hash, privkey) != 
+		ERR_NOT_READY)
+	{
+		bignPoolClose(pool);
+		return FALSE;
+	}
+	bignPoolClose(pool);
+	// тесты Г.1, Г.2 с контекстом
+	brngCTRXStart(beltH() + 128, beltH() + 128 + 64,
+		beltH(), 8 * 32, brng_state1);
+	if (bignCtxStart(ctx, params) != ERR_OK ||
+		bignCtxGenKeypair(id_privkey, id_pubkey, ctx, brngCTRXStepR, 
+			brng_state1, ctx_stack) != ERR_OK ||
+		!memEq(id_privkey, privkey, 32) ||
+		!memEq(id_pubkey, pubkey, 64) ||
+		bignCtxCalcPubkey(id_pubkey, ctx, privkey, ctx_stack) != ERR_OK ||
+		!memEq(id_pubkey, pubkey, 64) ||
+		bignCtxSign(sig1, ctx, oid_der, oid_len, hash, privkey, 
+			brngCTRXStepR, brng_state1, ctx_stack) != ERR_OK ||
+		!memEq(sig1, sig, 48) ||
+		bignCtxVerify(ctx, oid_der, oid_len, hash, sig1, pubkey, 
+			ctx_stack) != ERR_OK)
+		return FALSE;
+	sig1[0] ^= 1;
+	if (bignCtxVerify(ctx, oid_der, oid_len, hash, sig1, pubkey, 
+		ctx_stack) == ERR_OK)
+		return FALSE;
+	// ускоренная проверка, регулярная выработка
+	sig1[0] ^= 1;
+	if (bignCtxSetSafe(ctx, FALSE) != ERR_OK ||
+		bignCtxVerify(ctx, oid_der, oid_len, hash, sig1, pubkey, 
+			ctx_stack) != ERR_OK ||
+		bignCtxSetSafe(ctx, TRUE) != ERR_OK ||
+		bignCtxVerify(ctx, oid_der, oid_len, hash, sig1, pubkey, 
+			ctx_stack) != ERR_OK)
+		return FALSE;
+	if (bignDH(id_sig, params, privkey, pubkey, 64) != ERR_OK ||
+		bignCtxDH(id_sig + 64, ctx, privkey, pubkey, 64, ctx_stack) != 
+			ERR_OK ||
+		!memEq(id_sig, id_sig + 64, 64) ||
+		bignSign2(id_sig, params, oid_der, oid_len, hash, privkey, 0, 0) !=
+			ERR_OK ||
+		bignCtxSign2(id_sig + 64, ctx, oid_der, oid_len, hash, privkey, 0, 0,
+			ctx_stack) != ERR_OK ||
+		!memEq(id_sig, id_sig + 64, 48))
+		return FALSE;
+	// тест Г.1 в пакетном режиме
+	brngCTRXStart(beltH() + 128, beltH() + 128 + 64,
+		beltH(), 8 * 32, brng_state1);
+	if (bignBatchGenKeypair(privkeys, pubkeys, 257, params, brngCTRXStepR,
+			brng_state1) != ERR_OK ||
+		!memEq(privkeys, privkey, 32) ||
+		!memEq(pubkeys, pubkey, 64) ||
+		bignValKeypair(params, privkeys + 255 * 32, pubkeys + 255 * 64) != 
+			ERR_OK ||
+		bignValKeypair(params, privkeys + 256 * 32, pubkeys + 256 * 64) != 
+			ERR_OK)
+		return FALSE;
+	// пакетный протокол Диффи -- Хеллмана
+	if (bignBatchDH(privkeys, params, privkey, pubkeys, 257, 32) != ERR_OK ||
+		bignDH(sig1, params, privkey, pubkeys, 32) != ERR_OK ||
+		!memEq(privkeys, sig1, 32) ||
+		bignDH(sig1, params, privkey, pubkeys + 255 * 64, 32) != ERR_OK ||
+		!memEq(privkeys + 255 * 32, sig1, 32) ||
+		bignDH(sig1, params, privkey, pubkeys + 256 * 64, 32) != ERR_OK ||
+		!memEq(privkeys + 256 * 32, sig1, 32))
+		return FALSE;
+	if (bignBatchDH(privkeys, params, privkey, pubkeys, 3, 64) != ERR_OK ||
+		bignDH(sig1, params, privkey, pubkeys + 2 * 64, 64) != ERR_OK ||
+		!memEq(privkeys + 2 * 64, sig1, 64))
+		return FALSE;
+	pubkeys[256 * 64] ^= 1;
+	if (bignBatchDH(privkeys, params, privkey, pubkeys, 257, 32) != 
+			ERR_BAD_PUBKEY)
+		return FALSE;
+	pubkeys[256 * 64] ^= 1;
 	// тест Г.8
 	memCopy(id_hash, hash, 32);
 	if (bignIdExtract(id_privkey, id_pubkey, params, oid_der, oid_len, 
@@ -5,7 +5,7 @@
 \project bee2/test
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.03.01
-\version 2016.07.15
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -32,6 +32,9 @@ COMBO-генератор
 -#	Выполняются тесты из приложения Б к ДСТУ 4145-2002.
 -#	Дополнительно проверяются кривые в полиномиальном базисе, заданные 
 	в приложении Г.
+-#	Дополнительно проверяется кривая Коблица K-163 (FIPS 186-4), на которой
+	кратные точки рассчитываются с помощью tau-NAF. Для нескольких личных 
+	ключей открытые ключи сравниваются с эталонными.
 
 \warning Ошибка в примере Б.1: x-координата открытого ключа должна 
 заканчиваться на ...BDC2DA (в примере BD2DA)
@@ -237,6 +240,74 @@ bool_t dstuTest()
 		dstuVerify(params, ld, hash, 32, sig, pubkey) != ERR_OK ||
 		(sig[0] ^= 1, dstuVerify(params, ld, hash, 32, sig, pubkey) == ERR_OK))
 		return FALSE;
+	// проверить кривую Коблица K-163
+	memSetZero(params, sizeof(dstu_params));
+	params->p[0] = 163, params->p[1] = 7, params->p[2] = 6, params->p[3] = 3;
+	params->A = 1;
+	params->B[0] = 1;
+	hexToRev(params->n, 
+		"04000000000000000000020108A2E0CC"
+		"0D99F8A5EF");
+	params->c = 2;
+	hexToRev(params->P, 
+		"02FE13C0537BBC11ACAA07D793DE4E6D"
+		"5E5C94EEE8");
+	hexToRev(params->P + O_OF_B(163), 
+		"0289070FB05D38FF58321F2E800536D5"
+		"38CCDAA3D9");
+	if (dstuValParams(params) != ERR_OK ||
+		dstuGenKeypair(privkey, pubkey, params, prngCOMBOStepR, 
+			state) != ERR_OK ||
+		dstuSign(sig, params, ld, hash, 32, privkey, prngCOMBOStepR, 
+			state) != ERR_OK ||
+		dstuVerify(params, ld, hash, 32, sig, pubkey) != ERR_OK ||
+		(sig[0] ^= 1, dstuVerify(params, ld, hash, 32, sig, pubkey) == ERR_OK))
+		return FALSE;
+	// K-163: открытые ключи для фиксированных личных ключей 1, 
+	// 03A4...1E0D и (n - 1) / 2 (рассчитаны независимо в аффинных 
+	// координатах)
+	hexToRev(buf, 
+		"00000000000000000000000000000000"
+		"0000000001");
+	prngEchoStart(state, buf, memNonZeroSize(params->n, O_OF_B(163)));
+	if (dstuGenKeypair(privkey, pubkey, params, prngEchoStepR, 
+			state) != ERR_OK ||
+		!hexEqRev(pubkey, 
+			"02FE13C0537BBC11ACAA07D793DE4E6D"
+			"5E5C94EEE8") ||
+		!hexEqRev(pubkey + O_OF_B(163), 
+			"007714CFE32684EEF49818F913DB78B8"
+			"66904E4D31"))
+		return FALSE;
+	hexToRev(buf, 
+		"03A41434AA99C2EF40C8495B2ED9739C"
+		"B2155A1E0D");
+	prngEchoStart(state, buf, memNonZeroSize(params->n, O_OF_B(163)));
+	if (dstuGenKeypair(privkey, pubkey, params, prngEchoStepR, 
+			state) != ERR_OK ||
+		!hexEqRev(privkey, 
+			"03A41434AA99C2EF40C8495B2ED9739C"
+			"B2155A1E0D") ||
+		!hexEqRev(pubkey, 
+			"037D529FA37E42195F10111127FFB2BB"
+			"38644806BC") ||
+		!hexEqRev(pubkey + O_OF_B(163), 
+			"073A50F14DF5760C202EA40AC2E7EF90"
+			"D840D6D1CA"))
+		return FALSE;
+	hexToRev(buf, 
+		"02000000000000000000010084517066"
+		"06CCFC52F7");
+	prngEchoStart(state, buf, memNonZeroSize(params->n, O_OF_B(163)));
+	if (dstuGenKeypair(privkey, pubkey, params, prngEchoStepR, 
+			state) != ERR_OK ||
+		!hexEqRev(pubkey, 
+			"000000000023E21D6019E1211F6BD47E"
+			"C180256E97") ||
+		!hexEqRev(pubkey + O_OF_B(163), 
+			"01055096AB2F2C1E9DA15BBAEDBBFAEA"
+			"60A07B80C9"))
+		return FALSE;
 	// все нормально
 	return TRUE;
 }
@@ -5,12 +5,13 @@
 \project bee2/test
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.07.08
-\version 2016.11.10
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
+#include <bee2/core/err.h>
 #include <bee2/core/mem.h>
 #include <bee2/core/hex.h>
 #include <bee2/core/prng.h>
@@ -58,6 +59,12 @@ bool_t pfokTestTestParams()
 		!memEq(params->p, params1->p, O_OF_B(params->l)) ||
 		params->l != params1->l || params->r != params1->r)
 		return FALSE;
+	// тест PFOK.GENP.1 в нескольких потоках
+	if (pfokGenParamsMT(params1, seed, _on_q_silent, 3) != ERR_OK ||
+		pfokValParamsMT(params1, 3) != ERR_OK ||
+		!memEq(params->p, params1->p, O_OF_B(params->l)) ||
+		params->l != params1->l || params->r != params1->r)
+		return FALSE;
 	// все нормально
 	return TRUE;
 }
@@ -99,6 +106,11 @@ bool_t pfokTest()
 	octet vb[O_OF_B(638)];
 	octet yb[O_OF_B(638)];
 	octet key[32];
+	octet key1[32];
+	octet prep[24 * 1024];
+	octet priv[O_OF_B(256)];
+	octet pub[O_OF_B(2462)];
+	octet pub1[O_OF_B(2462)];
 	// тест PFOK.GENP.1
 	if (!pfokTestTestParams())
 		return FALSE;
@@ -137,6 +149,18 @@ bool_t pfokTest()
 		pfokCalcPubkey(yb, params, ua) != ERR_OK ||
 		!memEq(vb, yb, O_OF_B(params->l)))
 		return FALSE;
+	// подготовленные параметры
+	ASSERT(pfokPrep_keep(params->l) <= sizeof(prep));
+	if (pfokPrepStart(prep, params) != ERR_OK ||
+		pfokGenKeypairPrep(ua, vb, prep, prngCOMBOStepR, combo_state) != 
+			ERR_OK ||
+		pfokCalcPubkey(yb, params, ua) != ERR_OK ||
+		!memEq(vb, yb, O_OF_B(params->l)) ||
+		pfokCalcPubkeyPrep(yb, prep, ua) != ERR_OK ||
+		!memEq(vb, yb, O_OF_B(params->l)) ||
+		(ua[O_OF_B(params->r) - 1] |= 0x80) == 0 ||
+		pfokCalcPubkeyPrep(yb, prep, ua) != ERR_BAD_PRIVKEY)
+		return FALSE;
 	// тест PFOK.ANON.1
 	hexToRev(ua, 
 		"01"
@@ -153,6 +177,9 @@ bool_t pfokTest()
 			"777BB35E950D3080C1E896BE4172DBD0" 
 			"61423D3BFEF78F15E3F7A7F2FF7A242B"))
 		return FALSE;
+	if (pfokDHPrep(key1, prep, ua, vb) != ERR_OK ||
+		!memEq(key, key1, 32))
+		return FALSE;
 	// тест PFOK.ANON.2
 	hexToRev(ua, 
 		"00"
@@ -195,6 +222,9 @@ bool_t pfokTest()
 			"EA92D5BCEC18BB44514E096748DB3E21"
 			"D6E7B9C97D604699BEA7D3B96C87E18B"))
 		return FALSE;
+	if (pfokMTIPrep(key1, prep, xa, ua, yb, vb) != ERR_OK ||
+		!memEq(key, key1, 32))
+		return FALSE;
 	// тест PFOK.AUTH.2
 	hexToRev(xa, 
 		"00"
@@ -221,6 +251,25 @@ bool_t pfokTest()
 			"5A4C323604206C8898BF6C234F75A537"
 			"DF75E9A249D87F1E55CBD7B40C4FDAFA"))
 		return FALSE;
+	// подготовленные стандартные параметры
+	if (pfokStdParams(params, 0, "1.2.112.0.2.0.1176.2.3.10.2") != ERR_OK)
+		return FALSE;
+	ASSERT(pfokPrep_keep(params->l) <= sizeof(prep));
+	ASSERT(O_OF_B(params->r) <= sizeof(priv));
+	if (pfokPrepStart(prep, params) != ERR_OK ||
+		pfokGenKeypairPrep(priv, pub, prep, prngCOMBOStepR, combo_state) !=
+			ERR_OK ||
+		pfokValPubkey(params, pub) != ERR_OK ||
+		pfokCalcPubkey(pub1, params, priv) != ERR_OK ||
+		!memEq(pub, pub1, O_OF_B(params->l)) ||
+		pfokDHPrep(key, prep, priv, pub) != ERR_OK ||
+		pfokDH(key1, params, priv, pub) != ERR_OK ||
+		!memEq(key, key1, O_OF_B(params->n)))
+		return FALSE;
+	// испорченный подготовленный объект
+	memSetZero(prep, sizeof(prep));
+	if (pfokCalcPubkeyPrep(pub, prep, priv) != ERR_BAD_INPUT)
+		return FALSE;
 	// все нормально
 	return TRUE;
 }
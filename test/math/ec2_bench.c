@@ -0,0 +1,122 @@
+/*
+*******************************************************************************
+\file ec2_bench.c
+\brief Benchmarks for elliptic curves over binary fields
+\project bee2/test
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.18
+\version 2026.10.18
+\license This program is released under the GNU General Public License 
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+#include <stdio.h>
+#include <bee2/core/mem.h>
+#include <bee2/core/prng.h>
+#include <bee2/core/tm.h>
+#include <bee2/core/util.h>
+#include <bee2/crypto/dstu.h>
+#include <bee2/math/ec2.h>
+#include <bee2/math/gf2.h>
+#include <bee2/math/ww.h>
+
+/*
+*******************************************************************************
+Сравнение координат Лопеса -- Дахаба и лямбда-координат
+
+Для кривой dstu_257pb (ДСТУ 4145-2002) оценивается число кратных точек
+в секунду в LD- и лямбда-координатах. Попутно проверяется совпадение
+кратных точек.
+*******************************************************************************
+*/
+
+bool_t ec2Bench()
+{
+	const char* name = "1.2.804.2.1.1.1.1.3.1.1.1.2.6";
+	const size_t m = 257;
+	const size_t n = W_OF_B(257);
+	dstu_params params[1];
+	// состояние
+	octet state[24000];
+	octet combo_state[256];
+	qr_o* f;
+	ec_o* ec[2];
+	word* pt[2];
+	word* d;
+	octet* A;
+	void* stack;
+	size_t p[4], i;
+	// загрузить параметры
+	if (dstuStdParams(params, name) != ERR_OK)
+		return FALSE;
+	// создать генератор COMBO
+	ASSERT(sizeof(combo_state) >= prngCOMBO_keep());
+	prngCOMBOStart(combo_state, utilNonce32());
+	// раскладка состояния
+	ASSERT(sizeof(state) >= gf2Create_keep(m) + ec2CreateLD_keep(n) +
+		ec2CreateLAM_keep(n) + O_OF_W(5 * n) + O_OF_B(m) +
+		utilMax(4,
+			gf2Create_deep(m),
+			ec2CreateLD_deep(n, gf2Create_deep(m)),
+			ec2CreateLAM_deep(n, gf2Create_deep(m)),
+			ecMulA_deep(n, 3,
+				utilMax(2,
+					ec2CreateLD_deep(n, gf2Create_deep(m)),
+					ec2CreateLAM_deep(n, gf2Create_deep(m))),
+				n)));
+	f = (qr_o*)state;
+	ec[0] = (ec_o*)((octet*)f + gf2Create_keep(m));
+	ec[1] = (ec_o*)((octet*)ec[0] + ec2CreateLD_keep(n));
+	pt[0] = (word*)((octet*)ec[1] + ec2CreateLAM_keep(n));
+	pt[1] = pt[0] + 2 * n;
+	d = pt[1] + 2 * n;
+	A = (octet*)(d + n);
+	stack = A + O_OF_B(m);
+	wwSetZero(d, n);
+	// создать поле и кривые
+	for (i = 0; i < 4; ++i)
+		p[i] = params->p[i];
+	memSetZero(A, O_OF_B(m));
+	A[0] = params->A;
+	if (!gf2Create(f, p, stack) ||
+		!ec2CreateLD(ec[0], f, A, params->B, stack) ||
+		!ec2CreateLAM(ec[1], f, A, params->B, stack))
+		return FALSE;
+	// сгенерировать базовую точку
+	if (dstuGenPoint(params->P, params, prngCOMBOStepR,
+			combo_state) != ERR_OK ||
+		!ecCreateGroup(ec[0], params->P, params->P + f->no, params->n,
+			f->no, params->c, stack) ||
+		!ecCreateGroup(ec[1], params->P, params->P + f->no, params->n,
+			f->no, params->c, stack))
+		return FALSE;
+	// кратные точки совпадают?
+	prngCOMBOStepR(d, O_OF_B(m) - 1, combo_state);
+	wwFrom(d, d, O_OF_B(m) - 1);
+	if (!ecMulA(pt[0], ec[0]->base, ec[0], d, n, stack) ||
+		!ecMulA(pt[1], ec[1]->base, ec[1], d, n, stack) ||
+		!wwEq(pt[0], pt[1], 2 * n))
+		return FALSE;
+	// оценить число кратных точек в секунду
+	for (i = 0; i < 2; ++i)
+	{
+		const size_t reps = 1000;
+		size_t j;
+		tm_ticks_t ticks;
+		// эксперимент
+		for (j = 0, ticks = tmTicks(); j < reps; ++j)
+		{
+			prngCOMBOStepR(d, O_OF_B(m) - 1, combo_state);
+			ecMulA(pt[i], ec[i]->base, ec[i], d, n, stack);
+		}
+		ticks = tmTicks() - ticks;
+		// печать результатов
+		printf("ec2Bench::%s: %u cycles/mulpoint [%u mulpoints/sec]\n",
+			i == 0 ? "LD" : "LAM",
+			(unsigned)(ticks / reps),
+			(unsigned)tmSpeed(reps, ticks));
+	}
+	// все нормально
+	return TRUE;
+}
@@ -5,7 +5,7 @@
 \project bee2/test
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2017.05.29
-\version 2017.08.23
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -53,7 +53,7 @@ bool_t ecpTest()
 	const size_t ec_deep = ecpCreateJ_deep(n, f_deep);
 	// состояние и стек
 	octet state[2048];
-	octet stack[2048];
+	octet stack[4096];
 	octet t[96];
 	// поле и эк
 	qr_o* f;
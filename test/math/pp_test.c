@@ -0,0 +1,164 @@
+/*
+*******************************************************************************
+\file pp_test.c
+\brief Tests for binary polynomials
+\project bee2/test
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.18
+\version 2026.10.18
+\license This program is released under the GNU General Public License
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+#include <bee2/core/prng.h>
+#include <bee2/core/util.h>
+#include <bee2/core/word.h>
+#include <bee2/math/pp.h>
+#include <bee2/math/ww.h>
+
+/*
+*******************************************************************************
+Эталонное умножение
+
+Произведение [n + m]c многочленов [n]a и [m]b рассчитывается побитово:
+для каждого ненулевого бита a с номером i к c прибавляется b X^i.
+*******************************************************************************
+*/
+
+static void ppMulRef(word c[], const word a[], size_t n, const word b[],
+	size_t m)
+{
+	size_t i, j, k;
+	wwSetZero(c, n + m);
+	for (i = 0; i < n; ++i)
+		for (j = 0; j < B_PER_W; ++j)
+			if (a[i] >> j & 1)
+				for (k = 0; k < m; ++k)
+				{
+					c[i + k] ^= b[k] << j;
+					if (j)
+						c[i + k + 1] ^= b[k] >> (B_PER_W - j);
+				}
+}
+
+/*
+*******************************************************************************
+Тестирование
+
+Функции ppMul(), ppSqr(), ppMulW(), ppAddMulW() сравниваются с эталонным
+умножением для многочленов длины 1,..., 9 (базовые функции умножения)
+и большей длины (алгоритм Карацубы). Сравнение выполняется дважды:
+с использованием команды pclmulqdq (если она поддерживается) и с табличными
+реализациями (после вызова ppUseClmul(FALSE)).
+*******************************************************************************
+*/
+
+static bool_t ppTestMul(octet combo_state[])
+{
+	const size_t ns[] = { 10, 16, 17, 20, 33 };
+	word a[33];
+	word b[33];
+	word c[66];
+	word c1[66];
+	word w, carry;
+	octet stack[2048];
+	size_t n, m, i;
+	// стек
+	ASSERT(sizeof(stack) >= utilMax(4,
+		ppMul_deep(33, 33),
+		ppSqr_deep(33),
+		ppMulW_deep(9),
+		ppAddMulW_deep(9)));
+	// базовые функции умножения
+	for (n = 1; n <= 9; ++n)
+		for (m = 1; m <= 9; ++m)
+		{
+			prngCOMBOStepR(a, O_OF_W(n), combo_state);
+			prngCOMBOStepR(b, O_OF_W(m), combo_state);
+			ppMul(c, a, n, b, m, stack);
+			ppMulRef(c1, a, n, b, m);
+			if (!wwEq(c, c1, n + m))
+				return FALSE;
+		}
+	// алгоритм Карацубы
+	for (i = 0; i < COUNT_OF(ns); ++i)
+	{
+		n = ns[i], m = n / 2 + 1;
+		prngCOMBOStepR(a, O_OF_W(n), combo_state);
+		prngCOMBOStepR(b, O_OF_W(n), combo_state);
+		ppMul(c, a, n, b, n, stack);
+		ppMulRef(c1, a, n, b, n);
+		if (!wwEq(c, c1, 2 * n))
+			return FALSE;
+		ppMul(c, a, n, b, m, stack);
+		ppMulRef(c1, a, n, b, m);
+		if (!wwEq(c, c1, n + m))
+			return FALSE;
+		ppMul(c, b, m, a, n, stack);
+		if (!wwEq(c, c1, n + m))
+			return FALSE;
+		ppSqr(c, a, n, stack);
+		ppMulRef(c1, a, n, a, n);
+		if (!wwEq(c, c1, 2 * n))
+			return FALSE;
+	}
+	// возведение в квадрат
+	for (n = 1; n <= 9; ++n)
+	{
+		prngCOMBOStepR(a, O_OF_W(n), combo_state);
+		ppSqr(c, a, n, stack);
+		ppMulRef(c1, a, n, a, n);
+		if (!wwEq(c, c1, 2 * n))
+			return FALSE;
+	}
+	// умножение на слово
+	for (n = 1; n <= 9; ++n)
+		for (i = 0; i < 3; ++i)
+		{
+			prngCOMBOStepR(a, O_OF_W(n), combo_state);
+			prngCOMBOStepR(b, O_OF_W(n), combo_state);
+			if (i == 0)
+				w = 0;
+			else if (i == 1)
+				w = WORD_MAX;
+			else
+				prngCOMBOStepR(&w, O_PER_W, combo_state);
+			ppMulRef(c1, a, n, &w, 1);
+			carry = ppMulW(c, a, n, w, stack);
+			if (!wwEq(c, c1, n) || carry != c1[n])
+				return FALSE;
+			wwCopy(c, b, n);
+			carry = ppAddMulW(c, a, n, w, stack);
+			wwXor2(c1, b, n);
+			if (!wwEq(c, c1, n) || carry != c1[n])
+				return FALSE;
+		}
+	// все нормально
+	return TRUE;
+}
+
+bool_t ppTest()
+{
+	octet combo_state[32];
+	bool_t clmul;
+	// подготовить генератор
+	ASSERT(sizeof(combo_state) >= prngCOMBO_keep());
+	prngCOMBOStart(combo_state, utilNonce32());
+	// ускоренные реализации (если поддерживаются)
+	clmul = ppUseClmul(TRUE);
+	if (!ppTestMul(combo_state))
+		return FALSE;
+	// табличные реализации
+	ppUseClmul(FALSE);
+	if (!ppTestMul(combo_state))
+	{
+		ppUseClmul(TRUE);
+		return FALSE;
+	}
+	// восстановить режим
+	if (ppUseClmul(TRUE) != clmul)
+		return FALSE;
+	// все нормально
+	return TRUE;
+}
@@ -5,7 +5,7 @@
 \project bee2/test
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.07.07
-\version 2016.07.15
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -31,7 +31,7 @@ bool_t priTest()
 	word p[W_OF_B(289)];
 	word mods[1024];
 	octet combo_state[32];
-	octet stack[4096];
+	octet stack[8192];
 	// инициализировать генератор COMBO
 	ASSERT(prngCOMBO_keep() <= sizeof(combo_state));
 	prngCOMBOStart(combo_state, utilNonce32());
@@ -58,6 +58,16 @@ bool_t priTest()
 	zzSubW2(a, W_OF_B(521), 1);
 	if (priRMTest(a, W_OF_B(521), 20, stack) != TRUE)
 		return FALSE;
+	// то же в нескольких потоках
+	ASSERT(priRMTestMT_deep(W_OF_B(521), 3) <= sizeof(stack));
+	if (priRMTestMT(a, W_OF_B(521), 20, 3, stack) != TRUE)
+		return FALSE;
+	// 2^521 - 3 -- составное (не проходит тест Ферма по основанию 2)
+	zzSubW2(a, W_OF_B(521), 2);
+	if (priRMTestMT(a, W_OF_B(521), 20, 3, stack) != FALSE ||
+		priRMTest(a, W_OF_B(521), 20, stack) != FALSE)
+		return FALSE;
+	zzAddW2(a, W_OF_B(521), 2);
 	// остатки по простым из факторной базы
 	i = MIN2(COUNT_OF(mods), priBaseSize());
 	priBaseMod(mods, a, W_OF_B(521), i);
@@ -81,8 +91,21 @@ bool_t priTest()
 	ASSERT(priNextPrimeW_deep() <= sizeof(stack));
 	if (!priNextPrimeW(a, ++a[0], stack) || a[0] != 523)
 		return FALSE;
-	// убедиться, что 2^256 - 400 не является гладким
+	// убедиться, что 2^7 * 3^5 * 5^2 * p_{max}^2 является гладким,
+	// а 2^7 * 3^5 * 5^2 * p_{max}^2 * 2^{32} + 1 -- нет
 	ASSERT(priIsSmooth_deep(W_OF_B(256)) <= sizeof(stack));
+	wwSetZero(a, W_OF_B(256));
+	a[0] = 128 * 243;
+	zzMulW(a, a, W_OF_B(256), 25);
+	zzMulW(a, a, W_OF_B(256), priBasePrime(priBaseSize() - 1));
+	zzMulW(a, a, W_OF_B(256), priBasePrime(priBaseSize() - 1));
+	if (!priIsSmooth(a, W_OF_B(256), priBaseSize(), stack))
+		return FALSE;
+	wwShHi(a, W_OF_B(256), 32);
+	zzAddW2(a, W_OF_B(256), 1);
+	if (priIsSmooth(a, W_OF_B(256), priBaseSize(), stack))
+		return FALSE;
+	// убедиться, что 2^256 - 400 не является гладким
 	memSet(a, 0xFF, O_OF_B(256));
 	zzSubW2(a, W_OF_B(256), 400);
 	if (priIsSmooth(a, W_OF_B(256), priBaseSize(), stack))
@@ -94,6 +117,15 @@ bool_t priTest()
 		a[0] != WORD_MAX - 356 ||
 		!wwIsRepW(a + 1, W_OF_B(256) - 1, WORD_MAX))
 		return FALSE;
+	// найти простое число 2^256 - 357 в нескольких потоках
+	ASSERT(priNextPrimeMT_deep(W_OF_B(256), 10, 3) <= sizeof(stack));
+	memSet(a, 0xFF, O_OF_B(256));
+	zzSubW2(a, W_OF_B(256), 400);
+	if (!priNextPrimeMT(a, a, W_OF_B(256), 50, 10, B_PER_IMPOSSIBLE, 3, 
+			stack) ||
+		a[0] != WORD_MAX - 356 ||
+		!wwIsRepW(a + 1, W_OF_B(256) - 1, WORD_MAX))
+		return FALSE;
 	// найти простое число 2^256 - 189
 	zzAddW2(a, W_OF_B(256), 1);
 	if (!priNextPrime(a, a, W_OF_B(256), 200, 10, B_PER_IMPOSSIBLE, stack) ||
@@ -107,6 +139,18 @@ bool_t priTest()
 	if (!priExtendPrime(p, 289, a, W_OF_B(256), SIZE_MAX, 0, prngCOMBOStepR, 
 		combo_state, stack) || !priIsPrime(p, W_OF_B(289), stack))
 		return FALSE;
+	// построить 289-битовое простое последовательно и в нескольких потоках
+	ASSERT(priExtendPrimeMT_deep(289, W_OF_B(256), 10, 3) <= sizeof(stack));
+	prngCOMBOStart(combo_state, 289);
+	if (!priExtendPrime(p, 289, a, W_OF_B(256), SIZE_MAX, 10, prngCOMBOStepR, 
+		combo_state, stack))
+		return FALSE;
+	wwCopy(mods, p, W_OF_B(289));
+	prngCOMBOStart(combo_state, 289);
+	if (!priExtendPrimeMT(p, 289, a, W_OF_B(256), SIZE_MAX, 10, 
+			prngCOMBOStepR, combo_state, 3, stack) ||
+		!wwEq(p, mods, W_OF_B(289)))
+		return FALSE;
 	// удостовериться, что в интервале (2^256 - 188, 2^256 - 1) нет простых
 	zzAddW2(a, W_OF_B(256), 1);
 	if (priNextPrime(a, a, W_OF_B(256), 200, 0, B_PER_IMPOSSIBLE, stack))
@@ -0,0 +1,80 @@
+/*
+*******************************************************************************
+\file zz_bench.c
+\brief Benchmarks for multiple-precision unsigned integers
+\project bee2/test
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.18
+\version 2026.10.18
+\license This program is released under the GNU General Public License 
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+#include <stdio.h>
+#include <bee2/core/prng.h>
+#include <bee2/core/tm.h>
+#include <bee2/core/util.h>
+#include <bee2/math/ww.h>
+#include <bee2/math/zz.h>
+
+/*
+*******************************************************************************
+Замер zzAdd(), zzSub(), zzMul(), zzSqr()
+
+Для длин n = 2, 3,..., 8 (развернутые варианты) и n = 12, 16 (общие 
+циклы) оценивается число тактов на одну операцию.
+*******************************************************************************
+*/
+
+bool_t zzBench()
+{
+	const size_t sizes[] = { 2, 3, 4, 5, 6, 7, 8, 12, 16 };
+	const size_t reps = 100000;
+	word a[16];
+	word b[16];
+	word c[32];
+	octet combo_state[32];
+	octet stack[2048];
+	size_t pos;
+	// pre
+	ASSERT(prngCOMBO_keep() <= sizeof(combo_state));
+	ASSERT(zzMul_deep(16, 16) <= sizeof(stack));
+	ASSERT(zzSqr_deep(16) <= sizeof(stack));
+	// подготовить данные
+	prngCOMBOStart(combo_state, utilNonce32());
+	prngCOMBOStepR(a, sizeof(a), combo_state);
+	prngCOMBOStepR(b, sizeof(b), combo_state);
+	// замеры
+	for (pos = 0; pos < COUNT_OF(sizes); ++pos)
+	{
+		const size_t n = sizes[pos];
+		tm_ticks_t add, sub, mul, sqr;
+		word carry = 0;
+		size_t i;
+		// zzAdd
+		for (i = 0, add = tmTicks(); i < reps; ++i)
+			carry += zzAdd(c, a, b, n), a[0] += c[n - 1];
+		add = tmTicks() - add;
+		// zzSub
+		for (i = 0, sub = tmTicks(); i < reps; ++i)
+			carry += zzSub(c, a, b, n), a[0] += c[n - 1];
+		sub = tmTicks() - sub;
+		// zzMul
+		for (i = 0, mul = tmTicks(); i < reps; ++i)
+			zzMul(c, a, n, b, n, stack), a[0] += c[n];
+		mul = tmTicks() - mul;
+		// zzSqr
+		for (i = 0, sqr = tmTicks(); i < reps; ++i)
+			zzSqr(c, a, n, stack), a[0] += c[n];
+		sqr = tmTicks() - sqr;
+		// печать результатов
+		printf("zzBench[n = %2u]: add %3u, sub %3u, mul %4u, sqr %4u "
+			"cycles/op\n", 
+			(unsigned)n, (unsigned)(add / reps), (unsigned)(sub / reps),
+			(unsigned)(mul / reps), (unsigned)(sqr / reps));
+		a[1] += carry;
+	}
+	// все нормально
+	return TRUE;
+}
@@ -5,7 +5,7 @@
 \project bee2/test
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.07.15
-\version 2016.09.12
+\version 2026.10.18
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -15,6 +15,8 @@ version 3. See Copyright Notices in bee2/info.h.
 #include <bee2/core/prng.h>
 #include <bee2/core/util.h>
 #include <bee2/core/word.h>
+#include <bee2/math/qr.h>
+#include <bee2/math/zm.h>
 #include <bee2/math/zz.h>
 #include <bee2/math/ww.h>
 
@@ -32,12 +34,16 @@ static bool_t zzTestAdd()
 	word b[8];
 	word c[8];
 	word c1[8];
+	word a2[10];
+	word b2[10];
+	word c2[10];
 	octet combo_state[32];
 	// pre
 	ASSERT(COUNT_OF(a) >= n);
 	ASSERT(COUNT_OF(b) >= n);
 	ASSERT(COUNT_OF(c) >= n);
 	ASSERT(COUNT_OF(c1) >= n);
+	ASSERT(COUNT_OF(a2) > n);
 	// инициализировать генератор COMBO
 	ASSERT(prngCOMBO_keep() <= sizeof(combo_state));
 	prngCOMBOStart(combo_state, utilNonce32());
@@ -45,6 +51,7 @@ static bool_t zzTestAdd()
 	for (reps = 0; reps < 500; ++reps)
 	{
 		word carry;
+		size_t na;
 		prngCOMBOStepR(a, O_OF_W(n), combo_state);
 		prngCOMBOStepR(b, O_OF_W(n), combo_state);
 		// zzAdd / zzSub / zzIsSumEq
@@ -80,6 +87,21 @@ static bool_t zzTestAdd()
 			!wwEq(c1, a, 1) ||
 			zzIsSumWEq(c, a, 1, b[0]) != wordEq(carry, 0))
 			return FALSE;
+		// zzAdd / zzSub [малые размерности / общий случай]
+		for (na = 1; na <= n; ++na)
+		{
+			wwCopy(a2, a, na), wwSetZero(a2 + na, COUNT_OF(a2) - na);
+			wwCopy(b2, b, na), wwSetZero(b2 + na, COUNT_OF(b2) - na);
+			carry = zzAdd(c, a, b, na);
+			if (zzAdd(c2, a2, b2, COUNT_OF(a2)) != 0 ||
+				!wwEq(c, c2, na) || c2[na] != carry)
+				return FALSE;
+			carry = zzSub(c, a, b, na);
+			if (zzSub(c2, a2, b2, COUNT_OF(a2)) != carry ||
+				!wwEq(c, c2, na) || 
+				!wwIsRepW(c2 + na, COUNT_OF(c2) - na, WORD_0 - carry))
+				return FALSE;
+		}
 	}
 	// все нормально
 	return TRUE;
@@ -96,6 +118,10 @@ static bool_t zzTestMul()
 	word c1[16];
 	word b1[8 + 1];
 	word r1[8];
+	word a2[100];
+	word b2[100];
+	word c2[200];
+	word c3[201];
 	octet combo_state[32];
 	octet stack[2048];
 	// pre
@@ -108,11 +134,38 @@ static bool_t zzTestMul()
 	ASSERT(COUNT_OF(r1) >= n);
 	ASSERT(zzMul_deep(n, n) <= sizeof(stack));
 	ASSERT(zzSqr_deep(n) <= sizeof(stack));
+	ASSERT(zzMul_deep(COUNT_OF(a2), COUNT_OF(a2)) <= sizeof(stack));
+	ASSERT(zzSqr_deep(COUNT_OF(a2)) <= sizeof(stack));
 	ASSERT(zzDiv_deep(2 * n, n) <= sizeof(stack));
 	ASSERT(zzMod_deep(2 * n, n) <= sizeof(stack));
 	// инициализировать генератор COMBO
 	ASSERT(prngCOMBO_keep() <= sizeof(combo_state));
 	prngCOMBOStart(combo_state, utilNonce32());
+	// большие размерности (умножение Карацубы)
+	for (reps = 0; reps < 20; ++reps)
+	{
+		size_t na;
+		prngCOMBOStepR(a2, O_OF_W(COUNT_OF(a2)), combo_state);
+		prngCOMBOStepR(b2, O_OF_W(COUNT_OF(b2)), combo_state);
+		for (na = 40; na < COUNT_OF(a2); na += 3)
+		{
+			word t;
+			// zzMul(na, na) / zzMul(na, na + 1)
+			t = b2[na], b2[na] = 0;
+			zzMul(c2, a2, na, b2, na, stack);
+			zzMul(c3, a2, na, b2, na + 1, stack);
+			if (!wwEq(c2, c3, 2 * na) || c3[2 * na] != 0)
+				return FALSE;
+			b2[na] = t;
+			// zzSqr / zzMul(na, na + 1)
+			t = a2[na], a2[na] = 0;
+			zzSqr(c2, a2, na, stack);
+			zzMul(c3, a2, na, a2, na + 1, stack);
+			if (!wwEq(c2, c3, 2 * na) || c3[2 * na] != 0)
+				return FALSE;
+			a2[na] = t;
+		}
+	}
 	// умножение / деление
 	for (reps = 0; reps < 500; ++reps)
 	{
@@ -319,6 +372,33 @@ static bool_t zzTestMod()
 			return FALSE;
 
 	}
+	// zzInvMod [разные длины, необратимые элементы]
+	for (reps = 0; reps < 200; ++reps)
+	{
+		size_t na = reps % n + 1;
+		prngCOMBOStepR(mod, O_OF_W(na), combo_state);
+		prngCOMBOStepR(a, O_OF_W(na), combo_state);
+		mod[0] |= 1;
+		if (mod[na - 1] == 0)
+			mod[na - 1] = WORD_MAX;
+		zzMod(a, a, na, mod, na, stack);
+		if (reps % 7 == 0)
+			wwSetZero(a, na);
+		zzInvMod(t, a, mod, na, stack);
+		if (wwIsZero(a, na))
+			wwSetZero(t1, na);
+		else
+			zzGCD(t1, a, na, mod, na, stack);
+		if (wwCmpW(t1, na, 1) != 0)
+		{
+			if (!wwIsZero(t, na))
+				return FALSE;
+			continue;
+		}
+		zzMulMod(t1, t, a, mod, na, stack);
+		if (wwCmpW(t1, na, 1) != 0)
+			return FALSE;
+	}
 	// все нормально
 	return TRUE;
 }
@@ -482,12 +562,266 @@ static bool_t zzTestRed()
 	return TRUE;
 }
 
+static bool_t zzTestZmCrand()
+{
+	const size_t nos[3] = { 32, 48, 64 };
+	size_t i, reps;
+	word a[8];
+	word b[8];
+	word c[8];
+	word t[16];
+	octet mod[64];
+	octet r_state[1024];
+	octet combo_state[32];
+	octet stack[4096];
+	qr_o* r;
+	// инициализировать генератор COMBO
+	ASSERT(prngCOMBO_keep() <= sizeof(combo_state));
+	prngCOMBOStart(combo_state, utilNonce32());
+	// модули B^n - c: c -- малые и случайные
+	for (i = 0; i < 3 * COUNT_OF(nos); ++i)
+	{
+		const size_t no = nos[i % COUNT_OF(nos)];
+		const size_t n = W_OF_O(no);
+		ASSERT(COUNT_OF(a) >= n && COUNT_OF(t) >= 2 * n);
+		ASSERT(zmCreateCrand_keep(no) <= sizeof(r_state));
+		ASSERT(zmCreateCrand_deep(no) <= sizeof(stack));
+		ASSERT(zzMod_deep(2 * n, n) <= sizeof(stack));
+		ASSERT(qrPower_deep(n, n, zmCreateCrand_deep(no)) <= sizeof(stack));
+		ASSERT(zmPowerSqrt_deep(n, zmCreateCrand_deep(no)) <= sizeof(stack));
+		// модуль
+		if (i < COUNT_OF(nos))
+			c[0] = 189;
+		else if (i < 2 * COUNT_OF(nos))
+			c[0] = 1;
+		else
+			prngCOMBOStepR(c, O_PER_W, combo_state), c[0] |= 1;
+		c[0] = WORD_0 - c[0];
+		wwRepW(c + 1, n - 1, WORD_MAX);
+		wwTo(mod, no, c);
+		// кольцо
+		r = (qr_o*)r_state;
+		zmCreateCrand(r, mod, no, stack);
+		// крайние значения
+		zzSubW(a, r->mod, n, 1);
+		qrMul(c, a, a, r, stack);
+		if (!wwEq(c, r->unity, n))
+			return FALSE;
+		qrSqr(c, a, r, stack);
+		if (!wwEq(c, r->unity, n))
+			return FALSE;
+		// случайные значения
+		for (reps = 0; reps < 200; ++reps)
+		{
+			prngCOMBOStepR(a, no, combo_state);
+			prngCOMBOStepR(b, no, combo_state);
+			zzMod(a, a, n, r->mod, n, stack);
+			zzMod(b, b, n, r->mod, n, stack);
+			// qrMul / zzMul + zzMod
+			zzMul(t, a, n, b, n, stack);
+			zzMod(t, t, 2 * n, r->mod, n, stack);
+			qrMul(c, a, b, r, stack);
+			if (!wwEq(c, t, n))
+				return FALSE;
+			// qrSqr / zzSqr + zzMod
+			zzSqr(t, a, n, stack);
+			zzMod(t, t, 2 * n, r->mod, n, stack);
+			qrSqr(c, a, r, stack);
+			if (!wwEq(c, t, n))
+				return FALSE;
+			// qrMul: c == a
+			wwCopy(c, a, n);
+			qrMul(c, c, b, r, stack);
+			zzMul(t, a, n, b, n, stack);
+			zzMod(t, t, 2 * n, r->mod, n, stack);
+			if (!wwEq(c, t, n))
+				return FALSE;
+			if (reps % 20)
+				continue;
+			// qrPowerChain / qrPower: a^{2^l - c} = a^mod
+			qrPowerChain(c, a, B_OF_W(n), WORD_0 - r->mod[0], r, stack);
+			qrPower(t, a, r->mod, n, r, stack);
+			if (!wwEq(c, t, n))
+				return FALSE;
+			// zmPowerSqrt / qrPower
+			if (wwGetBits(r->mod, 0, 2) != 3)
+				continue;
+			zmPowerSqrt(c, a, r, stack);
+			wwCopy(b, r->mod, n);
+			wwShLo(b, n, 2);
+			qrPower(t, a, b, n, r, stack);
+			if (!wwEq(c, t, n))
+				return FALSE;
+		}
+	}
+	// все нормально
+	return TRUE;
+}
+
+static bool_t zzTestZmMont()
+{
+	const size_t no = 64;
+	const size_t n = W_OF_O(no);
+	size_t i, reps;
+	word a[8];
+	word b[8];
+	word c[8];
+	word d[8];
+	word e[8];
+	word t[16];
+	word comb[8 * 31];
+	octet mod[64];
+	octet r_state[1024];
+	octet r2_state[1024];
+	octet combo_state[32];
+	octet stack[4096];
+	qr_o* r;
+	qr_o* r2;
+	// pre
+	ASSERT(COUNT_OF(a) >= n && COUNT_OF(t) >= 2 * n);
+	ASSERT(zmCreateMont_keep(no) <= sizeof(r_state));
+	ASSERT(zmMontCreate_keep(no) <= sizeof(r2_state));
+	ASSERT(zmMontCreate_deep(no) <= sizeof(stack));
+	ASSERT(zmCreateMont_deep(no) <= sizeof(stack));
+	ASSERT(zzRedMont_deep(n) <= sizeof(stack));
+	ASSERT(qrPowerComb_keep(n, 5) <= sizeof(comb));
+	ASSERT(qrPowerCombStart_deep(n, zmCreateMont_deep(no)) <= sizeof(stack));
+	ASSERT(qrPowerComb_deep(n, zmCreateMont_deep(no)) <= sizeof(stack));
+	ASSERT(qrPower_deep(n, n, zmCreateMont_deep(no)) <= sizeof(stack));
+	ASSERT(zmPowerMod_deep(n, n, zmCreateMont_deep(no)) <= sizeof(stack));
+	ASSERT(zzPowerMod_deep(n, n) <= sizeof(stack));
+	ASSERT(qrPower2_deep(n, n, n, zmCreateMont_deep(no)) <= sizeof(stack));
+	// инициализировать генератор COMBO
+	ASSERT(prngCOMBO_keep() <= sizeof(combo_state));
+	prngCOMBOStart(combo_state, utilNonce32());
+	// модули: 2^511 + 111 и случайные
+	for (i = 0; i < 4; ++i)
+	{
+		// модуль
+		if (i == 0)
+		{
+			memSetZero(mod, no);
+			mod[0] = 111, mod[no - 1] = 0x80;
+		}
+		else
+			prngCOMBOStepR(mod, no, combo_state);
+		mod[0] |= 1, mod[no - 1] |= 0x80;
+		// кольцо
+		r = (qr_o*)r_state;
+		zmCreateMont(r, mod, no, stack);
+		// крайние значения
+		zzSubW(a, r->mod, n, 1);
+		qrMul(c, a, a, r, stack);
+		zzSqr(t, a, n, stack);
+		zzRedMont(t, r->mod, n, *(word*)r->params, stack);
+		if (!wwEq(c, t, n))
+			return FALSE;
+		// случайные значения
+		for (reps = 0; reps < 200; ++reps)
+		{
+			prngCOMBOStepR(a, no, combo_state);
+			prngCOMBOStepR(b, no, combo_state);
+			zzMod(a, a, n, r->mod, n, stack);
+			zzMod(b, b, n, r->mod, n, stack);
+			// qrMul / zzMul + zzRedMont
+			zzMul(t, a, n, b, n, stack);
+			zzRedMont(t, r->mod, n, *(word*)r->params, stack);
+			qrMul(c, a, b, r, stack);
+			if (!wwEq(c, t, n))
+				return FALSE;
+			// qrSqr / zzSqr + zzRedMont
+			zzSqr(t, a, n, stack);
+			zzRedMont(t, r->mod, n, *(word*)r->params, stack);
+			qrSqr(c, a, r, stack);
+			if (!wwEq(c, t, n))
+				return FALSE;
+		}
+		// кольцо zmMontCreate(l = B_OF_W(n)): разные редакции
+		r2 = (qr_o*)r2_state;
+		zmMontCreate(r2, mod, no, B_OF_W(n), stack);
+		for (reps = 0; reps < 20; ++reps)
+		{
+			prngCOMBOStepR(a, no, combo_state);
+			prngCOMBOStepR(b, no, combo_state);
+			zzMod(a, a, n, r->mod, n, stack);
+			zzMod(b, b, n, r->mod, n, stack);
+			zmSetSafe(r2, reps % 2 ? TRUE : FALSE);
+			if (zmIsSafe(r2) != (reps % 2 ? TRUE : FALSE))
+				return FALSE;
+			// qrMul / qrSqr: r2 == r
+			qrMul(c, a, b, r2, stack);
+			qrMul(t, a, b, r, stack);
+			if (!wwEq(c, t, n))
+				return FALSE;
+			qrSqr(c, a, r2, stack);
+			qrSqr(t, a, r, stack);
+			if (!wwEq(c, t, n))
+				return FALSE;
+			// zmAdd / zmSub / zmNeg
+			zmAdd(c, a, b, r2);
+			zmSub(c, c, b, r2);
+			if (!wwEq(c, a, n))
+				return FALSE;
+			zmNeg(c, a, r2);
+			zmAdd(c, c, a, r2);
+			if (!wwIsZero(c, n))
+				return FALSE;
+		}
+		// qrPowerComb / qrPower: h = i + 2, l = B_OF_W(n) - 13 i
+		prngCOMBOStepR(a, no, combo_state);
+		zzMod(a, a, n, r->mod, n, stack);
+		qrPowerCombStart(comb, a, B_OF_W(n) - 13 * i, i + 2, r, stack);
+		for (reps = 0; reps < 20; ++reps)
+		{
+			prngCOMBOStepR(b, no, combo_state);
+			wwTrimHi(b, n, B_OF_W(n) - 13 * i - reps % 3);
+			qrPowerComb(c, comb, b, n, B_OF_W(n) - 13 * i, i + 2, r, stack);
+			qrPower(t, a, b, n, r, stack);
+			if (!wwEq(c, t, n))
+				return FALSE;
+		}
+		wwSetZero(b, n);
+		qrPowerComb(c, comb, b, n, B_OF_W(n) - 13 * i, i + 2, r, stack);
+		if (!qrIsUnity(c, r))
+			return FALSE;
+		// qrPower2 / qrPower: показатели разной длины и нулевые
+		for (reps = 0; reps < 10; ++reps)
+		{
+			prngCOMBOStepR(a, no, combo_state);
+			prngCOMBOStepR(b, no, combo_state);
+			zzMod(a, a, n, r->mod, n, stack);
+			wwTrimHi(b, n, 37 * reps);
+			prngCOMBOStepR(d, no, combo_state);
+			prngCOMBOStepR(e, no, combo_state);
+			zzMod(d, d, n, r->mod, n, stack);
+			wwTrimHi(e, n, B_OF_W(n) - 41 * reps);
+			qrPower2(c, a, b, n, d, e, n, r, stack);
+			qrPower(t, a, b, n, r, stack);
+			qrPower(t + n, d, e, n, r, stack);
+			qrMul(t, t, t + n, r, stack);
+			if (!wwEq(c, t, n))
+				return FALSE;
+		}
+		// zmPowerMod / zzPowerMod
+		prngCOMBOStepR(a, no, combo_state);
+		prngCOMBOStepR(b, no, combo_state);
+		zzMod(a, a, n, r->mod, n, stack);
+		zmPowerMod(c, a, b, n, r, stack);
+		zzPowerMod(t, a, n, b, n, r->mod, stack);
+		if (!wwEq(c, t, n))
+			return FALSE;
+	}
+	// все нормально
+	return TRUE;
+}
+
 bool_t zzTest()
 {
 	return zzTestAdd() && 
 		zzTestMul() && 
 		zzTestMod() && 
 		zzTestGCD() && 
-		zzTestRed();
+		zzTestRed() &&
+		zzTestZmCrand() &&
+		zzTestZmMont();
 }
-
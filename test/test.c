@@ -5,7 +5,7 @@
 \project bee2/test
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.04.02
-\version 2017.07.11
+\version 2026.10.18
 \license This program is released under the GNU General Public License
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -62,21 +62,27 @@ int testCore()
 *******************************************************************************
 */
 
+extern bool_t ppTest();
 extern bool_t priTest();
 extern bool_t zzTest();
+extern bool_t zzBench();
 extern bool_t wordTest();
 extern bool_t ecpTest();
 extern bool_t ecpBench();
+extern bool_t ec2Bench();
 
 int testMath()
 {
 	bool_t code;
 	int ret = 0;
+	printf("ppTest: %s\n", (code = ppTest()) ? "OK" : "Err"), ret |= !code;
 	printf("priTest: %s\n", (code = priTest()) ? "OK" : "Err"), ret |= !code;
 	printf("zzTest: %s\n", (code = zzTest()) ? "OK" : "Err"), ret |= !code;
+	code = zzBench(), ret |= !code;
 	printf("wordTest: %s\n", (code = wordTest()) ? "OK" : "Err"), ret |= !code;
 	printf("ecpTest: %s\n", (code = ecpTest()) ? "OK" : "Err"), ret |= !code;
 	code = ecpBench(), ret |= !code;
+	code = ec2Bench(), ret |= !code;
 	return ret;
 }
 
@@ -91,6 +97,7 @@ extern bool_t beltBench();
 extern bool_t bignTest();
 extern bool_t brngTest();
 extern bool_t belsTest();
+extern bool_t belsBench();
 extern bool_t bakeTest();
 extern bool_t dstuTest();
 extern bool_t g12sTest();
@@ -113,6 +120,7 @@ int testCrypto()
 	printf("bignTest: %s\n", (code = bignTest()) ? "OK" : "Err"), ret |= !code;
 	printf("brngTest: %s\n", (code = brngTest()) ? "OK" : "Err"), ret |= !code;
 	printf("belsTest: %s\n", (code = belsTest()) ? "OK" : "Err"), ret |= !code;
+	code = belsBench(),	ret |= !code;
 	printf("bakeTest: %s\n", (code = bakeTest()) ? "OK" : "Err"), ret |= !code;
 	printf("dstuTest: %s\n", (code = dstuTest()) ? "OK" : "Err"), ret |= !code;
 	printf("g12sTest: %s\n", (code = g12sTest()) ? "OK" : "Err"), ret |= !code;